@@ -61,6 +61,16 @@ struct CV_EXPORTS_W Params
     /** @brief Size of voxel in meters */
     CV_PROP_RW float voxelSize;
 
+    /** @brief Keep voxels in blocks allocated on demand
+
+    Only the blocks close to observed surfaces are allocated, so the memory use
+    depends on the surface area instead of volumeDims, which allows room-sized volumes.
+    Such a volume is processed on CPU only.
+    */
+    CV_PROP_RW bool hashedVolume;
+    /** @brief Number of voxels in each dimension of a block of hashed volume */
+    CV_PROP_RW int volumeBlockSize;
+
     /** @brief Minimal camera movement in meters
 
     Integrate new depth frame only if camera movement exceeds this value.
@@ -118,6 +128,7 @@ struct CV_EXPORTS_W Params
 
   An internal representation of a model is a voxel cuboid that keeps TSDF values
   which are a sort of distances to the surface (for details read the @cite kinectfusion article about TSDF).
+  The cuboid is either dense or allocated by blocks around the surface, see Params::hashedVolume.
   There is no interface to that representation yet.
 
   KinFu uses OpenCL acceleration automatically if available.
@@ -48,6 +48,9 @@ Ptr<Params> Params::defaultParams()
     float volSize = 3.f;
     p.voxelSize = volSize/512.f; //meters
 
+    p.hashedVolume = false;
+    p.volumeBlockSize = 8; //voxels
+
     // default pose of volume cube
     p.volumePose = Affine3f().translate(Vec3f(-volSize/2.f, -volSize/2.f, 0.5f));
     p.tsdf_trunc_dist = 0.04f; //meters;
@@ -125,7 +128,8 @@ KinFuImpl<T>::KinFuImpl(const Params &_params) :
     icp(makeICP(params.intr, params.icpIterations, params.icpAngleThresh, params.icpDistThresh)),
     volume(makeTSDFVolume(params.volumeDims, params.voxelSize, params.volumePose,
                           params.tsdf_trunc_dist, params.tsdf_max_weight,
-                          params.raycast_step_factor)),
+                          params.raycast_step_factor,
+                          params.hashedVolume, params.volumeBlockSize)),
     pyrPoints(), pyrNormals()
 {
     reset();
@@ -299,7 +303,8 @@ void KinFuImpl<T>::getNormals(InputArray points, OutputArray normals) const
 Ptr<KinFu> KinFu::create(const Ptr<Params>& params)
 {
 #ifdef HAVE_OPENCL
-    if(cv::ocl::useOpenCL())
+    // hashed volume works on CPU only
+    if(cv::ocl::useOpenCL() && !params->hashedVolume)
         return makePtr< KinFuImpl<UMat> >(*params);
 #endif
     return makePtr< KinFuImpl<Mat> >(*params);
@@ -917,51 +917,13 @@ static void orUnaligned8u(const uchar * src, const int src_stride,
                    uchar * dst, const int dst_stride,
                    const int width, const int height)
 {
-#if CV_SSE2
-  volatile bool haveSSE2 = checkHardwareSupport(CPU_SSE2);
-#if CV_SSE3
-  volatile bool haveSSE3 = checkHardwareSupport(CPU_SSE3);
-#endif
-  bool src_aligned = reinterpret_cast<unsigned long long>(src) % 16 == 0;
-#endif
-
   for (int r = 0; r < height; ++r)
   {
     int c = 0;
 
-#if CV_SSE2
-    // Use aligned loads if possible
-    if (haveSSE2 && src_aligned)
-    {
-      for ( ; c < width - 15; c += 16)
-      {
-        const __m128i* src_ptr = reinterpret_cast<const __m128i*>(src + c);
-        __m128i* dst_ptr = reinterpret_cast<__m128i*>(dst + c);
-        *dst_ptr = _mm_or_si128(*dst_ptr, *src_ptr);
-      }
-    }
-#if CV_SSE3
-    // Use LDDQU for fast unaligned load
-    else if (haveSSE3)
-    {
-      for ( ; c < width - 15; c += 16)
-      {
-        __m128i val = _mm_lddqu_si128(reinterpret_cast<const __m128i*>(src + c));
-        __m128i* dst_ptr = reinterpret_cast<__m128i*>(dst + c);
-        *dst_ptr = _mm_or_si128(*dst_ptr, val);
-      }
-    }
-#endif
-    // Fall back to MOVDQU
-    else if (haveSSE2)
-    {
-      for ( ; c < width - 15; c += 16)
-      {
-        __m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + c));
-        __m128i* dst_ptr = reinterpret_cast<__m128i*>(dst + c);
-        *dst_ptr = _mm_or_si128(*dst_ptr, val);
-      }
-    }
+#if CV_SIMD
+    for ( ; c <= width - v_uint8::nlanes; c += v_uint8::nlanes)
+      v_store(dst + c, vx_load(dst + c) | vx_load(src + c));
 #endif
     for ( ; c < width; ++c)
       dst[c] |= src[c];
@@ -1165,8 +1127,8 @@ static void similarity(const std::vector<Mat>& linear_memories, const Template&
 {
   // 63 features or less is a special case because the max similarity per-feature is 4.
   // 255/4 = 63, so up to that many we can add up similarities in 8 bits without worrying
-  // about overflow. Therefore here we use _mm_add_epi8 as the workhorse, whereas a more
-  // general function would use _mm_add_epi16.
+  // about overflow. Therefore here we use 8-bit vector adds as the workhorse, whereas a more
+  // general function would use 16-bit ones.
   CV_Assert(templ.features.size() <= 63);
   /// @todo Handle more than 255/MAX_RESPONSE features!!
 
@@ -1190,16 +1152,11 @@ static void similarity(const std::vector<Mat>& linear_memories, const Template&
 
   /// @todo In old code, dst is buffer of size m_U. Could make it something like
   /// (span_x)x(span_y) instead?
-  dst = Mat::zeros(H, W, CV_8U);
+  // dst is reused between templates, so it's only reallocated when the size changes
+  dst.create(H, W, CV_8U);
+  dst.setTo(Scalar::all(0));
   uchar* dst_ptr = dst.ptr<uchar>();
 
-#if CV_SSE2
-  volatile bool haveSSE2 = checkHardwareSupport(CV_CPU_SSE2);
-#if CV_SSE3
-  volatile bool haveSSE3 = checkHardwareSupport(CV_CPU_SSE3);
-#endif
-#endif
-
   // Compute the similarity measure for this template by accumulating the contribution of
   // each feature
   for (int i = 0; i < (int)templ.features.size(); ++i)
@@ -1213,33 +1170,12 @@ static void similarity(const std::vector<Mat>& linear_memories, const Template&
       continue;
     const uchar* lm_ptr = accessLinearMemory(linear_memories, f, T, W);
 
-    // Now we do an aligned/unaligned add of dst_ptr and lm_ptr with template_positions elements
+    // Now we do an unaligned add of dst_ptr and lm_ptr with template_positions elements
     int j = 0;
-    // Process responses 16 at a time if vectorization possible
-#if CV_SSE2
-#if CV_SSE3
-    if (haveSSE3)
-    {
-      // LDDQU may be more efficient than MOVDQU for unaligned load of next 16 responses
-      for ( ; j < template_positions - 15; j += 16)
-      {
-        __m128i responses = _mm_lddqu_si128(reinterpret_cast<const __m128i*>(lm_ptr + j));
-        __m128i* dst_ptr_sse = reinterpret_cast<__m128i*>(dst_ptr + j);
-        *dst_ptr_sse = _mm_add_epi8(*dst_ptr_sse, responses);
-      }
-    }
-    else
-#endif
-    if (haveSSE2)
-    {
-      // Fall back to MOVDQU
-      for ( ; j < template_positions - 15; j += 16)
-      {
-        __m128i responses = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lm_ptr + j));
-        __m128i* dst_ptr_sse = reinterpret_cast<__m128i*>(dst_ptr + j);
-        *dst_ptr_sse = _mm_add_epi8(*dst_ptr_sse, responses);
-      }
-    }
+    // Process as many responses at a time as the widest vector holds
+#if CV_SIMD
+    for ( ; j <= template_positions - v_uint8::nlanes; j += v_uint8::nlanes)
+      v_store(dst_ptr + j, vx_load(dst_ptr + j) + vx_load(lm_ptr + j));
 #endif
     for ( ; j < template_positions; ++j)
       dst_ptr[j] = uchar(dst_ptr[j] + lm_ptr[j]);
@@ -1265,7 +1201,8 @@ static void similarityLocal(const std::vector<Mat>& linear_memories, const Templ
 
   // Compute the similarity map in a 16x16 patch around center
   int W = size.width / T;
-  dst = Mat::zeros(16, 16, CV_8U);
+  dst.create(16, 16, CV_8U);
+  dst.setTo(Scalar::all(0));
 
   // Offset each feature point by the requested center. Further adjust to (-8,-8) from the
   // center to get the top-left corner of the 16x16 patch.
@@ -1273,13 +1210,7 @@ static void similarityLocal(const std::vector<Mat>& linear_memories, const Templ
   int offset_x = (center.x / T - 8) * T;
   int offset_y = (center.y / T - 8) * T;
 
-#if CV_SSE2
-  volatile bool haveSSE2 = checkHardwareSupport(CV_CPU_SSE2);
-#if CV_SSE3
-  volatile bool haveSSE3 = checkHardwareSupport(CV_CPU_SSE3);
-#endif
-  __m128i* dst_ptr_sse = dst.ptr<__m128i>();
-#endif
+  uchar* dst_data = dst.ptr<uchar>();
 
   for (int i = 0; i < (int)templ.features.size(); ++i)
   {
@@ -1293,57 +1224,41 @@ static void similarityLocal(const std::vector<Mat>& linear_memories, const Templ
     const uchar* lm_ptr = accessLinearMemory(linear_memories, f, T, W);
 
     // Process whole row at a time if vectorization possible
-#if CV_SSE2
-#if CV_SSE3
-    if (haveSSE3)
+#if CV_SIMD128
+    for (int row = 0; row < 16; ++row)
     {
-      // LDDQU may be more efficient than MOVDQU for unaligned load of 16 responses from current row
-      for (int row = 0; row < 16; ++row)
-      {
-        __m128i aligned = _mm_lddqu_si128(reinterpret_cast<const __m128i*>(lm_ptr));
-        dst_ptr_sse[row] = _mm_add_epi8(dst_ptr_sse[row], aligned);
-        lm_ptr += W; // Step to next row
-      }
+      v_store(dst_data + 16*row, v_load(dst_data + 16*row) + v_load(lm_ptr));
+      lm_ptr += W; // Step to next row
     }
-    else
-#endif
-    if (haveSSE2)
+#else
+    uchar* dst_ptr = dst_data;
+    for (int row = 0; row < 16; ++row)
     {
-      // Fall back to MOVDQU
-      for (int row = 0; row < 16; ++row)
-      {
-        __m128i aligned = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lm_ptr));
-        dst_ptr_sse[row] = _mm_add_epi8(dst_ptr_sse[row], aligned);
-        lm_ptr += W; // Step to next row
-      }
+      for (int col = 0; col < 16; ++col)
+        dst_ptr[col] = uchar(dst_ptr[col] + lm_ptr[col]);
+      dst_ptr += 16;
+      lm_ptr += W;
     }
-    else
 #endif
-    {
-      uchar* dst_ptr = dst.ptr<uchar>();
-      for (int row = 0; row < 16; ++row)
-      {
-        for (int col = 0; col < 16; ++col)
-          dst_ptr[col] = uchar(dst_ptr[col] + lm_ptr[col]);
-        dst_ptr += 16;
-        lm_ptr += W;
-      }
-    }
   }
 }
 
 static void addUnaligned8u16u(const uchar * src1, const uchar * src2, ushort * res, int length)
 {
-  const uchar * end = src1 + length;
+  int i = 0;
 
-  while (src1 != end)
+#if CV_SIMD
+  for ( ; i <= length - v_uint8::nlanes; i += v_uint8::nlanes)
   {
-    *res = *src1 + *src2;
-
-    ++src1;
-    ++src2;
-    ++res;
+    v_uint16 a0, a1, b0, b1;
+    v_expand(vx_load(src1 + i), a0, a1);
+    v_expand(vx_load(src2 + i), b0, b1);
+    v_store(res + i, a0 + b0);
+    v_store(res + i + v_uint16::nlanes, a1 + b1);
   }
+#endif
+  for ( ; i < length; ++i)
+    res[i] = static_cast<ushort>(src1[i] + src2[i]);
 }
 
 /**
@@ -1370,6 +1285,26 @@ static void addSimilarities(const std::vector<Mat>& similarities, Mat& dst)
   }
 }
 
+// A template pyramid to match, see Detector::matchClass()
+struct TemplateMatchTask
+{
+  TemplateMatchTask(const String* _class_id, const std::vector<Template>* _tp, int _template_id)
+    : class_id(_class_id), tp(_tp), template_id(_template_id) {}
+
+  const String* class_id;
+  const std::vector<Template>* tp;
+  int template_id;
+};
+
+// Defined along with MatchTemplatesInvoker, next to Detector::matchClass()
+static void addMatchTasks(const String& class_id, const std::vector< std::vector<Template> >& template_pyramids,
+                          std::vector<TemplateMatchTask>& tasks);
+
+static void matchTemplates(const std::vector< std::vector< std::vector<Mat> > >& lm_pyramid,
+                           const std::vector<Size>& sizes, const std::vector<int>& T_at_level,
+                           int num_modalities, float threshold,
+                           const std::vector<TemplateMatchTask>& tasks, std::vector<Match>& matches);
+
 /****************************************************************************************\
 *                               High-level Detector API                                  *
 \****************************************************************************************/
@@ -1443,12 +1378,15 @@ void Detector::match(const std::vector<Mat>& sources, float threshold, std::vect
     sizes.push_back(quantized.size());
   }
 
+  // Gather templates of all requested classes, so they're matched in parallel together
+  // rather than class by class
+  std::vector<TemplateMatchTask> tasks;
   if (class_ids.empty())
   {
     // Match all templates
     TemplatesMap::const_iterator it = class_templates.begin(), itend = class_templates.end();
     for ( ; it != itend; ++it)
-      matchClass(lm_pyramid, sizes, threshold, matches, it->first, it->second);
+      addMatchTasks(it->first, it->second, tasks);
   }
   else
   {
@@ -1457,9 +1395,10 @@ void Detector::match(const std::vector<Mat>& sources, float threshold, std::vect
     {
       TemplatesMap::const_iterator it = class_templates.find(class_ids[i]);
       if (it != class_templates.end())
-        matchClass(lm_pyramid, sizes, threshold, matches, it->first, it->second);
+        addMatchTasks(it->first, it->second, tasks);
     }
   }
+  matchTemplates(lm_pyramid, sizes, T_at_level, static_cast<int>(modalities.size()), threshold, tasks, matches);
 
   // Sort matches by similarity, and prune any duplicates introduced by pyramid refinement
   std::sort(matches.begin(), matches.end());
@@ -1475,27 +1414,66 @@ struct MatchPredicate
   float threshold;
 };
 
-void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
-                          const std::vector<Size>& sizes,
-                          float threshold, std::vector<Match>& matches,
-                          const String& class_id,
-                          const std::vector<TemplatePyramid>& template_pyramids) const
+/**
+ * \brief Match template pyramids independently of each other.
+ *
+ * Every stripe keeps its own similarity buffers, and candidates of each template are
+ * stored separately, so the result doesn't depend on the number of threads.
+ */
+class MatchTemplatesInvoker : public ParallelLoopBody
 {
-  // For each template...
-  for (size_t template_id = 0; template_id < template_pyramids.size(); ++template_id)
+public:
+  MatchTemplatesInvoker(const std::vector< std::vector< std::vector<Mat> > >& _lm_pyramid,
+                        const std::vector<Size>& _sizes, const std::vector<int>& _T_at_level,
+                        int _num_modalities, float _threshold,
+                        const std::vector<TemplateMatchTask>& _tasks,
+                        std::vector< std::vector<Match> >& _candidates)
+    : lm_pyramid(_lm_pyramid), sizes(_sizes), T_at_level(_T_at_level),
+      num_modalities(_num_modalities), threshold(_threshold),
+      tasks(_tasks), candidates(_candidates)
+  {
+  }
+
+  virtual void operator() (const Range& range) const CV_OVERRIDE
+  {
+    // Similarity buffers are reused for all templates of the stripe
+    SimilarityBuffers buffers;
+    buffers.similarities.resize(num_modalities);
+    buffers.similarities2.resize(num_modalities);
+
+    for (int t = range.start; t < range.end; ++t)
+      matchTemplate(tasks[t], buffers, candidates[t]);
+  }
+
+private:
+  // Whole image similarities at the lowest pyramid level and 16x16 local ones
+  struct SimilarityBuffers
+  {
+    std::vector<Mat> similarities;
+    Mat total_similarity;
+    std::vector<Mat> similarities2;
+    Mat total_similarity2;
+  };
+
+  void matchTemplate(const TemplateMatchTask& task, SimilarityBuffers& buffers,
+                     std::vector<Match>& task_candidates) const
   {
-    const TemplatePyramid& tp = template_pyramids[template_id];
+    std::vector<Mat>& similarities = buffers.similarities;
+    Mat& total_similarity = buffers.total_similarity;
+    std::vector<Mat>& similarities2 = buffers.similarities2;
+    Mat& total_similarity2 = buffers.total_similarity2;
+
+    const std::vector<Template>& tp = *task.tp;
+    int pyramid_levels = static_cast<int>(T_at_level.size());
 
     // First match over the whole image at the lowest pyramid level
-    /// @todo Factor this out into separate function
-    const std::vector<LinearMemories>& lowest_lm = lm_pyramid.back();
+    const std::vector< std::vector<Mat> >& lowest_lm = lm_pyramid.back();
 
     // Compute similarity maps for each modality at lowest pyramid level
-    std::vector<Mat> similarities(modalities.size());
-    int lowest_start = static_cast<int>(tp.size() - modalities.size());
+    int lowest_start = static_cast<int>(tp.size()) - num_modalities;
     int lowest_T = T_at_level.back();
     int num_features = 0;
-    for (int i = 0; i < (int)modalities.size(); ++i)
+    for (int i = 0; i < num_modalities; ++i)
     {
       const Template& templ = tp[lowest_start + i];
       num_features += static_cast<int>(templ.features.size());
@@ -1504,7 +1482,6 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
 
     // Combine into overall similarity
     /// @todo Support weighting the modalities
-    Mat total_similarity;
     addSimilarities(similarities, total_similarity);
 
     // Convert user-friendly percentage to raw similarity threshold. The percentage
@@ -1514,7 +1491,7 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
     int raw_threshold = static_cast<int>(2*num_features + (threshold / 100.f) * (2*num_features) + 0.5f);
 
     // Find initial matches
-    std::vector<Match> candidates;
+    task_candidates.clear();
     for (int r = 0; r < total_similarity.rows; ++r)
     {
       ushort* row = total_similarity.ptr<ushort>(r);
@@ -1527,7 +1504,7 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
           int x = c * lowest_T + offset;
           int y = r * lowest_T + offset;
           float score =(raw_score * 100.f) / (4 * num_features) + 0.5f;
-          candidates.push_back(Match(x, y, score, class_id, static_cast<int>(template_id)));
+          task_candidates.push_back(Match(x, y, score, *task.class_id, task.template_id));
         }
       }
     }
@@ -1535,20 +1512,18 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
     // Locally refine each match by marching up the pyramid
     for (int l = pyramid_levels - 2; l >= 0; --l)
     {
-      const std::vector<LinearMemories>& lms = lm_pyramid[l];
+      const std::vector< std::vector<Mat> >& lms = lm_pyramid[l];
       int T = T_at_level[l];
-      int start = static_cast<int>(l * modalities.size());
+      int start = l * num_modalities;
       Size size = sizes[l];
       int border = 8 * T;
       int offset = T / 2 + (T % 2 - 1);
       int max_x = size.width - tp[start].width - border;
       int max_y = size.height - tp[start].height - border;
 
-      std::vector<Mat> similarities2(modalities.size());
-      Mat total_similarity2;
-      for (int m = 0; m < (int)candidates.size(); ++m)
+      for (int m = 0; m < (int)task_candidates.size(); ++m)
       {
-        Match& match2 = candidates[m];
+        Match& match2 = task_candidates[m];
         int x = match2.x * 2 + 1; /// @todo Support other pyramid distance
         int y = match2.y * 2 + 1;
 
@@ -1562,7 +1537,7 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
 
         // Compute local similarity maps for each modality
         int numFeatures = 0;
-        for (int i = 0; i < (int)modalities.size(); ++i)
+        for (int i = 0; i < num_modalities; ++i)
         {
           const Template& templ = tp[start + i];
           numFeatures += static_cast<int>(templ.features.size());
@@ -1594,13 +1569,57 @@ void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
       }
 
       // Filter out any matches that drop below the similarity threshold
-      std::vector<Match>::iterator new_end = std::remove_if(candidates.begin(), candidates.end(),
+      std::vector<Match>::iterator new_end = std::remove_if(task_candidates.begin(), task_candidates.end(),
                                                             MatchPredicate(threshold));
-      candidates.erase(new_end, candidates.end());
+      task_candidates.erase(new_end, task_candidates.end());
     }
-
-    matches.insert(matches.end(), candidates.begin(), candidates.end());
   }
+
+  const std::vector< std::vector< std::vector<Mat> > >& lm_pyramid;
+  const std::vector<Size>& sizes;
+  const std::vector<int>& T_at_level;
+  int num_modalities;
+  float threshold;
+  const std::vector<TemplateMatchTask>& tasks;
+  std::vector< std::vector<Match> >& candidates;
+};
+
+/**
+ * \brief Add a task for every template pyramid of a class.
+ */
+static void addMatchTasks(const String& class_id, const std::vector< std::vector<Template> >& template_pyramids,
+                          std::vector<TemplateMatchTask>& tasks)
+{
+  for (size_t template_id = 0; template_id < template_pyramids.size(); ++template_id)
+    tasks.push_back(TemplateMatchTask(&class_id, &template_pyramids[template_id], static_cast<int>(template_id)));
+}
+
+/**
+ * \brief Match all tasks in parallel and append the matches in the order of the tasks.
+ */
+static void matchTemplates(const std::vector< std::vector< std::vector<Mat> > >& lm_pyramid,
+                           const std::vector<Size>& sizes, const std::vector<int>& T_at_level,
+                           int num_modalities, float threshold,
+                           const std::vector<TemplateMatchTask>& tasks, std::vector<Match>& matches)
+{
+  std::vector< std::vector<Match> > candidates(tasks.size());
+  MatchTemplatesInvoker invoker(lm_pyramid, sizes, T_at_level, num_modalities, threshold,
+                                tasks, candidates);
+  parallel_for_(Range(0, static_cast<int>(tasks.size())), invoker);
+
+  for (size_t t = 0; t < candidates.size(); ++t)
+    matches.insert(matches.end(), candidates[t].begin(), candidates[t].end());
+}
+
+void Detector::matchClass(const LinearMemoryPyramid& lm_pyramid,
+                          const std::vector<Size>& sizes,
+                          float threshold, std::vector<Match>& matches,
+                          const String& class_id,
+                          const std::vector<TemplatePyramid>& template_pyramids) const
+{
+  std::vector<TemplateMatchTask> tasks;
+  addMatchTasks(class_id, template_pyramids, tasks);
+  matchTemplates(lm_pyramid, sizes, T_at_level, static_cast<int>(modalities.size()), threshold, tasks, matches);
 }
 
 int Detector::addTemplate(const std::vector<Mat>& sources, const String& class_id,
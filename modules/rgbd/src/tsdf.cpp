@@ -7,6 +7,7 @@
 #include "precomp.hpp"
 #include "tsdf.hpp"
 #include "opencl_kernels_rgbd.hpp"
+#include <unordered_map>
 
 namespace cv {
 
@@ -124,8 +125,8 @@ void TSDFVolumeCPU::reset()
     });
 }
 
-// SIMD version of that code is manually inlined
-#if !USE_INTRINSICS
+// SIMD version of that code is manually inlined into IntegrateInvoker,
+// the hashed volume always uses this one
 static const bool fixMissingData = false;
 
 static inline depthType bilinearDepth(const Depth& m, cv::Point2f pt)
@@ -200,7 +201,6 @@ static inline depthType bilinearDepth(const Depth& m, cv::Point2f pt)
         return v0 + ty*(v1 - v0);
     }
 }
-#endif
 
 struct IntegrateInvoker : ParallelLoopBody
 {
@@ -1106,9 +1106,10 @@ void TSDFVolumeCPU::fetchPointsNormals(OutputArray _points, OutputArray _normals
 }
 
 
+template<typename VolumeT>
 struct PushNormals
 {
-    PushNormals(const TSDFVolumeCPU& _vol, Mat_<ptype>& _nrm) :
+    PushNormals(const VolumeT& _vol, Mat_<ptype>& _nrm) :
         vol(_vol), normals(_nrm), invPose(vol.pose.inv())
     { }
     void operator ()(const ptype &pp, const int * position) const
@@ -1123,7 +1124,7 @@ struct PushNormals
         }
         normals(position[0], position[1]) = toPtype(n);
     }
-    const TSDFVolumeCPU& vol;
+    const VolumeT& vol;
     Mat_<ptype>& normals;
 
     Affine3f invPose;
@@ -1142,7 +1143,683 @@ void TSDFVolumeCPU::fetchNormals(InputArray _points, OutputArray _normals) const
         _normals.createSameSize(_points, _points.type());
         Mat_<ptype> normals = _normals.getMat();
 
-        points.forEach(PushNormals(*this, normals));
+        points.forEach(PushNormals<TSDFVolumeCPU>(*this, normals));
+    }
+}
+
+///////// Hashed CPU implementation /////////
+
+// Coordinates of a voxel block packed into one number
+typedef int64 BlockKey;
+
+// Keeps only the blocks of voxels which are close enough to observed surfaces.
+// Voxels of blocks which are not allocated read as unobserved voxels of the dense volume.
+class TSDFVolumeHashCPU : public TSDFVolume
+{
+public:
+    // dimension in voxels, size in meters, block size in voxels
+    TSDFVolumeHashCPU(Point3i _res, float _voxelSize, cv::Affine3f _pose, float _truncDist, int _maxWeight,
+                      float _raycastStepFactor, int _blockSize);
+
+    virtual void integrate(InputArray _depth, float depthFactor, cv::Affine3f cameraPose, cv::kinfu::Intr intrinsics) override;
+    virtual void raycast(cv::Affine3f cameraPose, cv::kinfu::Intr intrinsics, cv::Size frameSize,
+                         cv::OutputArray points, cv::OutputArray normals) const override;
+
+    virtual void fetchNormals(cv::InputArray points, cv::OutputArray _normals) const override;
+    virtual void fetchPointsNormals(cv::OutputArray points, cv::OutputArray normals) const override;
+
+    virtual void reset() override;
+
+    volumeType interpolateVoxel(cv::Point3f p) const;
+    Point3f getNormalVoxel(cv::Point3f p) const;
+
+    // returns NULL if the voxel is out of volume or its block is not allocated
+    const Voxel* findVoxel(int x, int y, int z) const;
+
+    inline volumeType voxelValue(int x, int y, int z) const
+    {
+        const Voxel* voxel = findVoxel(x, y, z);
+        return voxel ? voxel->v : 0.f;
+    }
+
+    inline BlockKey blockKey(Point3i b) const
+    {
+        return ((BlockKey)b.x*blockRes.y + b.y)*blockRes.z + b.z;
+    }
+
+    // allocates the blocks around depth points which are not allocated yet
+    // and fills visibleBlocks with all blocks around depth points
+    void allocateBlocks(const Depth& depth, float depthFactor, cv::Affine3f cameraPose, cv::kinfu::Intr intrinsics);
+
+    int blockSize;
+    int blockVolume;
+    // volume resolution in blocks
+    Point3i blockRes;
+    // the same as neighbourCoords but inside a block
+    Vec8i blockNeighbourCoords;
+
+    // blockVolume voxels per allocated block,
+    // &elem(x, y, z) = blockStart + x*blockSize*blockSize + y*blockSize + z;
+    std::vector<Voxel> blockVoxels;
+    // coordinates of allocated blocks in blocks
+    std::vector<Point3i> blockCoords;
+    // block key -> index of the block in blockCoords
+    std::unordered_map<BlockKey, int> blockIndices;
+    // indices of blocks updated by the last integrated frame
+    std::vector<int> visibleBlocks;
+};
+
+
+TSDFVolumeHashCPU::TSDFVolumeHashCPU(Point3i _res, float _voxelSize, cv::Affine3f _pose, float _truncDist, int _maxWeight,
+                                     float _raycastStepFactor, int _blockSize) :
+    TSDFVolume(_res, _voxelSize, _pose, _truncDist, _maxWeight, _raycastStepFactor),
+    blockSize(_blockSize)
+{
+    CV_Assert(blockSize > 0);
+
+    blockVolume = blockSize*blockSize*blockSize;
+    blockRes = Point3i(divUp(volResolution.x, (unsigned int)blockSize),
+                       divUp(volResolution.y, (unsigned int)blockSize),
+                       divUp(volResolution.z, (unsigned int)blockSize));
+
+    const int xdim = blockSize*blockSize, ydim = blockSize, zdim = 1;
+    blockNeighbourCoords = Vec8i(
+        0,
+        zdim,
+        ydim,
+        ydim + zdim,
+        xdim,
+        xdim + zdim,
+        xdim + ydim,
+        xdim + ydim + zdim
+    );
+
+    reset();
+}
+
+// free all blocks, leave rest params the same
+void TSDFVolumeHashCPU::reset()
+{
+    CV_TRACE_FUNCTION();
+
+    std::vector<Voxel>().swap(blockVoxels);
+    std::vector<Point3i>().swap(blockCoords);
+    blockIndices.clear();
+    visibleBlocks.clear();
+}
+
+inline const Voxel* TSDFVolumeHashCPU::findVoxel(int x, int y, int z) const
+{
+    if(x < 0 || x >= volResolution.x ||
+       y < 0 || y >= volResolution.y ||
+       z < 0 || z >= volResolution.z)
+        return NULL;
+
+    Point3i b(x/blockSize, y/blockSize, z/blockSize);
+    std::unordered_map<BlockKey, int>::const_iterator it = blockIndices.find(blockKey(b));
+    if(it == blockIndices.end())
+        return NULL;
+
+    int lx = x - b.x*blockSize, ly = y - b.y*blockSize, lz = z - b.z*blockSize;
+    return &blockVoxels[(size_t)it->second*blockVolume + (lx*blockSize + ly)*blockSize + lz];
+}
+
+void TSDFVolumeHashCPU::allocateBlocks(const Depth& depth, float depthFactor, cv::Affine3f cameraPose, Intr intrinsics)
+{
+    CV_TRACE_FUNCTION();
+
+    const Intr::Reprojector reproj = intrinsics.makeReprojector();
+    const Affine3f cam2vol = pose.inv() * cameraPose;
+    // in voxels
+    const Point3f camTrans = cam2vol.translation()*voxelSizeInv;
+    const Matx33f camRot = cam2vol.rotation();
+    const float dfac = 1.f/depthFactor;
+    const float blockSizeInv = 1.f/blockSize;
+    // voxel (x, y, z) spans [x - 0.5, x + 0.5) and so on
+    const Point3f voxelCorner(0.5f, 0.5f, 0.5f);
+    // samples of neighbour pixels mostly fall into the same blocks
+    const size_t recentKeys = 16;
+
+    std::vector<BlockKey> keys;
+    for(int y = 0; y < depth.rows; y++)
+    {
+        const depthType* depthRow = depth[y];
+        for(int x = 0; x < depth.cols; x++)
+        {
+            float d = depthRow[x]*dfac;
+            // also skips NaNs
+            if(!(d > 0))
+                continue;
+
+            // ray through the pixel in voxels per meter of depth
+            Point3f dir = camRot * reproj(Point3f((float)x, (float)y, 1.f)) * voxelSizeInv;
+
+            // the part of the ray inside the truncation band in block units,
+            // walked block by block (3D-DDA) so that no block it crosses is skipped
+            Point3f p0 = (camTrans + dir*max(d - truncDist, 0.f) + voxelCorner)*blockSizeInv;
+            Point3f p1 = (camTrans + dir*(d + truncDist) + voxelCorner)*blockSizeInv;
+            Vec3f start(p0.x, p0.y, p0.z), delta(p1.x - p0.x, p1.y - p0.y, p1.z - p0.z);
+
+            const float noCrossing = std::numeric_limits<float>::max();
+            Vec3i b, step;
+            Vec3f tMax, tDelta;
+            int nBlocks = 1;
+            for(int k = 0; k < 3; k++)
+            {
+                b[k] = cvFloor(start[k]);
+                int last = cvFloor(start[k] + delta[k]);
+                nBlocks += std::abs(last - b[k]);
+                step[k] = delta[k] > 0 ? 1 : -1;
+                // ray parameter in [0, 1] where the ray crosses the next block boundary along this axis
+                tMax[k] = delta[k] != 0 ? ((float)(b[k] + (step[k] > 0)) - start[k])/delta[k] : noCrossing;
+                tDelta[k] = delta[k] != 0 ? step[k]/delta[k] : noCrossing;
+            }
+
+            for(int i = 0; i < nBlocks; i++)
+            {
+                if(b[0] >= 0 && b[0] < blockRes.x &&
+                   b[1] >= 0 && b[1] < blockRes.y &&
+                   b[2] >= 0 && b[2] < blockRes.z)
+                {
+                    BlockKey key = blockKey(Point3i(b[0], b[1], b[2]));
+                    bool found = false;
+                    for(size_t j = keys.size() - min(keys.size(), recentKeys); j < keys.size(); j++)
+                        found = found || (keys[j] == key);
+                    if(!found)
+                        keys.push_back(key);
+                }
+
+                int k = tMax[0] < tMax[1] ? (tMax[0] < tMax[2] ? 0 : 2) : (tMax[1] < tMax[2] ? 1 : 2);
+                b[k] += step[k];
+                tMax[k] += tDelta[k];
+            }
+        }
+    }
+
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    Voxel emptyVoxel;
+    emptyVoxel.v = 0; emptyVoxel.weight = 0;
+
+    visibleBlocks.clear();
+    for(size_t i = 0; i < keys.size(); i++)
+    {
+        BlockKey key = keys[i];
+        std::pair<std::unordered_map<BlockKey, int>::iterator, bool> inserted =
+            blockIndices.insert(std::make_pair(key, (int)blockCoords.size()));
+        if(inserted.second)
+        {
+            int bz = (int)(key % blockRes.z);
+            int by = (int)((key / blockRes.z) % blockRes.y);
+            int bx = (int)(key / blockRes.z / blockRes.y);
+            blockCoords.push_back(Point3i(bx, by, bz));
+            blockVoxels.resize(blockVoxels.size() + blockVolume, emptyVoxel);
+        }
+        visibleBlocks.push_back(inserted.first->second);
+    }
+}
+
+
+struct IntegrateHashInvoker : ParallelLoopBody
+{
+    IntegrateHashInvoker(TSDFVolumeHashCPU& _volume, const Depth& _depth, Intr intrinsics, cv::Affine3f cameraPose,
+                         float depthFactor) :
+        ParallelLoopBody(),
+        volume(_volume),
+        depth(_depth),
+        proj(intrinsics.makeProjector()),
+        vol2cam(cameraPose.inv() * _volume.pose),
+        truncDistInv(1.f/_volume.truncDist),
+        dfac(1.f/depthFactor)
+    { }
+
+    virtual void operator() (const Range& range) const override
+    {
+        const int blockSize = volume.blockSize;
+        // zStep == vol2cam*(Point3f(x, y, 1)*voxelSize) - vol2cam*(Point3f(x, y, 0)*voxelSize);
+        const Point3f zStep = Point3f(vol2cam.matrix(0, 2),
+                                      vol2cam.matrix(1, 2),
+                                      vol2cam.matrix(2, 2))*volume.voxelSize;
+
+        for(int i = range.start; i < range.end; i++)
+        {
+            int idx = volume.visibleBlocks[i];
+            Point3i blockStart = volume.blockCoords[idx]*blockSize;
+            Voxel* blockData = &volume.blockVoxels[(size_t)idx*volume.blockVolume];
+
+            // blocks on the border can be cut by volume bounds
+            int endX = min(blockSize, volume.volResolution.x - blockStart.x);
+            int endY = min(blockSize, volume.volResolution.y - blockStart.y);
+            int endZ = min(blockSize, volume.volResolution.z - blockStart.z);
+
+            for(int x = 0; x < endX; x++)
+            {
+                for(int y = 0; y < endY; y++)
+                {
+                    Voxel* blockDataY = blockData + (x*blockSize + y)*blockSize;
+                    Point3f camSpacePt = vol2cam*(Point3f(blockStart + Point3i(x, y, 0))*volume.voxelSize);
+                    for(int z = 0; z < endZ; z++, camSpacePt += zStep)
+                    {
+                        if(camSpacePt.z <= 0)
+                            continue;
+
+                        Point3f camPixVec;
+                        Point2f projected = proj(camSpacePt, camPixVec);
+
+                        depthType v = bilinearDepth(depth, projected);
+                        if(v == 0)
+                            continue;
+
+                        // norm(camPixVec) produces double which is too slow
+                        float pixNorm = sqrt(camPixVec.dot(camPixVec));
+                        // difference between distances of point and of surface to camera
+                        volumeType sdf = pixNorm*(v*dfac - camSpacePt.z);
+
+                        if(sdf >= -volume.truncDist)
+                        {
+                            volumeType tsdf = fmin(1.f, sdf * truncDistInv);
+
+                            Voxel& voxel = blockDataY[z];
+                            int& weight = voxel.weight;
+                            volumeType& value = voxel.v;
+
+                            // update TSDF
+                            value = (value*weight+tsdf) / (weight + 1);
+                            weight = min(weight + 1, volume.maxWeight);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    TSDFVolumeHashCPU& volume;
+    const Depth& depth;
+    const Intr::Projector proj;
+    const cv::Affine3f vol2cam;
+    const float truncDistInv;
+    const float dfac;
+};
+
+// use depth instead of distance (optimization)
+void TSDFVolumeHashCPU::integrate(InputArray _depth, float depthFactor, cv::Affine3f cameraPose, Intr intrinsics)
+{
+    CV_TRACE_FUNCTION();
+
+    CV_Assert(_depth.type() == DEPTH_TYPE);
+    Depth depth = _depth.getMat();
+
+    // only the blocks around the surface are updated,
+    // free space far in front of it is left unobserved
+    allocateBlocks(depth, depthFactor, cameraPose, intrinsics);
+
+    IntegrateHashInvoker ii(*this, depth, intrinsics, cameraPose, depthFactor);
+    Range range(0, (int)visibleBlocks.size());
+    parallel_for_(range, ii);
+}
+
+inline volumeType TSDFVolumeHashCPU::interpolateVoxel(Point3f p) const
+{
+    int ix = cvFloor(p.x);
+    int iy = cvFloor(p.y);
+    int iz = cvFloor(p.z);
+
+    float tx = p.x - ix;
+    float ty = p.y - iy;
+    float tz = p.z - iz;
+
+    volumeType vx[8];
+    // usually all neighbours are in the same block, then one lookup is enough
+    if(ix >= 0 && iy >= 0 && iz >= 0 &&
+       ix % blockSize < blockSize - 1 &&
+       iy % blockSize < blockSize - 1 &&
+       iz % blockSize < blockSize - 1)
+    {
+        const Voxel* base = findVoxel(ix, iy, iz);
+        for(int i = 0; i < 8; i++)
+            vx[i] = base ? base[blockNeighbourCoords[i]].v : 0.f;
+    }
+    else
+    {
+        for(int i = 0; i < 8; i++)
+            vx[i] = voxelValue(ix + (i >> 2), iy + ((i >> 1) & 1), iz + (i & 1));
+    }
+
+    volumeType v00 = vx[0] + tz*(vx[1] - vx[0]);
+    volumeType v01 = vx[2] + tz*(vx[3] - vx[2]);
+    volumeType v10 = vx[4] + tz*(vx[5] - vx[4]);
+    volumeType v11 = vx[6] + tz*(vx[7] - vx[6]);
+
+    volumeType v0 = v00 + ty*(v01 - v00);
+    volumeType v1 = v10 + ty*(v11 - v10);
+
+    return v0 + tx*(v1 - v0);
+}
+
+inline Point3f TSDFVolumeHashCPU::getNormalVoxel(Point3f p) const
+{
+    if(p.x < 1 || p.x >= volResolution.x - 2 ||
+       p.y < 1 || p.y >= volResolution.y - 2 ||
+       p.z < 1 || p.z >= volResolution.z - 2)
+        return nan3;
+
+    // the same as interpolation of central differences in dense volume
+    Vec3f an(interpolateVoxel(Point3f(p.x + 1, p.y, p.z)) - interpolateVoxel(Point3f(p.x - 1, p.y, p.z)),
+             interpolateVoxel(Point3f(p.x, p.y + 1, p.z)) - interpolateVoxel(Point3f(p.x, p.y - 1, p.z)),
+             interpolateVoxel(Point3f(p.x, p.y, p.z + 1)) - interpolateVoxel(Point3f(p.x, p.y, p.z - 1)));
+
+    return normalize(an);
+}
+
+
+struct RaycastHashInvoker : ParallelLoopBody
+{
+    RaycastHashInvoker(Points& _points, Normals& _normals, Affine3f cameraPose,
+                       Intr intrinsics, const TSDFVolumeHashCPU& _volume) :
+        ParallelLoopBody(),
+        points(_points),
+        normals(_normals),
+        volume(_volume),
+        tstep(volume.truncDist * volume.raycastStepFactor),
+        // See RaycastInvoker
+        boxMax(volume.volSize - Point3f(volume.voxelSize,
+                                        volume.voxelSize,
+                                        volume.voxelSize)),
+        boxMin(),
+        cam2vol(volume.pose.inv() * cameraPose),
+        vol2cam(cameraPose.inv() * volume.pose),
+        reproj(intrinsics.makeReprojector())
+    {  }
+
+    virtual void operator() (const Range& range) const override
+    {
+        const Point3f camTrans = cam2vol.translation();
+        const Matx33f  camRot  = cam2vol.rotation();
+        const Matx33f  volRot  = vol2cam.rotation();
+
+        for(int y = range.start; y < range.end; y++)
+        {
+            ptype* ptsRow = points[y];
+            ptype* nrmRow = normals[y];
+
+            for(int x = 0; x < points.cols; x++)
+            {
+                Point3f point = nan3, normal = nan3;
+
+                Point3f orig = camTrans;
+                // direction through pixel in volume space
+                Point3f dir = normalize(Vec3f(camRot * reproj(Point3f(x, y, 1.f))));
+
+                // compute intersection of ray with all six bbox planes
+                Vec3f rayinv(1.f/dir.x, 1.f/dir.y, 1.f/dir.z);
+                Point3f tbottom = rayinv.mul(boxMin - orig);
+                Point3f ttop    = rayinv.mul(boxMax - orig);
+
+                // re-order intersections to find smallest and largest on each axis
+                Point3f minAx(min(ttop.x, tbottom.x), min(ttop.y, tbottom.y), min(ttop.z, tbottom.z));
+                Point3f maxAx(max(ttop.x, tbottom.x), max(ttop.y, tbottom.y), max(ttop.z, tbottom.z));
+
+                // near clipping plane
+                const float clip = 0.f;
+                float tmin = max(max(max(minAx.x, minAx.y), max(minAx.x, minAx.z)), clip);
+                float tmax =     min(min(maxAx.x, maxAx.y), min(maxAx.x, maxAx.z));
+
+                // precautions against getting coordinates out of bounds
+                tmin = tmin + tstep;
+                tmax = tmax - tstep;
+
+                if(tmin < tmax)
+                {
+                    // interpolation optimized a little
+                    orig = orig*volume.voxelSizeInv;
+                    dir  =  dir*volume.voxelSizeInv;
+
+                    Point3f rayStep = dir * tstep;
+                    Point3f next = (orig + dir * tmin);
+                    volumeType f = volume.interpolateVoxel(next), fnext = f;
+
+                    //raymarch
+                    int steps = 0;
+                    int nSteps = floor((tmax - tmin)/tstep);
+                    for(; steps < nSteps; steps++)
+                    {
+                        next += rayStep;
+                        // voxels of missing blocks are zeros like unobserved voxels of dense volume
+                        fnext = volume.voxelValue(cvRound(next.x), cvRound(next.y), cvRound(next.z));
+                        if(fnext != f)
+                        {
+                            fnext = volume.interpolateVoxel(next);
+
+                            // when ray crosses a surface
+                            if(std::signbit(f) != std::signbit(fnext))
+                                break;
+
+                            f = fnext;
+                        }
+                    }
+
+                    // if ray penetrates a surface from outside
+                    // linearly interpolate t between two f values
+                    if(f > 0.f && fnext < 0.f)
+                    {
+                        Point3f tp = next - rayStep;
+                        volumeType ft   = volume.interpolateVoxel(tp);
+                        volumeType ftdt = volume.interpolateVoxel(next);
+                        float ts = tmin + tstep*(steps - ft/(ftdt - ft));
+
+                        // avoid division by zero
+                        if(!cvIsNaN(ts) && !cvIsInf(ts))
+                        {
+                            Point3f pv = (orig + dir*ts);
+                            Point3f nv = volume.getNormalVoxel(pv);
+
+                            if(!isNaN(nv))
+                            {
+                                //convert pv and nv to camera space
+                                normal = volRot * nv;
+                                // interpolation optimized a little
+                                point = vol2cam * (pv*volume.voxelSize);
+                            }
+                        }
+                    }
+                }
+
+                ptsRow[x] = toPtype(point);
+                nrmRow[x] = toPtype(normal);
+            }
+        }
+    }
+
+    Points& points;
+    Normals& normals;
+    const TSDFVolumeHashCPU& volume;
+
+    const float tstep;
+
+    const Point3f boxMax;
+    const Point3f boxMin;
+
+    const Affine3f cam2vol;
+    const Affine3f vol2cam;
+    const Intr::Reprojector reproj;
+};
+
+
+void TSDFVolumeHashCPU::raycast(cv::Affine3f cameraPose, Intr intrinsics, Size frameSize,
+                                cv::OutputArray _points, cv::OutputArray _normals) const
+{
+    CV_TRACE_FUNCTION();
+
+    CV_Assert(frameSize.area() > 0);
+
+    _points.create (frameSize, POINT_TYPE);
+    _normals.create(frameSize, POINT_TYPE);
+
+    Points points   =  _points.getMat();
+    Normals normals = _normals.getMat();
+
+    RaycastHashInvoker ri(points, normals, cameraPose, intrinsics, *this);
+
+    const int nstripes = -1;
+    parallel_for_(Range(0, points.rows), ri, nstripes);
+}
+
+
+struct FetchPointsNormalsHashInvoker : ParallelLoopBody
+{
+    FetchPointsNormalsHashInvoker(const TSDFVolumeHashCPU& _volume,
+                                  std::vector< std::vector<ptype> >& _pVecs,
+                                  std::vector< std::vector<ptype> >& _nVecs,
+                                  bool _needNormals) :
+        ParallelLoopBody(),
+        vol(_volume),
+        pVecs(_pVecs),
+        nVecs(_nVecs),
+        needNormals(_needNormals),
+        res(_volume.volResolution.x, _volume.volResolution.y, _volume.volResolution.z),
+        blockDims(_volume.blockSize*_volume.blockSize, _volume.blockSize, 1)
+    { }
+
+    inline void coord(std::vector<ptype>& points, std::vector<ptype>& normals,
+                      const Voxel& voxel0, Vec3i pos, Vec3i local, Vec3f V, int axis) const
+    {
+        // 0 for x, 1 for y, 2 for z
+        Vec3i posd = pos;
+        posd[axis]++;
+        if(posd[axis] >= res[axis])
+            return;
+
+        // neighbours inside the block are found without a lookup
+        const Voxel* voxeld = (local[axis] + 1 < vol.blockSize) ? &voxel0 + blockDims[axis] :
+                                                                   vol.findVoxel(posd[0], posd[1], posd[2]);
+        if(!voxeld)
+            return;
+
+        volumeType v0 = voxel0.v;
+        volumeType vd = voxeld->v;
+
+        if(voxeld->weight != 0 && vd != 1.f)
+        {
+            if((v0 > 0 && vd < 0) || (v0 < 0 && vd > 0))
+            {
+                //linearly interpolate coordinate
+                float Vc = V[axis];
+                float Vn = Vc + vol.voxelSize;
+                float dinv = 1.f/(abs(v0)+abs(vd));
+                float inter = (Vc*abs(vd) + Vn*abs(v0))*dinv;
+
+                Vec3f pv = V;
+                pv[axis] = inter;
+                Point3f p(pv);
+
+                points.push_back(toPtype(vol.pose * p));
+                if(needNormals)
+                    normals.push_back(toPtype(vol.pose.rotation() *
+                                              vol.getNormalVoxel(p*vol.voxelSizeInv)));
+            }
+        }
+    }
+
+    virtual void operator() (const Range& range) const override
+    {
+        const int blockSize = vol.blockSize;
+
+        std::vector<ptype> points, normals;
+        for(int i = range.start; i < range.end; i++)
+        {
+            Point3i blockStart = vol.blockCoords[i]*blockSize;
+            const Voxel* blockData = &vol.blockVoxels[(size_t)i*vol.blockVolume];
+
+            int endX = min(blockSize, res[0] - blockStart.x);
+            int endY = min(blockSize, res[1] - blockStart.y);
+            int endZ = min(blockSize, res[2] - blockStart.z);
+
+            for(int x = 0; x < endX; x++)
+            {
+                for(int y = 0; y < endY; y++)
+                {
+                    const Voxel* blockDataY = blockData + (x*blockSize + y)*blockSize;
+                    for(int z = 0; z < endZ; z++)
+                    {
+                        const Voxel& voxel0 = blockDataY[z];
+                        if(voxel0.weight != 0 && voxel0.v != 1.f)
+                        {
+                            Vec3i local(x, y, z);
+                            Vec3i pos = Vec3i(blockStart.x, blockStart.y, blockStart.z) + local;
+                            Vec3f V = Vec3f((float)pos[0] + 0.5f,
+                                            (float)pos[1] + 0.5f,
+                                            (float)pos[2] + 0.5f)*vol.voxelSize;
+
+                            coord(points, normals, voxel0, pos, local, V, 0);
+                            coord(points, normals, voxel0, pos, local, V, 1);
+                            coord(points, normals, voxel0, pos, local, V, 2);
+
+                        } // if voxel is not empty
+                    }
+                }
+            }
+        }
+
+        AutoLock al(mutex);
+        pVecs.push_back(points);
+        nVecs.push_back(normals);
+    }
+
+    const TSDFVolumeHashCPU& vol;
+    std::vector< std::vector<ptype> >& pVecs;
+    std::vector< std::vector<ptype> >& nVecs;
+    bool needNormals;
+    const Vec3i res;
+    // voxel offsets to the next voxel along each axis inside a block
+    const Vec3i blockDims;
+    mutable Mutex mutex;
+};
+
+void TSDFVolumeHashCPU::fetchPointsNormals(OutputArray _points, OutputArray _normals) const
+{
+    CV_TRACE_FUNCTION();
+
+    if(_points.needed())
+    {
+        std::vector< std::vector<ptype> > pVecs, nVecs;
+        FetchPointsNormalsHashInvoker fi(*this, pVecs, nVecs, _normals.needed());
+        Range range(0, (int)blockCoords.size());
+        const int nstripes = -1;
+        parallel_for_(range, fi, nstripes);
+        std::vector<ptype> points, normals;
+        for(size_t i = 0; i < pVecs.size(); i++)
+        {
+            points.insert(points.end(), pVecs[i].begin(), pVecs[i].end());
+            normals.insert(normals.end(), nVecs[i].begin(), nVecs[i].end());
+        }
+
+        _points.create((int)points.size(), 1, POINT_TYPE);
+        if(!points.empty())
+            Mat((int)points.size(), 1, POINT_TYPE, &points[0]).copyTo(_points.getMat());
+
+        if(_normals.needed())
+        {
+            _normals.create((int)normals.size(), 1, POINT_TYPE);
+            if(!normals.empty())
+                Mat((int)normals.size(), 1, POINT_TYPE, &normals[0]).copyTo(_normals.getMat());
+        }
+    }
+}
+
+void TSDFVolumeHashCPU::fetchNormals(InputArray _points, OutputArray _normals) const
+{
+    CV_TRACE_FUNCTION();
+
+    if(_normals.needed())
+    {
+        Points points = _points.getMat();
+        CV_Assert(points.type() == POINT_TYPE);
+
+        _normals.createSameSize(_points, _points.type());
+        Mat_<ptype> normals = _normals.getMat();
+
+        points.forEach(PushNormals<TSDFVolumeHashCPU>(*this, normals));
     }
 }
 
@@ -1471,8 +2148,12 @@ void TSDFVolumeGPU::fetchPointsNormals(OutputArray points, OutputArray normals)
 #endif
 
 cv::Ptr<TSDFVolume> makeTSDFVolume(Point3i _res,  float _voxelSize, cv::Affine3f _pose, float _truncDist, int _maxWeight,
-                                   float _raycastStepFactor)
+                                   float _raycastStepFactor, bool _hashed, int _blockSize)
 {
+    // there's no GPU implementation of the hashed volume
+    if(_hashed)
+        return cv::makePtr<TSDFVolumeHashCPU>(_res, _voxelSize, _pose, _truncDist, _maxWeight, _raycastStepFactor,
+                                              _blockSize);
 #ifdef HAVE_OPENCL
     if(cv::ocl::useOpenCL())
         return cv::makePtr<TSDFVolumeGPU>(_res, _voxelSize, _pose, _truncDist, _maxWeight, _raycastStepFactor);
@@ -44,8 +44,9 @@ public:
     Vec8i neighbourCoords;
 };
 
+// _hashed selects the volume which allocates blocks of _blockSize^3 voxels on demand
 cv::Ptr<TSDFVolume> makeTSDFVolume(Point3i _res,  float _voxelSize, cv::Affine3f _pose, float _truncDist, int _maxWeight,
-                                   float _raycastStepFactor);
+                                   float _raycastStepFactor, bool _hashed = false, int _blockSize = 8);
 
 } // namespace kinfu
 } // namespace cv
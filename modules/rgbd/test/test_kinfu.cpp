@@ -276,7 +276,7 @@ Ptr<Scene> Scene::create(int nScene, Size sz, Matx33f _intr, float _depthFactor)
 
 static const bool display = false;
 
-void flyTest(bool hiDense, bool inequal)
+void flyTest(bool hiDense, bool inequal, bool hashed = false)
 {
     Ptr<kinfu::Params> params;
     if(hiDense)
@@ -290,6 +290,8 @@ void flyTest(bool hiDense, bool inequal)
         params->volumeDims[1] -= 32;
     }
 
+    params->hashedVolume = hashed;
+
     Ptr<Scene> scene = Scene::create(hiDense, params->frameSize, params->intr, params->depthFactor);
 
     Ptr<kinfu::KinFu> kf = kinfu::KinFu::create(params);
@@ -355,6 +357,15 @@ TEST(KinectFusion, DISABLED_inequal)
     flyTest(false, true);
 }
 
+#ifdef OPENCV_ENABLE_NONFREE
+TEST( KinectFusion, hashed )
+#else
+TEST(KinectFusion, DISABLED_hashed)
+#endif
+{
+    flyTest(false, false, true);
+}
+
 #ifdef HAVE_OPENCL
 #ifdef OPENCV_ENABLE_NONFREE
 TEST( KinectFusion, OCL )
@@ -0,0 +1,82 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html
+
+// This code is also subject to the license terms in the LICENSE_WillowGarage.md file found in this module's directory
+
+#include "test_precomp.hpp"
+
+namespace opencv_test { namespace {
+
+// A rectangle and a circle of different colors on black background
+static Mat makeShapes(Point shift, Scalar circleColor = Scalar(0, 128, 255))
+{
+    Mat img(480, 640, CV_8UC3, Scalar::all(0));
+    rectangle(img, Rect(200, 150, 120, 80) + shift, Scalar::all(255), FILLED);
+    circle(img, Point(330, 260) + shift, 40, circleColor, FILLED);
+    return img;
+}
+
+static int addShapesTemplate(const Ptr<linemod::Detector>& detector, const String& class_id,
+                             const Mat& img, Rect& bb)
+{
+    Mat mask;
+    cvtColor(img, mask, COLOR_BGR2GRAY);
+    mask = mask > 0;
+    return detector->addTemplate(std::vector<Mat>(1, img), class_id, mask, &bb);
+}
+
+TEST(Linemod, FindsShiftedTemplate)
+{
+    Ptr<linemod::Detector> detector = linemod::getDefaultLINE();
+
+    Rect bb;
+    ASSERT_EQ(0, addShapesTemplate(detector, "shapes", makeShapes(Point(0, 0)), bb));
+
+    const Point shift(40, 25);
+    std::vector<linemod::Match> matches;
+    detector->match(std::vector<Mat>(1, makeShapes(shift)), 80.f, matches);
+
+    ASSERT_FALSE(matches.empty());
+    EXPECT_EQ("shapes", matches[0].class_id);
+    EXPECT_EQ(0, matches[0].template_id);
+    EXPECT_NEAR(bb.x + shift.x, matches[0].x, 5);
+    EXPECT_NEAR(bb.y + shift.y, matches[0].y, 5);
+    EXPECT_GT(matches[0].similarity, 90.f);
+}
+
+TEST(Linemod, MatchDoesNotDependOnThreads)
+{
+    Ptr<linemod::Detector> detector = linemod::getDefaultLINE();
+
+    // several classes with several templates each are matched together
+    Rect bb;
+    for (int i = 0; i < 4; i++)
+    {
+        Point shift(10*i, -5*i);
+        ASSERT_GE(addShapesTemplate(detector, "shapes", makeShapes(shift), bb), 0);
+        ASSERT_GE(addShapesTemplate(detector, "other", makeShapes(shift, Scalar(255, 0, 0)), bb), 0);
+    }
+
+    std::vector<Mat> sources(1, makeShapes(Point(30, 20)));
+
+    int threads = getNumThreads();
+    std::vector<linemod::Match> serial, parallel;
+    setNumThreads(1);
+    detector->match(sources, 70.f, serial);
+    setNumThreads(threads);
+    detector->match(sources, 70.f, parallel);
+
+    ASSERT_FALSE(serial.empty());
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        EXPECT_EQ(serial[i].x, parallel[i].x);
+        EXPECT_EQ(serial[i].y, parallel[i].y);
+        EXPECT_EQ(serial[i].similarity, parallel[i].similarity);
+        EXPECT_EQ(serial[i].class_id, parallel[i].class_id);
+        EXPECT_EQ(serial[i].template_id, parallel[i].template_id);
+    }
+}
+
+}} // namespace
@@ -5,5 +5,10 @@
 #include "seamcarver/seamcarver.hpp"
 #include "seamcarver/verticalseamcarver.hpp"
 #include "seamcarver/verticalseamcarverkeepout.hpp"
+#include "seamcarver/horizontalseamcarver.hpp"
+#include "seamcarver/retargetingseamcarver.hpp"
+#include "seamcarver/videoseamcarver.hpp"
+#include "seamcarver/pyramidseamcarver.hpp"
+#include "seamcarver/seamcarverpool.hpp"
 
 #endif //__OPENCV_SEAMCARVER_HPP__
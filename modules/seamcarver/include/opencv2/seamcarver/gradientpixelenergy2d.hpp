@@ -48,6 +48,11 @@
 
 namespace cv
 {
+    /**
+     * Dual gradient pixel energy: the sum of the squared differences of the left/right and
+     * up/down neighbours over all channels. Border pixels get the margin energy. Rows are split
+     * into tiles that run on the OpenCV thread pool.
+     */
     class CV_EXPORTS GradientPixelEnergy2D : public PixelEnergy2D
     {
     public:
@@ -65,11 +70,23 @@ namespace cv
         /**
          * @brief calculate energy for every pixel in image
          * @param image: 2D matrix representation of the image
-         * @param outPixelEnergy: Out parameter, 2D vector of calculated pixel energies
-         * @return bool: indicates if the operation was successful
+         * @param outPixelEnergy: Out parameter, CV_32FC1 matrix of calculated pixel energies
          */
-        virtual void calculatePixelEnergy(const cv::Mat& image,
-                                         std::vector<std::vector<double>>& outPixelEnergy) override;
+        virtual void calculatePixelEnergy(const cv::Mat& image, cv::Mat& outPixelEnergy) override;
+
+        using PixelEnergy2D::calculatePixelEnergy;
+
+        /**
+         * @brief enable/disable the vectorized gradient calculation for 8 bit images
+         * @param bEnable: true to use universal intrinsics where available
+         */
+        virtual void setVectorization(bool bEnable);
+
+        /**
+         * @brief returns whether the vectorized gradient calculation is enabled
+         * @return bool
+         */
+        virtual bool isVectorizationEnabled() const;
 
         // Deleted/defaulted
         GradientPixelEnergy2D(const GradientPixelEnergy2D&) = delete;
@@ -79,44 +96,20 @@ namespace cv
 
     protected:
         /**
-         * @brief calculate pixel energy for all rows (but either odd or even columns)
+         * @brief calculate the pixel energy of rows [startRow, endRow) straight from the
+         *        interleaved image
          * @param image: 2D matrix representation of the image
-         * @param outPixelEnergy: Out parameter, 2D vector of calculated pixel energies
-         * @param bDoOddColumns: Indicates whether odd or even columns are done
-         * @return bool: indicates if the operation was successful
+         * @param startRow: first row to calculate
+         * @param endRow: one past the last row to calculate
+         * @param outPixelEnergy: output parameter CV_32FC1 matrix of computed pixel energies
          */
-        virtual void calculatePixelEnergyForEveryRow(
-            const cv::Mat& image,
-            std::vector<std::vector<double>>& outPixelEnergy,
-            bool bDoOddColumns);
-
-        /**
-         * @brief calculate pixel energy for all columns (but either odd or even rows)
-         * @param image: 2D matrix representation of the image
-         * @param outPixelEnergy: output parameter 2D vector of computed pixel energies
-         * @param bDoOddRows: indicates whether odd or even rows are done
-         * @return bool: indicates if the operation was successful
-         */
-        virtual void calculatePixelEnergyForEveryColumn(
-            const cv::Mat& image,
-            std::vector<std::vector<double>>& outPixelEnergy,
-            bool bDoOddRows);
-
-        // store an exception if a thread throws it
-        std::exception_ptr threadExceptionPtr = nullptr;
-
-        // mutex to protect the exception ptr above
-        std::mutex threadExceptionPtrMutex;
-
-        // energy at the borders of an image
-        double marginEnergy_ = 0.0;
+        virtual void calculatePixelEnergyForRows(const cv::Mat& image,
+                                                 size_t startRow,
+                                                 size_t endRow,
+                                                 cv::Mat& outPixelEnergy) const;
 
-        // image dimensions
-        size_t numRows_ = 0;
-        size_t numColumns_ = 0;
-        size_t bottomRow_ = 0;
-        size_t rightColumn_ = 0;
-        size_t numColorChannels_ = 0;
+        // enables the vectorized path for 8 bit images
+        bool bVectorizationEnabled_ = true;
     };
 }
 
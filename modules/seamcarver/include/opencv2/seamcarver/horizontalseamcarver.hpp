@@ -0,0 +1,188 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#ifndef OPENCV_SEAMCARVER_HORIZONTALSEAMCARVER_HPP
+#define OPENCV_SEAMCARVER_HORIZONTALSEAMCARVER_HPP
+
+#include <opencv2/core.hpp>
+#include "opencv2/seamcarver/verticalseamcarver.hpp"
+
+namespace cv
+{
+    /**
+     * Removes horizontal seams (one pixel per image column) without transposing the image.
+     * The seam search reuses VerticalSeamCarver on cumulative energy tables laid out with one
+     * table row per image column, so inside those tables rows are image columns and columns
+     * are image rows. Only the float pixel energy is transposed into that layout; pixels are
+     * removed directly from the interleaved image. The cumulative energy sweep depends on the
+     * previous table row, so sweeping the image layout column by column would carry that
+     * dependency along every image row, where the vectorized row sweep can't be used.
+     */
+    class CV_EXPORTS HorizontalSeamCarver : public VerticalSeamCarver
+    {
+    public:
+        /**
+         * @brief default ctor
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        HorizontalSeamCarver(double marginEnergy = 390150.0,
+                             PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on dimensions
+         * @param numRows: image height
+         * @param numColumns: image width
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        HorizontalSeamCarver(size_t numRows,
+                             size_t numColumns,
+                             double marginEnergy = 390150.0,
+                             PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on a sample image
+         * @param img: sample image
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        HorizontalSeamCarver(const cv::Mat& img,
+                             double marginEnergy = 390150.0,
+                             PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief dtor
+         */
+        virtual ~HorizontalSeamCarver();
+
+        /**
+         * @brief run the horizontal seam remover algorithm
+         * @param numSeamsToRemove: number of horizontal seams to remove
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void runSeamRemover(size_t numSeamsToRemove,
+                                    const cv::Mat& image,
+                                    cv::Mat& outImage) override;
+
+        /**
+         * @brief run the horizontal seam inserter algorithm. Every seam pixel is followed by the
+         *        average of itself and the pixel below it
+         * @param numSeamsToInsert: number of horizontal seams to insert
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void runSeamInserter(size_t numSeamsToInsert,
+                                     const cv::Mat& image,
+                                     cv::Mat& outImage) override;
+
+        /**
+         * @brief set the expected image dimensions
+         * @param numRows: image height
+         * @param numColumns: image width
+         */
+        virtual void setDimensions(size_t numRows, size_t numColumns) override;
+
+        using VerticalSeamCarver::setDimensions;
+
+        /**
+         * @brief incremental mode is not supported for horizontal seams
+         * @param bEnable: must be false
+         */
+        virtual void setIncrementalMode(bool bEnable) override;
+
+        // Deleted/defaulted functions
+        HorizontalSeamCarver(const HorizontalSeamCarver& rhs) = delete;
+        HorizontalSeamCarver(const HorizontalSeamCarver&& rhs) = delete;
+        virtual HorizontalSeamCarver& operator=(const HorizontalSeamCarver& rhs) = delete;
+        virtual HorizontalSeamCarver& operator=(const HorizontalSeamCarver&& rhs) = delete;
+
+    protected:
+        /**
+         * @brief calculates the pixel energy and the intensity used by forward energy, and
+         *        transposes them into the seam search layout
+         * @param image: input image
+         */
+        virtual void calculateEnergy(const cv::Mat& image) override;
+
+        /**
+         * @brief find then remove horizontal seams
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage) override;
+
+        /**
+         * @brief remove the discovered horizontal seams from image
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void removeHorizontalSeams(const cv::Mat& image, cv::Mat& outImage);
+
+        /**
+         * @brief find then insert horizontal seams
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage) override;
+
+        /**
+         * @brief duplicate the discovered horizontal seams of image into outImage
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void insertSeams(const cv::Mat& image, cv::Mat& outImage) override;
+
+        // pixel energy and intensity in image layout before they are transposed into
+        //      pixelEnergy and intensity (CV_32FC1)
+        cv::Mat imagePixelEnergy;
+        cv::Mat imageIntensity;
+
+        // next input row to copy for every image column while removing or inserting seams
+        std::vector<int32_t> sourceRows;
+
+        // non-zero for image columns whose last copied pixel was a seam pixel to duplicate
+        std::vector<uchar> bInsertPending;
+    };
+}
+
+#endif
@@ -70,10 +70,31 @@ namespace cv
         /**
          * @brief run the pixel energy calculation
          * @param image: 2D matrix representation of the image
+         * @param outPixelEnergy: output parameter CV_32FC1 matrix of computed pixel energies
+         *                        (written in place if it already has the right size and type)
+         */
+        virtual void calculatePixelEnergy(const cv::Mat& image, cv::Mat& outPixelEnergy) = 0;
+
+        /**
+         * @brief run the pixel energy calculation into a 2D vector
+         * @param image: 2D matrix representation of the image
          * @param outPixelEnergy: output parameter 2D vector of computed pixel energies
          */
-        virtual void calculatePixelEnergy(const cv::Mat& image,
-                                          std::vector<std::vector<double>>& outPixelEnergy) = 0;
+        void calculatePixelEnergy(const cv::Mat& image,
+                                  std::vector<std::vector<double>>& outPixelEnergy);
+
+        /**
+         * @brief recalculate the pixel energy inside a region of the image
+         * @param image: 2D matrix representation of the image
+         * @param region: region of the image whose pixel energy is recalculated
+         * @param outPixelEnergy: in/out parameter CV_32FC1 matrix of pixel energies with the same
+         *                        dimensions as image, only the region is overwritten
+         * @note the default implementation assumes the energy of a pixel only depends on its
+         *       immediate neighbours
+         */
+        virtual void calculatePixelEnergyForRegion(const cv::Mat& image,
+                                                   const cv::Rect& region,
+                                                   cv::Mat& outPixelEnergy);
 
         // Deleted/defaulted
         PixelEnergy2D(const PixelEnergy2D&) = delete;
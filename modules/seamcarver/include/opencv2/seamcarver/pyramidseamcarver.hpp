@@ -0,0 +1,185 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#ifndef OPENCV_SEAMCARVER_PYRAMIDSEAMCARVER_HPP
+#define OPENCV_SEAMCARVER_PYRAMIDSEAMCARVER_HPP
+
+#include <opencv2/core.hpp>
+#include "opencv2/seamcarver/verticalseamcarver.hpp"
+
+namespace cv
+{
+    /**
+     * Finds vertical seams coarse to fine on an image pyramid. The image is repeatedly halved
+     * by averaging 2x2 blocks, the seams are found on the coarsest level, and every seam is
+     * refined into two seams on the next finer level by only searching within corridorWidth
+     * columns of the upscaled coarse seam. The corridor width trades quality for speed: a wider
+     * corridor finds seams closer to the ones found without the pyramid, a narrower one sweeps
+     * fewer pixels. A seam is searched for in the whole level if its corridor is blocked.
+     */
+    class CV_EXPORTS PyramidSeamCarver : public VerticalSeamCarver
+    {
+    public:
+        /**
+         * @brief default ctor
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        PyramidSeamCarver(double marginEnergy = 390150.0,
+                          PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on dimensions
+         * @param numRows: image height
+         * @param numColumns: image width
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        PyramidSeamCarver(size_t numRows,
+                          size_t numColumns,
+                          double marginEnergy = 390150.0,
+                          PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on a sample image
+         * @param img: sample image
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        PyramidSeamCarver(const cv::Mat& img,
+                          double marginEnergy = 390150.0,
+                          PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief dtor
+         */
+        virtual ~PyramidSeamCarver();
+
+        /**
+         * @brief set the maximum number of pyramid levels including the full resolution image.
+         *        Fewer levels are used if a level would get too small for its seams
+         * @param numLevels: number of levels, 1 carves the full resolution image only
+         */
+        virtual void setNumLevels(size_t numLevels);
+
+        /**
+         * @brief returns the maximum number of pyramid levels
+         * @return size_t
+         */
+        virtual size_t getNumLevels() const;
+
+        /**
+         * @brief set how many columns a refined seam may move away from its upscaled coarse seam
+         * @param corridorWidth: half width of the corridor, larger is slower but closer to
+         *                       carving without the pyramid
+         */
+        virtual void setCorridorWidth(size_t corridorWidth);
+
+        /**
+         * @brief returns the half width of the refinement corridor
+         * @return size_t
+         */
+        virtual size_t getCorridorWidth() const;
+
+        /**
+         * @brief incremental mode is not supported on a pyramid
+         * @param bEnable: must be false
+         */
+        virtual void setIncrementalMode(bool bEnable) override;
+
+        // Deleted/defaulted functions
+        PyramidSeamCarver(const PyramidSeamCarver& rhs) = delete;
+        PyramidSeamCarver(const PyramidSeamCarver&& rhs) = delete;
+        virtual PyramidSeamCarver& operator=(const PyramidSeamCarver& rhs) = delete;
+        virtual PyramidSeamCarver& operator=(const PyramidSeamCarver&& rhs) = delete;
+
+    protected:
+        /**
+         * @brief find vertical seams coarse to fine, then remove them
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage) override;
+
+        /**
+         * @brief find vertical seams coarse to fine, then insert them
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage) override;
+
+        /**
+         * @brief build the pyramid and find numSeamsToRemove_ seams on every level, ending with
+         *        the discovered seams of the full resolution image
+         * @param image: input image
+         */
+        virtual void findSeamsCoarseToFine(const cv::Mat& image);
+
+        /**
+         * @brief point the working dimensions at one pyramid level. The working buffers keep
+         *        the full resolution size and the level uses their top left corner
+         * @param numRows: level height
+         * @param numColumns: level width
+         */
+        void setLevelDimensions(size_t numRows, size_t numColumns);
+
+        // maximum number of pyramid levels
+        size_t numLevels_ = 3;
+
+        // number of columns a refined seam may move away from its coarse seam
+        size_t corridorWidth_ = 4;
+
+        // pyramid levels below full resolution, levelImages[0] is unused
+        std::vector<cv::Mat> levelImages;
+        std::vector<cv::Mat> levelEnergyMaps;
+        std::vector<cv::Mat> levelEnergyWeights;
+
+        // seams found on the coarser level and on the current level
+        std::vector<std::vector<size_t>> coarseSeams;
+        std::vector<std::vector<size_t>> levelSeams;
+
+        // coarse seam scaled up to the current level
+        std::vector<size_t> guideSeam;
+    };
+}
+
+#endif
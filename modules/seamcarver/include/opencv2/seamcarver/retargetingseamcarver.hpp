@@ -0,0 +1,125 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#ifndef OPENCV_SEAMCARVER_RETARGETINGSEAMCARVER_HPP
+#define OPENCV_SEAMCARVER_RETARGETINGSEAMCARVER_HPP
+
+#include <opencv2/core.hpp>
+#include "opencv2/seamcarver/verticalseamcarver.hpp"
+#include "opencv2/seamcarver/horizontalseamcarver.hpp"
+
+namespace cv
+{
+    /**
+     * Shrinks an image in both dimensions by interleaving vertical and horizontal seams.
+     * The order of the seams is chosen with the transport map of Avidan & Shamir, "Seam Carving
+     * for Content-Aware Image Resizing": T(r, c) = min(T(r - 1, c) + E(horizontal seam),
+     * T(r, c - 1) + E(vertical seam)), where E is the cumulative energy of the seam removed from
+     * the image reached at that entry of the map. Only one row of the images reached by the map is
+     * kept; the choice of every entry is stored, and the seams of the optimal path are removed from
+     * the input image again in the order found by backtracking.
+     */
+    class CV_EXPORTS RetargetingSeamCarver
+    {
+    public:
+        /**
+         * @brief default ctor
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pVerticalPixelEnergyCalculator: pointer to a pixel energy calculator used for
+         *                                        vertical seams
+         * @param pHorizontalPixelEnergyCalculator: pointer to a pixel energy calculator used for
+         *                                          horizontal seams
+         */
+        RetargetingSeamCarver(double marginEnergy = 390150.0,
+                              PixelEnergy2D* pVerticalPixelEnergyCalculator = nullptr,
+                              PixelEnergy2D* pHorizontalPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief dtor
+         */
+        virtual ~RetargetingSeamCarver();
+
+        /**
+         * @brief shrink image to targetSize using the optimal order of vertical and horizontal
+         *        seams
+         * @param image: input image
+         * @param targetSize: size of the output image, no larger than image in either dimension
+         * @param outImage: output image parameter
+         */
+        virtual void retarget(const cv::Mat& image,
+                              const cv::Size& targetSize,
+                              cv::Mat& outImage);
+
+        /**
+         * @brief returns the order of the seams removed by the last retarget(), true for a
+         *        vertical seam and false for a horizontal seam
+         */
+        virtual const std::vector<bool>& getSeamOrder() const;
+
+        // Deleted/defaulted functions
+        RetargetingSeamCarver(const RetargetingSeamCarver& rhs) = delete;
+        RetargetingSeamCarver(const RetargetingSeamCarver&& rhs) = delete;
+        virtual RetargetingSeamCarver& operator=(const RetargetingSeamCarver& rhs) = delete;
+        virtual RetargetingSeamCarver& operator=(const RetargetingSeamCarver&& rhs) = delete;
+
+    protected:
+        // removes vertical seams
+        VerticalSeamCarver verticalSeamCarver_;
+
+        // removes horizontal seams
+        HorizontalSeamCarver horizontalSeamCarver_;
+
+        // images reached at one row of the transport map, updated in place entry by entry
+        std::vector<cv::Mat> transportImages;
+
+        // transport map cost at one row of the transport map, updated like transportImages
+        std::vector<double> transportCosts;
+
+        // true where the transport map entry was reached by removing a vertical seam, one row
+        //      of numColumnsToRemove + 1 entries per removed horizontal seam
+        std::vector<bool> bVerticalSeamChosen;
+
+        // seams removed by the last retarget() in order, true for vertical seams
+        std::vector<bool> seamOrder;
+    };
+}
+
+#endif
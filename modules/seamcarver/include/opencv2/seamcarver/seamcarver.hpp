@@ -61,6 +61,16 @@ namespace cv
         virtual void runSeamRemover(size_t numSeamsToRemove,
                                     const cv::Mat& image,
                                     cv::Mat& outImage) = 0;
+
+        /**
+         * @brief run the seam inserter algorithm (image enlargement)
+         * @param numSeamsToInsert: number of seams to insert
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void runSeamInserter(size_t numSeamsToInsert,
+                                     const cv::Mat& image,
+                                     cv::Mat& outImage) = 0;
     };
 }
 
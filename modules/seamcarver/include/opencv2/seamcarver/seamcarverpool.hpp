@@ -0,0 +1,157 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#ifndef OPENCV_SEAMCARVER_SEAMCARVERPOOL_HPP
+#define OPENCV_SEAMCARVER_SEAMCARVERPOOL_HPP
+
+#include <opencv2/core.hpp>
+#include "opencv2/seamcarver/verticalseamcarver.hpp"
+#include <mutex>
+#include <vector>
+
+namespace cv
+{
+    /**
+     * Thread safe pool of VerticalSeamCarver workspaces for services that carve many images of
+     * mixed sizes. Every run borrows an idle workspace (creating one if all are busy) and
+     * returns it afterwards, so the number of workspaces only grows to the number of concurrent
+     * runs. A workspace keeps the buffers of the largest image it has carved and reuses them for
+     * smaller images.
+     */
+    class CV_EXPORTS SeamCarverPool
+    {
+    public:
+        /**
+         * @brief default ctor
+         * @param marginEnergy: defines the edge pixel energy of every workspace
+         */
+        explicit SeamCarverPool(double marginEnergy = 390150.0);
+
+        /**
+         * @brief dtor
+         */
+        virtual ~SeamCarverPool();
+
+        /**
+         * @brief remove vertical seams from one image with a pooled workspace. Safe to call
+         *        from multiple threads
+         * @param numSeamsToRemove: number of vertical seams to remove
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void runSeamRemover(size_t numSeamsToRemove,
+                                    const cv::Mat& image,
+                                    cv::Mat& outImage);
+
+        /**
+         * @brief remove the same number of vertical seams from every image of a batch. The
+         *        images are carved concurrently on the OpenCV thread pool
+         * @param numSeamsToRemove: number of vertical seams to remove from every image
+         * @param images: input images, may have different sizes
+         * @param outImages: output parameter, one carved image per input image
+         */
+        virtual void runSeamRemover(size_t numSeamsToRemove,
+                                    const std::vector<cv::Mat>& images,
+                                    std::vector<cv::Mat>& outImages);
+
+        /**
+         * @brief remove a different number of vertical seams from every image of a batch. The
+         *        images are carved concurrently on the OpenCV thread pool
+         * @param numSeamsToRemove: number of vertical seams to remove from each image
+         * @param images: input images, may have different sizes
+         * @param outImages: output parameter, one carved image per input image
+         */
+        virtual void runSeamRemover(const std::vector<size_t>& numSeamsToRemove,
+                                    const std::vector<cv::Mat>& images,
+                                    std::vector<cv::Mat>& outImages);
+
+        /**
+         * @brief returns the number of workspaces created so far
+         * @return size_t
+         */
+        virtual size_t getNumWorkspaces() const;
+
+        /**
+         * @brief returns how many times the workspaces allocated working buffers, counted when
+         *        a run returns its workspace to the pool
+         * @return size_t
+         */
+        virtual size_t getNumAllocations() const;
+
+        // Deleted/defaulted functions
+        SeamCarverPool(const SeamCarverPool& rhs) = delete;
+        SeamCarverPool(const SeamCarverPool&& rhs) = delete;
+        virtual SeamCarverPool& operator=(const SeamCarverPool& rhs) = delete;
+        virtual SeamCarverPool& operator=(const SeamCarverPool&& rhs) = delete;
+
+    protected:
+        /**
+         * @brief take an idle workspace out of the pool, creating one if none are idle
+         * @return VerticalSeamCarver*
+         */
+        virtual VerticalSeamCarver* acquireWorkspace();
+
+        /**
+         * @brief return a workspace to the pool
+         * @param pWorkspace: workspace returned by acquireWorkspace()
+         * @param numNewAllocations: buffer allocations the workspace made while it was borrowed
+         */
+        virtual void releaseWorkspace(VerticalSeamCarver* pWorkspace, size_t numNewAllocations);
+
+        // every workspace created by the pool
+        std::vector<VerticalSeamCarver*> workspaces;
+
+        // workspaces not borrowed by a run, the most recently returned one is reused first
+        std::vector<VerticalSeamCarver*> idleWorkspaces;
+
+        // buffer allocations of all workspaces from runs that have returned
+        size_t numAllocations_ = 0;
+
+        // protects the workspace lists and the allocation counter
+        mutable std::mutex poolMutex;
+
+        // edge pixel energy of every workspace
+        const double marginEnergy_;
+    };
+}
+
+#endif
@@ -51,6 +51,21 @@ namespace cv
     class CV_EXPORTS VerticalSeamCarver : public SeamCarver
     {
     public:
+        /**
+         * @brief strategies to find multiple non-overlapping seams in one run
+         */
+        enum SeamSearchStrategy
+        {
+            // trace every seam from one cumulative energy calculation. A seam that runs into a
+            //      previous seam is restarted, and the cumulative energy is recalculated once
+            //      every pixel of the bottom row has been tried
+            SEAM_SEARCH_RESTART = 0,
+
+            // after every seam recalculate the cumulative energy only where it depended on the
+            //      seam's pixels, so every traced seam is valid and nothing is restarted
+            SEAM_SEARCH_CONE_UPDATE = 1
+        };
+
         /**
          * @brief default ctor
          * @param marginEnergy: defines the edge pixel energy
@@ -95,6 +110,24 @@ namespace cv
                                     const cv::Mat& image,
                                     cv::Mat& outImage) override;
 
+        /**
+         * @brief returns the sum of the cumulative energies of the seams removed by the last run
+         * @return double
+         */
+        virtual double getRemovedSeamsEnergy() const;
+
+        /**
+         * @brief run the vertical seam inserter algorithm. The numSeamsToInsert lowest energy
+         *        non-overlapping seams are found in one pass, then every seam pixel is followed
+         *        by the average of itself and its right neighbour
+         * @param numSeamsToInsert: number of vertical seams to insert
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void runSeamInserter(size_t numSeamsToInsert,
+                                     const cv::Mat& image,
+                                     cv::Mat& outImage) override;
+
         /**
          * @brief set the expected image dimensions
          * @param numRows: image height
@@ -120,6 +153,124 @@ namespace cv
          */
         virtual void setPixelEnergyCalculator(PixelEnergy2D* pNewPixelEnergyCalculator);
 
+        /**
+         * @brief use a precomputed energy map, e.g. a saliency map, instead of running the pixel
+         *        energy calculator on every image. In forward energy mode the map is added to
+         *        the forward energy costs
+         * @param newEnergyMap: single channel energy map with the size of the carved images,
+         *                      stored as CV_32FC1
+         */
+        virtual void setEnergyMap(const cv::Mat& newEnergyMap);
+
+        /**
+         * @brief go back to calculating pixel energy with the pixel energy calculator
+         */
+        virtual void clearEnergyMap();
+
+        /**
+         * @brief add per pixel weights to the pixel energy. Positive weights protect pixels,
+         *        negative weights attract seams. Weights added by multiple calls accumulate
+         * @param weights: single channel weights with the size of the carved images
+         */
+        virtual void addEnergyWeights(const cv::Mat& weights);
+
+        /**
+         * @brief add weight to the pixel energy of every non-zero pixel of mask so seams avoid
+         *        them. Masks may have any shape and may overlap
+         * @param mask: CV_8UC1 mask with the size of the carved images
+         * @param weight: energy added to the masked pixels
+         */
+        virtual void addProtectMask(const cv::Mat& mask, double weight);
+
+        /**
+         * @brief subtract weight from the pixel energy of every non-zero pixel of mask so seams
+         *        go through them first. Masks may have any shape and may overlap
+         * @param mask: CV_8UC1 mask with the size of the carved images
+         * @param weight: energy subtracted from the masked pixels
+         */
+        virtual void addRemoveMask(const cv::Mat& mask, double weight);
+
+        /**
+         * @brief remove all weights and masks
+         */
+        virtual void clearEnergyWeights();
+
+        /**
+         * @brief enable or disable the universal intrinsics cumulative path energy sweep
+         * @param bEnable: if false, the scalar reference implementation is used
+         */
+        virtual void setVectorization(bool bEnable);
+
+        /**
+         * @brief return true if the vectorized cumulative path energy sweep is used
+         * @return bool
+         */
+        virtual bool isVectorizationEnabled() const;
+
+        /**
+         * @brief set the number of column tiles the cumulative path energy sweep is split into
+         *        and run concurrently on the OpenCV thread pool (1 runs the serial sweep)
+         * @param numThreads: number of column tiles
+         */
+        virtual void setNumThreads(size_t numThreads);
+
+        /**
+         * @brief returns the number of column tiles used for the cumulative path energy sweep
+         * @return size_t
+         */
+        virtual size_t getNumThreads() const;
+
+        /**
+         * @brief enable or disable incremental seam removal. In incremental mode seams are
+         *        removed one at a time and after each removal only the pixel energy and
+         *        cumulative energy inside the seam's cone of influence are recalculated.
+         *        Every removal still shifts the pixels right of the seam in every row of the
+         *        image and the working buffers, so removing k seams moves O(k * rows * columns)
+         *        bytes; only the energy recalculation is limited to the cone of influence
+         * @param bEnable: true to enable incremental mode
+         */
+        virtual void setIncrementalMode(bool bEnable);
+
+        /**
+         * @brief return true if incremental mode is enabled
+         * @return bool
+         */
+        virtual bool isIncrementalModeEnabled() const;
+
+        /**
+         * @brief select how multiple non-overlapping seams are found in one run
+         * @param strategy: SEAM_SEARCH_RESTART (default) or SEAM_SEARCH_CONE_UPDATE
+         */
+        virtual void setSeamSearchStrategy(SeamSearchStrategy strategy);
+
+        /**
+         * @brief returns the strategy used to find multiple non-overlapping seams
+         * @return SeamSearchStrategy
+         */
+        virtual SeamSearchStrategy getSeamSearchStrategy() const;
+
+        /**
+         * @brief enable or disable the forward energy cost model. Instead of adding the energy
+         *        of the removed pixel, every step of a seam costs the intensity difference of
+         *        the pixels that become neighbours once the seam is removed, which reduces the
+         *        artifacts introduced into the carved image
+         * @param bEnable: true to use forward energy, false to use the pixel energy calculator
+         */
+        virtual void setForwardEnergy(bool bEnable);
+
+        /**
+         * @brief return true if the forward energy cost model is used
+         * @return bool
+         */
+        virtual bool isForwardEnergyEnabled() const;
+
+        /**
+         * @brief returns how many times working buffers were allocated. Buffers are sized to the
+         *        largest image seen and reused for smaller images
+         * @return size_t
+         */
+        virtual size_t getNumAllocations() const;
+
         // Deleted/defaulted functions
         VerticalSeamCarver(const VerticalSeamCarver& rhs) = delete;
         VerticalSeamCarver(const VerticalSeamCarver&& rhs) = delete;
@@ -166,6 +317,16 @@ namespace cv
          */
         virtual void resetLocalVectors();
 
+        /**
+         * @brief point outMat at a numRows x numColumns row aligned working buffer, reusing its
+         *        current allocation if that is large enough
+         * @param numRows: number of rows
+         * @param numColumns: number of columns
+         * @param type: matrix type
+         * @param outMat: in/out parameter, working buffer
+         */
+        void reserveWorkspaceMat(size_t numRows, size_t numColumns, int type, cv::Mat& outMat);
+
         /**
          * @brief find then remove remove vertical seams
          * @param image: input image
@@ -175,46 +336,156 @@ namespace cv
          */
         virtual void findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage);
 
+        /**
+         * @brief find then remove vertical seams one at a time, updating pixel energy and
+         *        cumulative energy incrementally after every removal
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndRemoveSeamsIncremental(const cv::Mat& image, cv::Mat& outImage);
+
+        /**
+         * @brief trace the least cumulative energy seam into currentSeam
+         */
+        virtual void findLeastEnergySeam();
+
+        /**
+         * @brief remove currentSeam from carvedImage and the working buffers, then recalculate
+         *        pixel energy and cumulative energy only where they could have changed. The
+         *        removal itself shifts the part of every row right of the seam one column left
+         */
+        virtual void removeSeamIncremental();
+
+        /**
+         * @brief find then insert vertical seams
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage);
+
+        /**
+         * @brief duplicate the discovered vertical seams of image into outImage
+         * @param image: input image
+         * @param outImage: output image parameter
+         */
+        virtual void insertSeams(const cv::Mat& image, cv::Mat& outImage);
+
+        /**
+         * @brief calculates the per pixel input of the cumulative path energy sweep, either the
+         *        intensity used by forward energy or the pixel energy
+         * @param image: input image
+         */
+        virtual void calculateEnergy(const cv::Mat& image);
+
+        /**
+         * @brief calculates intensity (forward energy only) and pixel energy in image layout,
+         *        applying an energy map and weights
+         * @param image: input image
+         * @param imageEnergyMap: energy map used instead of the pixel energy calculator, or empty
+         * @param imageEnergyWeights: weights added to the pixel energy, or empty
+         * @param outIntensity: output parameter, CV_32FC1 intensity
+         * @param outPixelEnergy: output parameter, CV_32FC1 pixel energy
+         */
+        void calculateImageLayoutEnergy(const cv::Mat& image,
+                                        const cv::Mat& imageEnergyMap,
+                                        const cv::Mat& imageEnergyWeights,
+                                        cv::Mat& outIntensity,
+                                        cv::Mat& outPixelEnergy);
+
+        /**
+         * @brief add weight to energyWeights for every non-zero pixel of mask
+         * @param mask: CV_8UC1 mask
+         * @param weight: weight to add, negative to attract seams
+         */
+        void addMaskWeight(const cv::Mat& mask, double weight);
+
         /**
          * @brief calculates the energy required to reach bottom row
          */
         virtual void calculateCumulativePathEnergy();
 
+        /**
+         * @brief calculates the cumulative energy for a range of columns in one row
+         * @param row: row to calculate, the row above it must already be calculated
+         * @param startColumn: first column to calculate
+         * @param endColumn: one past the last column to calculate
+         */
+        virtual void calculateCumulativePathEnergyRow(size_t row,
+                                                      size_t startColumn,
+                                                      size_t endColumn);
+
+        /**
+         * @brief calculates the cumulative energy using numThreads_ column tiles per band of rows
+         */
+        virtual void calculateCumulativePathEnergyParallel();
+
         /**
          * @brief find vertical seams for later removal
          */
         virtual void findSeams();
 
         /**
-         * @brief remove vertical seams from img
+         * @brief find vertical seams one at a time, updating the cumulative energy below every
+         *        seam (SEAM_SEARCH_CONE_UPDATE)
+         */
+        virtual void findSeamsWithConeUpdates();
+
+        /**
+         * @brief recalculate the cumulative energy that depended on the pixels of currentSeam
+         *        after they have been marked
+         */
+        virtual void updateCumulativePathEnergyBelowSeam();
+
+        /**
+         * @brief find the least cumulative energy seam within bandWidth columns of a guide seam,
+         *        e.g. the same seam in the previous video frame, calculating cumulative energy
+         *        only inside the band
+         * @param guideSeam: column of the guide seam in every row, may move any number of
+         *                   columns between rows
+         * @param bandWidth: number of columns the seam may move away from the guide seam
+         * @return true if a seam was found and stored in currentSeam, false if every path
+         *         through the band runs into a marked pixel
+         */
+        virtual bool findSeamInBand(const std::vector<size_t>& guideSeam, size_t bandWidth);
+
+        /**
+         * @brief queue currentSeam for removal and mark its pixels so later seams avoid them
+         */
+        virtual void addCurrentSeam();
+
+        /**
+         * @brief remove the discovered vertical seams from image, moving the runs of pixels
+         *        between seam columns with all channels at once. Any pixel type is supported.
+         *        If outImage is image the seams are removed in place and outImage becomes a
+         *        narrower view of the same data
+         * @param image: input image
+         * @param outImage: output image parameter
          */
-        virtual void removeSeams();
+        virtual void removeSeams(const cv::Mat& image, cv::Mat& outImage);
 
         // flag if internal data structures need their memory and values initialized
         bool bNeedToInitializeLocalData = true;
 
-        // vector to store pixels that have been previously markedPixels for removal
-        // will ignore these markedPixels pixels when searching for a new seam
-        std::vector<std::vector<bool>> markedPixels;
+        // pixels that have been previously marked for removal (CV_8UC1, non-zero if marked)
+        // will ignore these marked pixels when searching for a new seam
+        cv::Mat markedPixels;
 
-        // individual pixel energy
-        std::vector<std::vector<double>> pixelEnergy;
+        // individual pixel energy (CV_32FC1)
+        cv::Mat pixelEnergy;
 
         // vector of min oriented priority queues that store the location of the pixels to remove
         std::vector<cv::ConstSizeMinBinaryHeap<int32_t>> discoveredSeams;
 
-        // store cumulative energy to each pixel
-        std::vector<std::vector<double>> totalEnergyTo;
+        // store cumulative energy to each pixel (CV_32FC1)
+        cv::Mat totalEnergyTo;
 
         // store the location (column or row) of the previous pixel to get to the current pixel
-        std::vector<std::vector<int32_t>> previousLocationTo;
+        // (CV_32SC1)
+        cv::Mat previousLocationTo;
 
         // store the current seam being discovered
         std::vector<size_t> currentSeam;
 
-        // vector to hold image color channels separately
-        std::vector<cv::Mat> bgr;
-
         // image dimensions
         size_t numRows_ = 0;
         size_t numColumns_ = 0;
@@ -226,11 +497,60 @@ namespace cv
         size_t seamLength_ = 0;
 
         // value of positive infinity
-        double posInf_ = std::numeric_limits<double>::max();
+        float posInf_ = std::numeric_limits<float>::max();
+
+        // sum of the cumulative energies of the seams removed this run
+        double removedSeamsEnergy_ = 0.0;
 
-        // number of seams to remove (updated every run)
+        // number of seams to remove, or insert, (updated every run)
         size_t numSeamsToRemove_ = 0;
 
+        // use the universal intrinsics path when calculating cumulative path energy
+        bool bVectorizationEnabled_ = true;
+
+        // number of column tiles for the cumulative path energy sweep
+        size_t numThreads_ = 1;
+
+        // per tile double buffered cumulative energy (CV_32FC1) and parents (CV_32SC1) used by
+        //      calculateCumulativePathEnergyParallel()
+        cv::Mat tileTotalEnergyTo;
+        cv::Mat tilePreviousLocationTo;
+
+        // remove seams one at a time with incremental energy updates
+        bool bIncrementalModeEnabled_ = false;
+
+        // use the forward energy cost model instead of the pixel energy calculator
+        bool bForwardEnergyEnabled_ = false;
+
+        // pixel intensity used by the forward energy cost model (CV_32FC1)
+        cv::Mat intensity;
+
+        // add pixelEnergy to the cumulative energy, always true unless forward energy has
+        //      nothing to add to its costs
+        bool bAddPixelEnergy_ = true;
+
+        // precomputed pixel energy used instead of the pixel energy calculator (CV_32FC1)
+        cv::Mat energyMap;
+
+        // weights added to the pixel energy (CV_32FC1)
+        cv::Mat energyWeights;
+
+        // energy weights with the columns removed so far in incremental mode
+        cv::Mat carvedEnergyWeights;
+
+        // image being carved in incremental mode
+        cv::Mat carvedImage;
+
+        // strategy used by findSeams()
+        SeamSearchStrategy seamSearchStrategy_ = SEAM_SEARCH_RESTART;
+
+        // cumulative energy of a row before it was recalculated in incremental mode or by a
+        //      cone update
+        std::vector<float> previousTotalEnergyRow;
+
+        // number of times working buffers were allocated
+        size_t numAllocations_ = 0;
+
         // pointer to an object that calculates pixel energy
         cv::PixelEnergy2D* pPixelEnergyCalculator_ = nullptr;
 
@@ -0,0 +1,187 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#ifndef OPENCV_SEAMCARVER_VIDEOSEAMCARVER_HPP
+#define OPENCV_SEAMCARVER_VIDEOSEAMCARVER_HPP
+
+#include <opencv2/core.hpp>
+#include "opencv2/seamcarver/verticalseamcarver.hpp"
+
+namespace cv
+{
+    /**
+     * Removes vertical seams from a stream of frames of the same size. The seams of the previous
+     * frame are kept, and seam n of the next frame is only searched for within bandWidth columns
+     * of seam n of the previous frame, which keeps the seams temporally coherent and reduces the
+     * cumulative energy sweep to the band. If no seam fits inside the band, or there was no
+     * previous seam n, the whole frame is searched. Pixel energy is only recalculated for the
+     * tiles that changed since the previous frame.
+     */
+    class CV_EXPORTS VideoSeamCarver : public VerticalSeamCarver
+    {
+    public:
+        /**
+         * @brief default ctor
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        VideoSeamCarver(double marginEnergy = 390150.0,
+                        PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on dimensions
+         * @param numRows: frame height
+         * @param numColumns: frame width
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        VideoSeamCarver(size_t numRows,
+                        size_t numColumns,
+                        double marginEnergy = 390150.0,
+                        PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief ctor based on a sample frame
+         * @param img: sample frame
+         * @param marginEnergy: defines the edge pixel energy
+         * @param pNewPixelEnergyCalculator: pointer to a pixel energy calculator
+         */
+        VideoSeamCarver(const cv::Mat& img,
+                        double marginEnergy = 390150.0,
+                        PixelEnergy2D* pNewPixelEnergyCalculator = nullptr);
+
+        /**
+         * @brief dtor
+         */
+        virtual ~VideoSeamCarver();
+
+        /**
+         * @brief set how many columns a seam may move away from the same seam of the previous
+         *        frame
+         * @param bandWidth: half width of the search band
+         */
+        virtual void setBandWidth(size_t bandWidth);
+
+        /**
+         * @brief returns the half width of the search band
+         * @return size_t
+         */
+        virtual size_t getBandWidth() const;
+
+        /**
+         * @brief set the size of the square tiles compared against the previous frame to decide
+         *        which pixel energy needs to be recalculated
+         * @param tileSize: tile width and height in pixels
+         */
+        virtual void setTileSize(size_t tileSize);
+
+        /**
+         * @brief returns the size of the square tiles compared against the previous frame
+         * @return size_t
+         */
+        virtual size_t getTileSize() const;
+
+        /**
+         * @brief forget the previous frame and its seams, e.g. on a scene cut. The next frame is
+         *        carved from scratch
+         */
+        virtual void reset();
+
+        /**
+         * @brief incremental mode is not supported for video
+         * @param bEnable: must be false
+         */
+        virtual void setIncrementalMode(bool bEnable) override;
+
+        // Deleted/defaulted functions
+        VideoSeamCarver(const VideoSeamCarver& rhs) = delete;
+        VideoSeamCarver(const VideoSeamCarver&& rhs) = delete;
+        virtual VideoSeamCarver& operator=(const VideoSeamCarver& rhs) = delete;
+        virtual VideoSeamCarver& operator=(const VideoSeamCarver&& rhs) = delete;
+
+    protected:
+        /**
+         * @brief initilizes member data using frame dimensions and forgets the previous frame
+         * @param numRows: number of rows in the frame (height)
+         * @param numColumns: number of columns in the frame (width)
+         * @param seamLength: number of pixels per seam
+         */
+        virtual void init(size_t numRows, size_t numColumns, size_t seamLength) override;
+
+        using VerticalSeamCarver::init;
+
+        /**
+         * @brief calculates the pixel energy of the tiles that changed since the previous frame
+         * @param image: input frame
+         */
+        virtual void calculateEnergy(const cv::Mat& image) override;
+
+        /**
+         * @brief find vertical seams inside the bands around the previous frame's seams
+         */
+        virtual void findSeams() override;
+
+        /**
+         * @brief queue currentSeam for removal and remember it for the next frame
+         */
+        virtual void addCurrentSeam() override;
+
+        // number of columns a seam may move between frames
+        size_t bandWidth_ = 8;
+
+        // size of the tiles compared against the previous frame
+        size_t tileSize_ = 64;
+
+        // previous frame, only the tiles that changed are copied into it (empty if none)
+        cv::Mat previousFrame;
+
+        // seams of the previous frame in the order they were found, and of the current frame
+        std::vector<std::vector<size_t>> previousSeams;
+        std::vector<std::vector<size_t>> currentSeams;
+
+        // number of valid entries in previousSeams and currentSeams
+        size_t numPreviousSeams_ = 0;
+        size_t numCurrentSeams_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,211 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        // every stage of the vertical seam remover is timed on its own, so the stage that
+        //      dominates runSeamRemover() can be tracked per image size, channel count and
+        //      number of seams
+
+        const Size sz8K(7680, 4320);
+
+        /**
+         * Exposes the stages of VerticalSeamCarver::runSeamRemover() one at a time
+         */
+        class VerticalSeamCarverStages : public VerticalSeamCarver
+        {
+        public:
+            explicit VerticalSeamCarverStages(const Mat& image) : VerticalSeamCarver(image) {}
+
+            void resetForSeams(size_t numSeams)
+            {
+                numSeamsToRemove_ = numSeams;
+                resetLocalVectors();
+            }
+
+            void runEnergy(const Mat& image)
+            {
+                calculateEnergy(image);
+            }
+
+            void runSweep()
+            {
+                calculateCumulativePathEnergy();
+            }
+
+            void runTrace()
+            {
+                findLeastEnergySeam();
+            }
+
+            void runSeamSearch()
+            {
+                findSeams();
+            }
+
+            void runRemoval(const Mat& image, Mat& outImage)
+            {
+                removeSeams(image, outImage);
+            }
+        };
+
+        typedef tuple<Size, int> SeamCarverEnergyParams;
+        typedef TestBaseWithParam<SeamCarverEnergyParams> SeamCarverEnergyPerfTest;
+
+        PERF_TEST_P(SeamCarverEnergyPerfTest, calculateEnergy,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p, sz8K),
+                                     testing::Values(1, 3)))
+        {
+            Size imageSize = get<0>(GetParam());
+            int numChannels = get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC(numChannels));
+
+            declare.in(image, WARMUP_RNG);
+
+            VerticalSeamCarverStages stages(image);
+
+            TEST_CYCLE()
+            {
+                stages.runEnergy(image);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, bool> SeamCarverSweepParams;
+        typedef TestBaseWithParam<SeamCarverSweepParams> SeamCarverSweepPerfTest;
+
+        PERF_TEST_P(SeamCarverSweepPerfTest, calculateCumulativePathEnergy,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p, sz8K),
+                                     testing::Bool()))
+        {
+            Size imageSize = get<0>(GetParam());
+            bool bVectorize = get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+
+            declare.in(image, WARMUP_RNG);
+
+            VerticalSeamCarverStages stages(image);
+            stages.setVectorization(bVectorize);
+            stages.resetForSeams(1);
+            stages.runEnergy(image);
+
+            TEST_CYCLE()
+            {
+                stages.runSweep();
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, int> SeamCarverTraceParams;
+        typedef TestBaseWithParam<SeamCarverTraceParams> SeamCarverTracePerfTest;
+
+        PERF_TEST_P(SeamCarverTracePerfTest, findLeastEnergySeam,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p, sz8K),
+                                     testing::Values(1, 16, 64)))
+        {
+            Size imageSize = get<0>(GetParam());
+            int numSeams = get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+
+            declare.in(image, WARMUP_RNG);
+
+            VerticalSeamCarverStages stages(image);
+            stages.resetForSeams(1);
+            stages.runEnergy(image);
+            stages.runSweep();
+
+            // bottom row search and walk up the parents only, the cumulative energy is reused
+            TEST_CYCLE()
+            {
+                for (int n = 0; n < numSeams; n++)
+                {
+                    stages.runTrace();
+                }
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, int, int> SeamCarverRemovalParams;
+        typedef TestBaseWithParam<SeamCarverRemovalParams> SeamCarverRemovalPerfTest;
+
+        PERF_TEST_P(SeamCarverRemovalPerfTest, removeSeams,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p, sz8K),
+                                     testing::Values(1, 3),
+                                     testing::Values(1, 16, 64)))
+        {
+            Size imageSize = get<0>(GetParam());
+            int numChannels = get<1>(GetParam());
+            size_t numSeams = (size_t)get<2>(GetParam());
+
+            Mat image(imageSize, CV_8UC(numChannels));
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarverStages stages(image);
+            stages.runEnergy(image);
+
+            // removal consumes the discovered seams, so they are found again untimed
+            while (next())
+            {
+                stages.resetForSeams(numSeams);
+                stages.runSeamSearch();
+
+                startTimer();
+                stages.runRemoval(image, outImage);
+                stopTimer();
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+    }
+}
@@ -0,0 +1,189 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        // compare against a previous build with:
+        //   ./bin/opencv_perf_seamcarver --gtest_output=xml:new.xml
+        //   python modules/ts/misc/summary.py old.xml new.xml
+        typedef tuple<Size, int> VerticalSeamCarverParams;
+        typedef TestBaseWithParam<VerticalSeamCarverParams> VerticalSeamCarverPerfTest;
+
+        PERF_TEST_P(VerticalSeamCarverPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p),
+                                     testing::Values(1, 16)))
+        {
+            Size imageSize = get<0>(GetParam());
+            size_t numSeamsToRemove = (size_t)get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarver vSeamCarver(image);
+
+            TEST_CYCLE()
+            {
+                vSeamCarver.runSeamRemover(numSeamsToRemove, image, outImage);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, int> VerticalSeamCarverIncrementalParams;
+        typedef TestBaseWithParam<VerticalSeamCarverIncrementalParams>
+            VerticalSeamCarverIncrementalPerfTest;
+
+        PERF_TEST_P(VerticalSeamCarverIncrementalPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(szVGA, sz1080p),
+                                     testing::Values(16, 128)))
+        {
+            Size imageSize = get<0>(GetParam());
+            size_t numSeamsToRemove = (size_t)get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarver vSeamCarver(image);
+            vSeamCarver.setIncrementalMode(true);
+
+            TEST_CYCLE()
+            {
+                vSeamCarver.runSeamRemover(numSeamsToRemove, image, outImage);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, int> VerticalSeamCarverThreadsParams;
+        typedef TestBaseWithParam<VerticalSeamCarverThreadsParams>
+            VerticalSeamCarverThreadsPerfTest;
+
+        PERF_TEST_P(VerticalSeamCarverThreadsPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(sz2160p, Size(8192, 2048)),
+                                     testing::Values(1, 2, 4, 8, 16)))
+        {
+            Size imageSize = get<0>(GetParam());
+            size_t numThreads = (size_t)get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarver vSeamCarver(image);
+            vSeamCarver.setNumThreads(numThreads);
+
+            TEST_CYCLE()
+            {
+                vSeamCarver.runSeamRemover(1, image, outImage);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, bool> VerticalSeamCarverForwardEnergyParams;
+        typedef TestBaseWithParam<VerticalSeamCarverForwardEnergyParams>
+            VerticalSeamCarverForwardEnergyPerfTest;
+
+        PERF_TEST_P(VerticalSeamCarverForwardEnergyPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(szVGA, sz1080p, sz2160p),
+                                     testing::Bool()))
+        {
+            Size imageSize = get<0>(GetParam());
+            bool bForwardEnergy = get<1>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarver vSeamCarver(image);
+            vSeamCarver.setForwardEnergy(bForwardEnergy);
+
+            TEST_CYCLE()
+            {
+                vSeamCarver.runSeamRemover(16, image, outImage);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+
+        typedef tuple<Size, int, int> VerticalSeamCarverStrategyParams;
+        typedef TestBaseWithParam<VerticalSeamCarverStrategyParams>
+            VerticalSeamCarverStrategyPerfTest;
+
+        PERF_TEST_P(VerticalSeamCarverStrategyPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(szVGA, sz1080p),
+                                     testing::Values(16, 128),
+                                     testing::Values(
+                                         (int)VerticalSeamCarver::SEAM_SEARCH_RESTART,
+                                         (int)VerticalSeamCarver::SEAM_SEARCH_CONE_UPDATE)))
+        {
+            Size imageSize = get<0>(GetParam());
+            size_t numSeamsToRemove = (size_t)get<1>(GetParam());
+            VerticalSeamCarver::SeamSearchStrategy strategy =
+                (VerticalSeamCarver::SeamSearchStrategy)get<2>(GetParam());
+
+            Mat image(imageSize, CV_8UC3);
+            Mat outImage;
+
+            declare.in(image, WARMUP_RNG).out(outImage);
+
+            VerticalSeamCarver vSeamCarver(image);
+            vSeamCarver.setSeamSearchStrategy(strategy);
+
+            TEST_CYCLE()
+            {
+                vSeamCarver.runSeamRemover(numSeamsToRemove, image, outImage);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "perf_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        typedef tuple<Size, int> VideoSeamCarverParams;
+        typedef TestBaseWithParam<VideoSeamCarverParams> VideoSeamCarverPerfTest;
+
+        PERF_TEST_P(VideoSeamCarverPerfTest, runSeamRemover,
+                    testing::Combine(testing::Values(szVGA, sz1080p),
+                                     testing::Values(4, 16)))
+        {
+            Size frameSize = get<0>(GetParam());
+            size_t bandWidth = (size_t)get<1>(GetParam());
+
+            Mat frame(frameSize, CV_8UC3);
+            Mat outFrame;
+
+            declare.in(frame, WARMUP_RNG).out(outFrame);
+
+            VideoSeamCarver videoSeamCarver(frame);
+            videoSeamCarver.setBandWidth(bandWidth);
+
+            // carve the first frame outside of the measured cycles so every cycle follows seams
+            videoSeamCarver.runSeamRemover(16, frame, outFrame);
+
+            // only a small region changes between frames
+            Rect changingRegion(0, frameSize.height / 2,
+                                frameSize.width / 16, frameSize.height / 16);
+            uchar changingValue = 0;
+
+            TEST_CYCLE()
+            {
+                frame(changingRegion).setTo(Scalar::all(changingValue++));
+                videoSeamCarver.runSeamRemover(16, frame, outFrame);
+            }
+
+            SANITY_CHECK_NOTHING();
+        }
+    }
+}
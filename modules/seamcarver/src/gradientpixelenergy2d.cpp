@@ -40,425 +40,257 @@
 //M*/
 
 #include "opencv2/seamcarver/gradientpixelenergy2d.hpp"
-#include <thread>
-using std::vector;
+#include "opencv2/core/hal/intrin.hpp"
+#include <algorithm>
 
-cv::GradientPixelEnergy2D::GradientPixelEnergy2D(double marginEnergy) : marginEnergy_(marginEnergy)
-{}
-
-cv::GradientPixelEnergy2D::~GradientPixelEnergy2D() {}
-
-void cv::GradientPixelEnergy2D::calculatePixelEnergy(const cv::Mat& image,
-                                                     vector<vector<double>>& outPixelEnergy)
+namespace cv
 {
-    // check for empty image
-    if (image.empty())
+    namespace
     {
-        CV_Error(Error::Code::StsBadArg,
-                 "GradientPixelEnergy2D::calculatePixelEnergyForEveryRow() failed due to empty image");
-    }
-
-    numRows_ = (size_t)image.rows;
-    numColumns_ = (size_t)image.cols;
-    bottomRow_ = numRows_ - 1;
-    rightColumn_ = numColumns_ - 1;
-    numColorChannels_ = (size_t)image.channels();
-
-
-    // ensure outPixelEnergy has the right dimensions (resize locally if necessary)
-    if (!(outPixelEnergy.size() == numRows_))
-    {
-        outPixelEnergy.resize(numRows_);
-    }
-    for (size_t row = 0; row < numRows_; row++)
-    {
-        if (!(outPixelEnergy[row].size() == numColumns_))
+        // every parallel tile covers at least this many pixels so small images aren't split
+        //      into more tiles than there is work
+        const size_t minPixelsPerTile = 1 << 16;
+
+        /**
+         * @brief scalar dual gradient energy for columns [startColumn, endColumn) of an interior
+         *        row, read straight from interleaved pixels
+         */
+        template<typename _Tp>
+        void gradientEnergyRowScalar(const _Tp* pRowAbove,
+                                     const _Tp* pRow,
+                                     const _Tp* pRowBelow,
+                                     float* pPixelEnergyRow,
+                                     size_t startColumn,
+                                     size_t endColumn,
+                                     size_t numChannels)
         {
-            outPixelEnergy[row].resize(numColumns_);
-        }
-    }
-
-    // if more columns, split calculation into 2 operations to calculate for every row
-    if (numColumns_ >= numRows_)
-    {
-        std::thread thread1(&cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryRow,
-                            this, std::ref(image),
-                            std::ref(outPixelEnergy),
-                            true);
-        std::thread thread2(&cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryRow,
-                            this, std::ref(image),
-                            std::ref(outPixelEnergy),
-                            false);
-        while (!thread1.joinable());
-        thread1.join();
-        while (!thread2.joinable());
-        thread2.join();
-    }
-    // otherwise, if more rows, split calculation into 2 operations to calculate for every column
-    else
-    {
-        std::thread thread1(&cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryColumn,
-                            this, std::ref(image),
-                            std::ref(outPixelEnergy),
-                            true);
-        std::thread thread2(&cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryColumn,
-                            this, std::ref(image),
-                            std::ref(outPixelEnergy),
-                            false);
-        while (!thread1.joinable());
-        thread1.join();
-        while (!thread2.joinable());
-        thread2.join();
-    }
+            for (size_t column = startColumn; column < endColumn; column++)
+            {
+                const size_t offset = column * numChannels;
+                double deltaSquareX = 0.0;
+                double deltaSquareY = 0.0;
 
-    if (threadExceptionPtr)
-    {
-        std::rethrow_exception(threadExceptionPtr);
-    }
-}
+                for (size_t channel = 0; channel < numChannels; channel++)
+                {
+                    double deltaX = (double)pRow[offset + numChannels + channel] -
+                                    (double)pRow[offset - numChannels + channel];
+                    double deltaY = (double)pRowBelow[offset + channel] -
+                                    (double)pRowAbove[offset + channel];
 
-void cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryRow(
-    const cv::Mat& image,
-    vector<vector<double>>& outPixelEnergy,
-    bool bDoOddColumns)
-{
-    try
-    {
-        vector<cv::Mat> imageByChannel;
-        imageByChannel.resize(numColorChannels_);
+                    deltaSquareX += deltaX * deltaX;
+                    deltaSquareY += deltaY * deltaY;
+                }
 
-        // if color channels use cv::split
-        // otherwise if grayscale use cv::extractChannel
-        if (numColorChannels_ == 3)
-        {
-            cv::split(image, imageByChannel);
-        }
-        else if (numColorChannels_ == 1)
-        {
-            cv::extractChannel(image, imageByChannel[0], 0);
+                pPixelEnergyRow[column] = (float)(deltaSquareX + deltaSquareY);
+            }
         }
-        else
+
+#if CV_SIMD
+        /**
+         * @brief add the squared differences of two 8 bit vectors to four 32 bit accumulators
+         */
+        inline void accumulateSquaredDifference(const v_uint8& a, const v_uint8& b, v_int32* pSum)
         {
-            CV_Error(Error::Code::StsBadArg,
-                     "GradientPixelEnergy2D::calculatePixelEnergyForEveryRow() failed due to \
-                      incorrect number of channels");
+            v_uint16 a0, a1, b0, b1;
+            v_expand(a, a0, a1);
+            v_expand(b, b0, b1);
+
+            v_int16 delta0 = v_reinterpret_as_s16(a0) - v_reinterpret_as_s16(b0);
+            v_int16 delta1 = v_reinterpret_as_s16(a1) - v_reinterpret_as_s16(b1);
+
+            v_int32 square0, square1;
+            v_mul_expand(delta0, delta0, square0, square1);
+            pSum[0] += square0;
+            pSum[1] += square1;
+            v_mul_expand(delta1, delta1, square0, square1);
+            pSum[2] += square0;
+            pSum[3] += square1;
         }
 
-        // Establish vectors whose size is equal to the number of channels
-        // Two vectors used to compute X gradient
-          // Don't need them for Y since we are only caching the columns
-          // We can just access the pixel values above/below directly to compute the delta
-        // TODO replace vectors with a multidimensional vector
-        vector<double> xDirection2;
-        vector<double> xDirection1;
-
-        xDirection2.resize(numColorChannels_);
-        xDirection1.resize(numColorChannels_);
-
-        vector<double> deltaXDirection;
-        vector<double> deltaYDirection;
-
-        deltaXDirection.resize(numColorChannels_);
-        deltaYDirection.resize(numColorChannels_);
-
-        double deltaSquareX = 0.0;
-        double deltaSquareY = 0.0;
-
-        size_t column = 0;
-        // compute energy for every row
-        // do odd columns and even columns separately in order to leverage cached values to prevent
-            // multiple memory accesses
-        for (size_t row = 0; row < numRows_; row++)
+        /**
+         * @brief load v_uint8::nlanes interleaved pixels into one vector per channel
+         */
+        inline void loadChannels(const uchar* pPixels, size_t numChannels, v_uint8* pChannels)
         {
-            /***** ODD COLUMNS *****/
-            if (bDoOddColumns)
+            if (numChannels == 3)
             {
-                // initialize starting column
-                column = 1;
-
-                // initialize color values to the left of current pixel
-                for (size_t channel = 0; channel < numColorChannels_; channel++)
-                {
-                    xDirection1[channel] = imageByChannel[channel].at<uchar>(row, column - 1);
-                }
-
-                // Compute energy of odd columns
-                for (/* column already initialized */;
-                     column < numColumns_; column += 2)
-                {
-                    if (row == 0 || column == 0 || row == bottomRow_ || column == rightColumn_)
-                    {
-                        outPixelEnergy[row][column] = marginEnergy_;
-                    }
-                    else
-                    {
-                        // Reset gradients from previous calculation
-                        deltaSquareX = 0.0;
-                        deltaSquareY = 0.0;
-
-                        // For all channels:
-                          // Compute gradients
-                          // Compute overall energy by summing both X and Y gradient
-                        for (size_t channel = 0;
-                             channel < numColorChannels_; channel++)
-                        {
-                            // get new values to the right
-                            xDirection2[channel] = imageByChannel[channel].at<uchar>(row,
-                                                                                     column + 1);
-
-                            deltaXDirection[channel] = xDirection2[channel] - xDirection1[channel];
-
-                            deltaSquareX += deltaXDirection[channel] * deltaXDirection[channel];
-
-                            deltaYDirection[channel] =
-                                imageByChannel[channel].at<uchar>(row + 1, column) -
-                                imageByChannel[channel].at<uchar>(row - 1, column);
-
-                            deltaSquareY += deltaYDirection[channel] * deltaYDirection[channel];
-
-                            // shift color values to the left
-                            xDirection1[channel] = xDirection2[channel];
-                        }
-                        outPixelEnergy[row][column] = deltaSquareX + deltaSquareY;
-                    }
-                }
+                v_load_deinterleave(pPixels, pChannels[0], pChannels[1], pChannels[2]);
             }
-            /***** EVEN COLUMNS *****/
             else
             {
-                // initialize starting column
-                column = 0;
+                pChannels[0] = vx_load(pPixels);
+            }
+        }
 
-                // initialize color values to the right of current pixel
-                for (size_t Channel = 0; Channel < numColorChannels_; Channel++)
+        /**
+         * @brief vectorized dual gradient energy for columns of an interior 8 bit row
+         * @note endColumn must be at most numColumns - 1 so the right neighbour loads stay inside
+         *       the row. Squares are summed exactly in 32 bit integers, so the results are
+         *       bit-identical to the scalar path.
+         * @return first column that was not calculated (less than v_uint8::nlanes from endColumn)
+         */
+        size_t gradientEnergyRowSIMD(const uchar* pRowAbove,
+                                     const uchar* pRow,
+                                     const uchar* pRowBelow,
+                                     float* pPixelEnergyRow,
+                                     size_t startColumn,
+                                     size_t endColumn,
+                                     size_t numChannels)
+        {
+            const size_t numLanes = (size_t)v_uint8::nlanes;
+            const size_t numSumLanes = (size_t)v_int32::nlanes;
+
+            v_uint8 left[3], right[3], above[3], below[3];
+
+            size_t column = startColumn;
+            for (; column + numLanes <= endColumn; column += numLanes)
+            {
+                const size_t offset = column * numChannels;
+                loadChannels(pRow + offset - numChannels, numChannels, left);
+                loadChannels(pRow + offset + numChannels, numChannels, right);
+                loadChannels(pRowAbove + offset, numChannels, above);
+                loadChannels(pRowBelow + offset, numChannels, below);
+
+                v_int32 sum[4] = { vx_setzero_s32(), vx_setzero_s32(),
+                                   vx_setzero_s32(), vx_setzero_s32() };
+                for (size_t channel = 0; channel < numChannels; channel++)
                 {
-                    xDirection2[Channel] = imageByChannel[Channel].at<uchar>(row, column + 1);
+                    accumulateSquaredDifference(right[channel], left[channel], sum);
+                    accumulateSquaredDifference(below[channel], above[channel], sum);
                 }
 
-                // Compute energy of odd columns
-                for (/* column already initialized */;
-                     column < numColumns_; column += 2)
+                for (size_t part = 0; part < 4; part++)
                 {
-                    if (row == 0 || column == 0 || row == bottomRow_ || column == rightColumn_)
-                    {
-                        outPixelEnergy[row][column] = marginEnergy_;
-                    }
-                    else
-                    {
-                        // Reset gradient from previous calculation
-                        deltaSquareX = 0.0;
-                        deltaSquareY = 0.0;
-
-                        // For all channels:
-                          // Compute gradients
-                          // Compute overall energy by summing both X and Y gradient
-                        for (size_t channel = 0;
-                             channel < numColorChannels_; channel++)
-                        {
-                            // shift color values to the left
-                            xDirection1[channel] = xDirection2[channel];
-
-                            // get new values to the right
-                            xDirection2[channel] = imageByChannel[channel].at<uchar>(row,
-                                                                                     column + 1);
-                            deltaXDirection[channel] = xDirection2[channel] - xDirection1[channel];
-
-                            deltaSquareX += deltaXDirection[channel] * deltaXDirection[channel];
-
-                            deltaYDirection[channel] =
-                                imageByChannel[channel].at<uchar>(row + 1, column) -
-                                imageByChannel[channel].at<uchar>(row - 1, column);
-
-                            deltaSquareY += deltaYDirection[channel] * deltaYDirection[channel];
-                        }
-                        outPixelEnergy[row][column] = deltaSquareX + deltaSquareY;
-                    }
+                    v_store(pPixelEnergyRow + column + part * numSumLanes, v_cvt_f32(sum[part]));
                 }
             }
-        }
-    }
-    catch (...)
-    {
-        // save first instance of exception only
-        threadExceptionPtrMutex.lock();
 
-        if (threadExceptionPtr == nullptr)
-        {
-            threadExceptionPtr = std::current_exception();
+            return column;
         }
-
-        threadExceptionPtrMutex.unlock();
+#endif
     }
 }
 
-void cv::GradientPixelEnergy2D::calculatePixelEnergyForEveryColumn(
-    const cv::Mat& image,
-    vector<vector<double>>& outPixelEnergy,
-    bool bDoOddRows)
+cv::GradientPixelEnergy2D::GradientPixelEnergy2D(double marginEnergy) :
+    PixelEnergy2D(marginEnergy)
+{}
+
+cv::GradientPixelEnergy2D::~GradientPixelEnergy2D() {}
+
+void cv::GradientPixelEnergy2D::calculatePixelEnergy(const cv::Mat& image,
+                                                     cv::Mat& outPixelEnergy)
 {
-    try
+    // check for empty image
+    if (image.empty())
     {
-        vector<cv::Mat> imageByChannel;
-        imageByChannel.resize(numColorChannels_);
+        CV_Error(Error::Code::StsBadArg,
+                 "GradientPixelEnergy2D::calculatePixelEnergy() failed due to empty image");
+    }
 
-        // if color channels use cv::split
-        // otherwise if grayscale use cv::extractChannel
-        if (numColorChannels_ == 3)
-        {
-            cv::split(image, imageByChannel);
-        }
-        else if (numColorChannels_ == 1)
-        {
-            cv::extractChannel(image, imageByChannel[0], 0);
-        }
-        else
-        {
-            CV_Error(Error::Code::StsBadArg,
-                     "GradientPixelEnergy2D::calculatePixelEnergyForEveryColumn() failed due to \
-                      incorrect number of channels");
-        }
+    if (image.channels() != 3 && image.channels() != 1)
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "GradientPixelEnergy2D::calculatePixelEnergy() failed due to incorrect number of \
+                  channels");
+    }
 
-        // Establish vectors whose size is equal to the number of channels
-        // Two vectors used to compute X gradient
-          // Don't need them for Y since we are only caching the columns
-          // We can just access the pixel values above/below directly to compute the delta
-        // TODO replace vectors with a multidimensional vector
-        vector<double> yDirection2;
-        vector<double> yDirection1;
+    if (image.depth() != CV_8U && image.depth() != CV_16U && image.depth() != CV_32F)
+    {
+        CV_Error(Error::Code::StsUnsupportedFormat,
+                 "GradientPixelEnergy2D::calculatePixelEnergy() failed due to unsupported depth");
+    }
 
-        yDirection2.resize(numColorChannels_);
-        yDirection1.resize(numColorChannels_);
+    // ensure outPixelEnergy has the right dimensions (no-op if caller already allocated it)
+    outPixelEnergy.create(image.rows, image.cols, CV_32FC1);
 
-        vector<double> deltaXDirection;
-        vector<double> deltaYDirection;
+    // split the rows into tiles of roughly minPixelsPerTile pixels for the thread pool
+    const size_t numRows = (size_t)image.rows;
+    const size_t numPixels = numRows * (size_t)image.cols;
+    const double numTiles = (double)std::max((size_t)1,
+                                             std::min(numRows, numPixels / minPixelsPerTile));
 
-        deltaXDirection.resize(numColorChannels_);
-        deltaYDirection.resize(numColorChannels_);
+    cv::parallel_for_(cv::Range(0, image.rows), [&](const cv::Range& range)
+    {
+        calculatePixelEnergyForRows(image, (size_t)range.start, (size_t)range.end,
+                                    outPixelEnergy);
+    }, numTiles);
+}
 
-        double deltaSquareX = 0.0;
-        double deltaSquareY = 0.0;
+void cv::GradientPixelEnergy2D::setVectorization(bool bEnable)
+{
+    bVectorizationEnabled_ = bEnable;
+}
 
-        size_t row = 0;
-        // compute energy for every column
-        // do odd rows and even rows separately in order to leverage cached values
-            // to prevent multiple memory accesses
-        for (size_t column = 0; column < numColumns_; column++)
-        {
-            /***** ODD ROWS *****/
-            if (bDoOddRows)
-            {
-                // initialize starting row
-                row = 1;
+bool cv::GradientPixelEnergy2D::isVectorizationEnabled() const
+{
+    return bVectorizationEnabled_;
+}
 
-                // initialize color values above the current pixel
-                for (size_t channel = 0; channel < numColorChannels_; channel++)
-                {
-                    yDirection1[channel] = imageByChannel[channel].at<uchar>(row - 1, column);
-                }
+void cv::GradientPixelEnergy2D::calculatePixelEnergyForRows(const cv::Mat& image,
+                                                            size_t startRow,
+                                                            size_t endRow,
+                                                            cv::Mat& outPixelEnergy) const
+{
+    const size_t numRows = (size_t)image.rows;
+    const size_t numColumns = (size_t)image.cols;
+    const size_t bottomRow = numRows - 1;
+    const size_t rightColumn = numColumns - 1;
+    const size_t numChannels = (size_t)image.channels();
+    const float marginEnergy = (float)marginEnergy_;
+
+    for (size_t row = startRow; row < endRow; row++)
+    {
+        float* pPixelEnergyRow = outPixelEnergy.ptr<float>((int)row);
 
-                // Compute energy of odd rows
-                for (/* row was already initialized */; row < numRows_; row += 2)
-                {
-                    if (row == 0 || column == 0 || row == bottomRow_ || column == rightColumn_)
-                    {
-                        outPixelEnergy[row][column] = marginEnergy_;
-                    }
-                    else
-                    {
-                        // Reset gradients from previous calculation
-                        deltaSquareX = 0.0;
-                        deltaSquareY = 0.0;
-
-                        // For all channels:
-                          // Compute gradients
-                          // Compute overall energy by summing both X and Y gradient
-                        for (size_t channel = 0;
-                             channel < numColorChannels_; channel++)
-                        {
-                            // get new values below the current pixel
-                            yDirection2[channel] = imageByChannel[channel].at<uchar>(row + 1,
-                                                                                     column);
-
-                            deltaYDirection[channel] = yDirection2[channel] - yDirection1[channel];
-
-                            deltaSquareY = deltaYDirection[channel] * deltaYDirection[channel];
-
-                            deltaXDirection[channel] =
-                                imageByChannel[channel].at<uchar>(row, column + 1) -
-                                imageByChannel[channel].at<uchar>(row, column - 1);
-
-                            deltaSquareX += deltaXDirection[channel] * deltaXDirection[channel];
-
-                            // shift color values up
-                            yDirection1[channel] = yDirection2[channel];
-                        }
-                        outPixelEnergy[row][column] = deltaSquareX + deltaSquareY;
-                    }
-                }
-            }
-            /***** EVEN ROWS *****/
-            else
-            {
-                // initialize starting row
-                row = 0;
+        // the top and bottom rows, and images less than 3 columns wide, are all margin
+        if (row == 0 || row == bottomRow || numColumns < 3)
+        {
+            std::fill(pPixelEnergyRow, pPixelEnergyRow + numColumns, marginEnergy);
+            continue;
+        }
 
-                // initialize color values below the current pixel
-                for (size_t channel = 0; channel < numColorChannels_; channel++)
-                {
-                    yDirection2[channel] = imageByChannel[channel].at<uchar>(row + 1, column);
-                }
+        pPixelEnergyRow[0] = marginEnergy;
+        pPixelEnergyRow[rightColumn] = marginEnergy;
 
-                // Compute energy of odd rows
-                for (/* row was already initialized */; row < numRows_; row += 2)
-                {
-                    if (row == 0 || column == 0 || row == bottomRow_ || column == rightColumn_)
-                    {
-                        outPixelEnergy[row][column] = marginEnergy_;
-                    }
-                    else
-                    {
-                        // Reset gradient from previous calculation
-                        deltaSquareX = 0.0;
-                        deltaSquareY = 0.0;
-
-                        // For all channels:
-                          // Compute gradients
-                          // Compute overall energy by summing both X and Y gradient
-                        for (size_t channel = 0;
-                             channel < numColorChannels_; channel++)
-                        {
-                            // shift color values up
-                            yDirection1[channel] = yDirection2[channel];
-
-                            // get new values below the current pixel
-                            yDirection2[channel] = imageByChannel[channel].at<uchar>(row + 1,
-                                                                                     column);
-                            deltaYDirection[channel] = yDirection2[channel] - yDirection1[channel];
-
-                            deltaSquareY += deltaYDirection[channel] * deltaYDirection[channel];
-
-                            deltaXDirection[channel] =
-                                imageByChannel[channel].at<uchar>(row, column + 1) -
-                                imageByChannel[channel].at<uchar>(row, column - 1);
-
-                            deltaSquareX += deltaXDirection[channel] * deltaXDirection[channel];
-                        }
-                        outPixelEnergy[row][column] = deltaSquareX + deltaSquareY;
-                    }
-                }
-            }
-        }
-    }
-    catch (...)
-    {
-        // save first instance of exception
-        threadExceptionPtrMutex.lock();
+        size_t column = 1;
 
-        if (threadExceptionPtr == nullptr)
+        switch (image.depth())
         {
-            threadExceptionPtr = std::current_exception();
+        case CV_8U:
+#if CV_SIMD
+            if (bVectorizationEnabled_)
+            {
+                column = gradientEnergyRowSIMD(image.ptr<uchar>((int)row - 1),
+                                               image.ptr<uchar>((int)row),
+                                               image.ptr<uchar>((int)row + 1),
+                                               pPixelEnergyRow,
+                                               column, rightColumn,
+                                               numChannels);
+            }
+#endif
+            gradientEnergyRowScalar(image.ptr<uchar>((int)row - 1),
+                                    image.ptr<uchar>((int)row),
+                                    image.ptr<uchar>((int)row + 1),
+                                    pPixelEnergyRow,
+                                    column, rightColumn,
+                                    numChannels);
+            break;
+        case CV_16U:
+            gradientEnergyRowScalar(image.ptr<ushort>((int)row - 1),
+                                    image.ptr<ushort>((int)row),
+                                    image.ptr<ushort>((int)row + 1),
+                                    pPixelEnergyRow,
+                                    column, rightColumn,
+                                    numChannels);
+            break;
+        default:
+            gradientEnergyRowScalar(image.ptr<float>((int)row - 1),
+                                    image.ptr<float>((int)row),
+                                    image.ptr<float>((int)row + 1),
+                                    pPixelEnergyRow,
+                                    column, rightColumn,
+                                    numChannels);
+            break;
         }
-
-        threadExceptionPtrMutex.unlock();
     }
 }
\ No newline at end of file
@@ -0,0 +1,295 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "opencv2/seamcarver/horizontalseamcarver.hpp"
+#include "opencv2/seamcarver/pixelenergy2d.hpp"
+#include "seamcarverutils.hpp"
+#include <cstring>
+
+cv::HorizontalSeamCarver::HorizontalSeamCarver(
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::HorizontalSeamCarver::HorizontalSeamCarver(
+    size_t numRows,
+    size_t numColumns,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(marginEnergy, pNewPixelEnergyCalculator)
+{
+    // a horizontal seam has one pixel per image column
+    init(numColumns, numRows, numColumns);
+}
+
+cv::HorizontalSeamCarver::HorizontalSeamCarver(
+    const cv::Mat& img,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(marginEnergy, pNewPixelEnergyCalculator)
+{
+    init((size_t)img.cols, (size_t)img.rows, (size_t)img.cols);
+}
+
+cv::HorizontalSeamCarver::~HorizontalSeamCarver() {}
+
+void cv::HorizontalSeamCarver::runSeamRemover(size_t numSeamsToRemove,
+                                              const cv::Mat& image,
+                                              cv::Mat& outImage)
+{
+    // seam search tables have one row per image column
+    if (bNeedToInitializeLocalData ||
+        (size_t)image.cols != numRows_ ||
+        (size_t)image.rows != numColumns_)
+    {
+        init((size_t)image.cols, (size_t)image.rows, (size_t)image.cols);
+    }
+
+    // check if removing more seams than rows available
+    if (numSeamsToRemove > numColumns_)
+    {
+        CV_Error(Error::Code::StsBadArg, "Removing more seams than rows available");
+    }
+
+    // set number of seams to remove this pass
+    numSeamsToRemove_ = numSeamsToRemove;
+
+    // reset vectors to their clean state
+    resetLocalVectors();
+
+    findAndRemoveSeams(image, outImage);
+}
+
+void cv::HorizontalSeamCarver::runSeamInserter(size_t numSeamsToInsert,
+                                               const cv::Mat& image,
+                                               cv::Mat& outImage)
+{
+    if (bNeedToInitializeLocalData ||
+        (size_t)image.cols != numRows_ ||
+        (size_t)image.rows != numColumns_)
+    {
+        init((size_t)image.cols, (size_t)image.rows, (size_t)image.cols);
+    }
+
+    // inserted seams can't overlap, so at most one per row
+    if (numSeamsToInsert > numColumns_)
+    {
+        CV_Error(Error::Code::StsBadArg, "Inserting more seams than rows available");
+    }
+
+    // seams to insert are discovered exactly like seams to remove
+    numSeamsToRemove_ = numSeamsToInsert;
+
+    // reset vectors to their clean state
+    resetLocalVectors();
+
+    findAndInsertSeams(image, outImage);
+}
+
+void cv::HorizontalSeamCarver::setDimensions(size_t numRows, size_t numColumns)
+{
+    if (numRows == 0 || numColumns == 0)
+    {
+        CV_Error(Error::Code::StsBadArg, "setDimensions failed due bad dimensions");
+    }
+
+    init(numColumns, numRows, numColumns);
+}
+
+void cv::HorizontalSeamCarver::setIncrementalMode(bool bEnable)
+{
+    if (bEnable)
+    {
+        CV_Error(Error::Code::StsNotImplemented,
+                 "HorizontalSeamCarver doesn't support incremental mode");
+    }
+
+    VerticalSeamCarver::setIncrementalMode(bEnable);
+}
+
+void cv::HorizontalSeamCarver::calculateEnergy(const cv::Mat& image)
+{
+    // calculate in image layout, then transpose so every table row is an image column
+    calculateImageLayoutEnergy(image, energyMap, energyWeights, imageIntensity, imagePixelEnergy);
+
+    if (bForwardEnergyEnabled_)
+    {
+        cv::transpose(imageIntensity, intensity);
+    }
+
+    if (bAddPixelEnergy_)
+    {
+        cv::transpose(imagePixelEnergy, pixelEnergy);
+    }
+}
+
+void cv::HorizontalSeamCarver::findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    numColorChannels_ = (size_t)image.channels();
+
+    if (numColorChannels_ != 3 && numColorChannels_ != 1)
+    {
+        CV_Error(Error::Code::StsInternal, "HorizontalSeamCarver::findAndRemoveSeams failed due to \
+                                            incorrect number of color channels");
+    }
+
+    // find pixel energy (or intensity) for this pass with one row per image column
+    calculateEnergy(image);
+
+    // find all horizontal seams
+    findSeams();
+
+    // remove all found seams straight from the interleaved image
+    removeHorizontalSeams(image, outImage);
+}
+
+void cv::HorizontalSeamCarver::removeHorizontalSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // every image column stores the rows to remove in an ordered queue (min row first)
+    // build each output row by copying, for every column, the next input pixel that isn't part
+    //      of a seam, so the image is streamed once in row order
+    const int numRemainingRows = image.rows - (int)numSeamsToRemove_;
+    const size_t pixelSize = image.elemSize();
+
+    // write into a separate matrix in case outImage shares its data with image
+    cv::Mat carvedImage(numRemainingRows, image.cols, image.type());
+
+    sourceRows.assign(numRows_, 0);
+
+    for (int row = 0; row < numRemainingRows; row++)
+    {
+        uchar* pCarvedRow = carvedImage.ptr<uchar>(row);
+
+        for (size_t column = 0; column < numRows_; column++)
+        {
+            // skip over input pixels that belong to a seam
+            while (!discoveredSeams[column].empty() &&
+                   discoveredSeams[column].top() == sourceRows[column])
+            {
+                discoveredSeams[column].pop();
+                sourceRows[column]++;
+            }
+
+            std::memcpy(pCarvedRow + column * pixelSize,
+                        image.ptr<uchar>(sourceRows[column]) + column * pixelSize,
+                        pixelSize);
+            sourceRows[column]++;
+        }
+    }
+
+    // drop seam pixels below the last output row
+    for (size_t column = 0; column < numRows_; column++)
+    {
+        discoveredSeams[column].resetHeap();
+    }
+
+    outImage = carvedImage;
+}
+
+void cv::HorizontalSeamCarver::findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // find pixel energy (or intensity) for this pass with one row per image column
+    calculateEnergy(image);
+
+    // find all horizontal seams (non-overlapping, lowest cumulative energy first)
+    findSeams();
+
+    // duplicate all found seams in one pass over the image
+    insertSeams(image, outImage);
+}
+
+void cv::HorizontalSeamCarver::insertSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // every image column stores the rows to duplicate in an ordered queue (min row first)
+    // build each output row by copying, for every column, the next input pixel, or the average
+    //      of the seam pixel just copied and the pixel below it
+    const int numEnlargedRows = image.rows + (int)numSeamsToRemove_;
+    const int bottomImageRow = image.rows - 1;
+    const size_t pixelSize = image.elemSize();
+    const size_t numChannels = (size_t)image.channels();
+    const int depth = image.depth();
+
+    // write into a separate matrix in case outImage shares its data with image
+    cv::Mat enlargedImage(numEnlargedRows, image.cols, image.type());
+
+    sourceRows.assign(numRows_, 0);
+    bInsertPending.assign(numRows_, 0);
+
+    for (int row = 0; row < numEnlargedRows; row++)
+    {
+        uchar* pEnlargedRow = enlargedImage.ptr<uchar>(row);
+
+        for (size_t column = 0; column < numRows_; column++)
+        {
+            const size_t columnOffset = column * pixelSize;
+
+            if (bInsertPending[column])
+            {
+                const int seamRow = sourceRows[column] - 1;
+                const int neighbourRow = seamRow < bottomImageRow ? seamRow + 1 : seamRow;
+
+                averagePixels(image.ptr<uchar>(seamRow) + columnOffset,
+                              image.ptr<uchar>(neighbourRow) + columnOffset,
+                              pEnlargedRow + columnOffset,
+                              depth,
+                              numChannels);
+                bInsertPending[column] = 0;
+                continue;
+            }
+
+            std::memcpy(pEnlargedRow + columnOffset,
+                        image.ptr<uchar>(sourceRows[column]) + columnOffset,
+                        pixelSize);
+
+            if (!discoveredSeams[column].empty() &&
+                discoveredSeams[column].top() == sourceRows[column])
+            {
+                discoveredSeams[column].pop();
+                bInsertPending[column] = 1;
+            }
+
+            sourceRows[column]++;
+        }
+    }
+
+    outImage = enlargedImage;
+}
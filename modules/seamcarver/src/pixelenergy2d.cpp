@@ -44,14 +44,7 @@ using std::vector;
 
 cv::PixelEnergy2D::PixelEnergy2D(double marginEnergy)
 {
-    try
-    {
-        setMarginEnergy(marginEnergy);
-    }
-    catch (...)
-    {
-        throw;
-    }
+    setMarginEnergy(marginEnergy);
 }
 
 cv::PixelEnergy2D::~PixelEnergy2D() {}
@@ -70,4 +63,60 @@ void cv::PixelEnergy2D::setMarginEnergy(double marginEnergy)
 double cv::PixelEnergy2D::getMarginEnergy() const
 {
     return marginEnergy_;
-}
\ No newline at end of file
+}
+
+void cv::PixelEnergy2D::calculatePixelEnergy(const cv::Mat& image,
+                                             vector<vector<double>>& outPixelEnergy)
+{
+    cv::Mat pixelEnergy;
+
+    calculatePixelEnergy(image, pixelEnergy);
+
+    outPixelEnergy.resize((size_t)pixelEnergy.rows);
+    for (int row = 0; row < pixelEnergy.rows; row++)
+    {
+        const float* pPixelEnergyRow = pixelEnergy.ptr<float>(row);
+        outPixelEnergy[(size_t)row].assign(pPixelEnergyRow, pPixelEnergyRow + pixelEnergy.cols);
+    }
+}
+
+void cv::PixelEnergy2D::calculatePixelEnergyForRegion(const cv::Mat& image,
+                                                      const cv::Rect& region,
+                                                      cv::Mat& outPixelEnergy)
+{
+    if (image.empty())
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "PixelEnergy2D::calculatePixelEnergyForRegion() failed due to empty image");
+    }
+
+    if (outPixelEnergy.rows != image.rows ||
+        outPixelEnergy.cols != image.cols ||
+        outPixelEnergy.type() != CV_32FC1)
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "PixelEnergy2D::calculatePixelEnergyForRegion() failed due to bad energy matrix");
+    }
+
+    const cv::Rect imageRegion(0, 0, image.cols, image.rows);
+    const cv::Rect clippedRegion = region & imageRegion;
+
+    if (clippedRegion.empty())
+    {
+        return;
+    }
+
+    // pad the region by a pixel so its own border isn't treated as the image margin
+    const cv::Rect paddedRegion = cv::Rect(clippedRegion.x - 1,
+                                           clippedRegion.y - 1,
+                                           clippedRegion.width + 2,
+                                           clippedRegion.height + 2) & imageRegion;
+
+    cv::Mat paddedPixelEnergy;
+    calculatePixelEnergy(image(paddedRegion), paddedPixelEnergy);
+
+    paddedPixelEnergy(cv::Rect(clippedRegion.x - paddedRegion.x,
+                               clippedRegion.y - paddedRegion.y,
+                               clippedRegion.width,
+                               clippedRegion.height)).copyTo(outPixelEnergy(clippedRegion));
+}
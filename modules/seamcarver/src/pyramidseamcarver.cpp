@@ -0,0 +1,288 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "opencv2/seamcarver/pyramidseamcarver.hpp"
+#include "opencv2/seamcarver/pixelenergy2d.hpp"
+#include "seamcarverutils.hpp"
+
+namespace
+{
+    // pyramid levels are not built below this many rows or columns
+    const size_t minLevelSize = 16;
+}
+
+cv::PyramidSeamCarver::PyramidSeamCarver(
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::PyramidSeamCarver::PyramidSeamCarver(
+    size_t numRows,
+    size_t numColumns,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(numRows, numColumns, marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::PyramidSeamCarver::PyramidSeamCarver(
+    const cv::Mat& img,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(img, marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::PyramidSeamCarver::~PyramidSeamCarver() {}
+
+void cv::PyramidSeamCarver::setNumLevels(size_t numLevels)
+{
+    if (numLevels == 0)
+    {
+        CV_Error(Error::Code::StsBadArg, "Number of pyramid levels must be at least 1");
+    }
+
+    numLevels_ = numLevels;
+}
+
+size_t cv::PyramidSeamCarver::getNumLevels() const
+{
+    return numLevels_;
+}
+
+void cv::PyramidSeamCarver::setCorridorWidth(size_t corridorWidth)
+{
+    corridorWidth_ = corridorWidth;
+}
+
+size_t cv::PyramidSeamCarver::getCorridorWidth() const
+{
+    return corridorWidth_;
+}
+
+void cv::PyramidSeamCarver::setIncrementalMode(bool bEnable)
+{
+    if (bEnable)
+    {
+        CV_Error(Error::Code::StsNotImplemented,
+                 "PyramidSeamCarver doesn't support incremental mode");
+    }
+
+    VerticalSeamCarver::setIncrementalMode(bEnable);
+}
+
+void cv::PyramidSeamCarver::findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    numColorChannels_ = (size_t)image.channels();
+
+    if (numColorChannels_ != 3 && numColorChannels_ != 1)
+    {
+        CV_Error(Error::Code::StsInternal, "PyramidSeamCarver::findAndRemoveSeams failed due to \
+                                            incorrect number of color channels");
+    }
+
+    // find all vertical seams, refining them from the coarsest level down
+    findSeamsCoarseToFine(image);
+
+    // remove all found seams straight from the interleaved image
+    removeSeams(image, outImage);
+}
+
+void cv::PyramidSeamCarver::findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // find all vertical seams, refining them from the coarsest level down
+    findSeamsCoarseToFine(image);
+
+    // duplicate all found seams in one pass over the image
+    insertSeams(image, outImage);
+}
+
+void cv::PyramidSeamCarver::findSeamsCoarseToFine(const cv::Mat& image)
+{
+    const size_t fullNumRows = numRows_;
+    const size_t fullNumColumns = numColumns_;
+
+    // every level halves the image and the number of seams, stop before a level gets too small
+    //      or would have more than half of its columns carved
+    size_t numUsedLevels = 1;
+    while (numUsedLevels < numLevels_)
+    {
+        const size_t levelNumRows = fullNumRows >> numUsedLevels;
+        const size_t levelNumColumns = fullNumColumns >> numUsedLevels;
+        const size_t levelNumSeams =
+            (numSeamsToRemove_ + ((size_t)1 << numUsedLevels) - 1) >> numUsedLevels;
+
+        if (levelNumRows < minLevelSize || levelNumColumns < minLevelSize ||
+            2 * levelNumSeams > levelNumColumns)
+        {
+            break;
+        }
+
+        numUsedLevels++;
+    }
+
+    // build the coarse levels of the image and of anything added to its energy
+    levelImages.resize(numUsedLevels);
+    levelEnergyMaps.resize(numUsedLevels);
+    levelEnergyWeights.resize(numUsedLevels);
+    for (size_t level = 1; level < numUsedLevels; level++)
+    {
+        downsampleByTwo(level == 1 ? image : levelImages[level - 1], levelImages[level]);
+
+        if (energyMap.empty())
+        {
+            levelEnergyMaps[level].release();
+        }
+        else
+        {
+            downsampleByTwo(level == 1 ? energyMap : levelEnergyMaps[level - 1],
+                            levelEnergyMaps[level]);
+        }
+
+        if (energyWeights.empty())
+        {
+            levelEnergyWeights[level].release();
+        }
+        else
+        {
+            downsampleByTwo(level == 1 ? energyWeights : levelEnergyWeights[level - 1],
+                            levelEnergyWeights[level]);
+        }
+    }
+
+    // coarse levels calculate their energy into the top left corner of the full size buffers
+    if (bForwardEnergyEnabled_ &&
+        (intensity.rows != (int)fullNumRows || intensity.cols != (int)fullNumColumns))
+    {
+        reserveWorkspaceMat(fullNumRows, fullNumColumns, CV_32FC1, intensity);
+    }
+
+    try
+    {
+        coarseSeams.clear();
+
+        for (size_t level = numUsedLevels; level-- > 0;)
+        {
+            const size_t levelNumSeams = level == 0 ? numSeamsToRemove_ :
+                (numSeamsToRemove_ + ((size_t)1 << level) - 1) >> level;
+            const cv::Rect levelRect(0, 0,
+                                     (int)(fullNumColumns >> level),
+                                     (int)(fullNumRows >> level));
+
+            setLevelDimensions(fullNumRows >> level, fullNumColumns >> level);
+            markedPixels(levelRect).setTo(cv::Scalar::all(0));
+
+            if (level == 0)
+            {
+                calculateEnergy(image);
+
+                // only the energy of the seams actually removed is reported
+                removedSeamsEnergy_ = 0.0;
+            }
+            else
+            {
+                cv::Mat levelIntensity = bForwardEnergyEnabled_ ? intensity(levelRect) : cv::Mat();
+                cv::Mat levelPixelEnergy = pixelEnergy(levelRect);
+                calculateImageLayoutEnergy(levelImages[level],
+                                           levelEnergyMaps[level],
+                                           levelEnergyWeights[level],
+                                           levelIntensity,
+                                           levelPixelEnergy);
+            }
+
+            levelSeams.resize(levelNumSeams);
+
+            for (size_t n = 0; n < levelNumSeams; n++)
+            {
+                // every coarse seam guides the two seams it was downsampled from
+                bool bFoundSeam = false;
+                if (n / 2 < coarseSeams.size())
+                {
+                    const std::vector<size_t>& coarseSeam = coarseSeams[n / 2];
+                    guideSeam.resize(numRows_);
+                    for (size_t row = 0; row < numRows_; row++)
+                    {
+                        const size_t coarseColumn =
+                            coarseSeam[std::min(row / 2, coarseSeam.size() - 1)];
+                        guideSeam[row] = std::min(2 * coarseColumn + (n & 1), rightColumn_);
+                    }
+
+                    bFoundSeam = findSeamInBand(guideSeam, corridorWidth_);
+                }
+
+                // search the whole level on the coarsest level or if the corridor is blocked
+                if (!bFoundSeam)
+                {
+                    calculateCumulativePathEnergy();
+                    findLeastEnergySeam();
+                }
+
+                if (level == 0)
+                {
+                    addCurrentSeam();
+                    continue;
+                }
+
+                levelSeams[n].assign(currentSeam.begin(), currentSeam.begin() + numRows_);
+                for (size_t row = 0; row < numRows_; row++)
+                {
+                    markedPixels.ptr<uchar>((int)row)[currentSeam[row]] = 1;
+                }
+            }
+
+            coarseSeams.swap(levelSeams);
+        }
+    }
+    catch (...)
+    {
+        setLevelDimensions(fullNumRows, fullNumColumns);
+        throw;
+    }
+
+    setLevelDimensions(fullNumRows, fullNumColumns);
+}
+
+void cv::PyramidSeamCarver::setLevelDimensions(size_t numRows, size_t numColumns)
+{
+    numRows_ = numRows;
+    numColumns_ = numColumns;
+    bottomRow_ = numRows - 1;
+    rightColumn_ = numColumns - 1;
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "opencv2/seamcarver/retargetingseamcarver.hpp"
+#include <algorithm>
+#include <limits>
+
+cv::RetargetingSeamCarver::RetargetingSeamCarver(
+    double marginEnergy,
+    PixelEnergy2D* pVerticalPixelEnergyCalculator,
+    PixelEnergy2D* pHorizontalPixelEnergyCalculator) :
+    verticalSeamCarver_(marginEnergy, pVerticalPixelEnergyCalculator),
+    horizontalSeamCarver_(marginEnergy, pHorizontalPixelEnergyCalculator)
+{}
+
+cv::RetargetingSeamCarver::~RetargetingSeamCarver() {}
+
+void cv::RetargetingSeamCarver::retarget(const cv::Mat& image,
+                                         const cv::Size& targetSize,
+                                         cv::Mat& outImage)
+{
+    if (image.empty())
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "RetargetingSeamCarver::retarget() failed due to empty image");
+    }
+
+    if (targetSize.width <= 0 || targetSize.height <= 0 ||
+        targetSize.width > image.cols || targetSize.height > image.rows)
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "RetargetingSeamCarver::retarget() failed due to bad target size");
+    }
+
+    const size_t numRowsToRemove = (size_t)(image.rows - targetSize.height);
+    const size_t numColumnsToRemove = (size_t)(image.cols - targetSize.width);
+    const size_t numMapColumns = numColumnsToRemove + 1;
+
+    // one row of the transport map (and the images it reaches) is updated in place: before entry
+    //      c of row r is written, transportImages[c] still holds the image of row r - 1
+    transportImages.assign(numMapColumns, cv::Mat());
+    transportCosts.assign(numMapColumns, 0.0);
+
+    // the choice of every entry, so the seam order can be rebuilt without keeping the images
+    bVerticalSeamChosen.assign((numRowsToRemove + 1) * numMapColumns, false);
+
+    cv::Mat verticalCandidate;
+    cv::Mat horizontalCandidate;
+
+    // row r of the map has r horizontal seams removed, column c has c vertical seams removed
+    for (size_t r = 0; r <= numRowsToRemove; r++)
+    {
+        for (size_t c = 0; c <= numColumnsToRemove; c++)
+        {
+            if (r == 0 && c == 0)
+            {
+                transportImages[0] = image;
+                transportCosts[0] = 0.0;
+                continue;
+            }
+
+            double verticalCost = std::numeric_limits<double>::max();
+            double horizontalCost = std::numeric_limits<double>::max();
+
+            // arrive from the left by removing a vertical seam
+            if (c > 0)
+            {
+                verticalSeamCarver_.runSeamRemover(1, transportImages[c - 1], verticalCandidate);
+                verticalCost = transportCosts[c - 1] +
+                               verticalSeamCarver_.getRemovedSeamsEnergy();
+            }
+
+            // arrive from above by removing a horizontal seam
+            if (r > 0)
+            {
+                horizontalSeamCarver_.runSeamRemover(1, transportImages[c], horizontalCandidate);
+                horizontalCost = transportCosts[c] +
+                                 horizontalSeamCarver_.getRemovedSeamsEnergy();
+            }
+
+            // the candidates are released on the next iteration, so move them into the map
+            if (verticalCost <= horizontalCost)
+            {
+                transportImages[c] = verticalCandidate;
+                transportCosts[c] = verticalCost;
+                bVerticalSeamChosen[r * numMapColumns + c] = true;
+                verticalCandidate = cv::Mat();
+            }
+            else
+            {
+                transportImages[c] = horizontalCandidate;
+                transportCosts[c] = horizontalCost;
+                horizontalCandidate = cv::Mat();
+            }
+        }
+    }
+
+    // don't hold on to intermediate images while replaying the seam order
+    transportImages.assign(numMapColumns, cv::Mat());
+    verticalCandidate = cv::Mat();
+    horizontalCandidate = cv::Mat();
+
+    // backtrack from the target entry to the input image
+    seamOrder.clear();
+    for (size_t r = numRowsToRemove, c = numColumnsToRemove; r > 0 || c > 0;)
+    {
+        const bool bVertical = bVerticalSeamChosen[r * numMapColumns + c];
+        seamOrder.push_back(bVertical);
+        if (bVertical)
+        {
+            c--;
+        }
+        else
+        {
+            r--;
+        }
+    }
+    std::reverse(seamOrder.begin(), seamOrder.end());
+
+    // remove the seams of the optimal path one at a time, which reproduces the image the
+    //      transport map reached at its last entry
+    cv::Mat currentImage = image;
+    cv::Mat nextImage;
+    for (size_t i = 0; i < seamOrder.size(); i++)
+    {
+        if (seamOrder[i])
+        {
+            verticalSeamCarver_.runSeamRemover(1, currentImage, nextImage);
+        }
+        else
+        {
+            horizontalSeamCarver_.runSeamRemover(1, currentImage, nextImage);
+        }
+        cv::swap(currentImage, nextImage);
+    }
+
+    currentImage.copyTo(outImage);
+}
+
+const std::vector<bool>& cv::RetargetingSeamCarver::getSeamOrder() const
+{
+    return seamOrder;
+}
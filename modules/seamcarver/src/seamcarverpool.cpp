@@ -0,0 +1,144 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "opencv2/seamcarver/seamcarverpool.hpp"
+#include <memory>
+
+cv::SeamCarverPool::SeamCarverPool(double marginEnergy) : marginEnergy_(marginEnergy) {}
+
+cv::SeamCarverPool::~SeamCarverPool()
+{
+    for (VerticalSeamCarver* pWorkspace : workspaces)
+    {
+        delete pWorkspace;
+    }
+}
+
+void cv::SeamCarverPool::runSeamRemover(size_t numSeamsToRemove,
+                                        const cv::Mat& image,
+                                        cv::Mat& outImage)
+{
+    VerticalSeamCarver* pWorkspace = acquireWorkspace();
+    const size_t numAllocationsBefore = pWorkspace->getNumAllocations();
+
+    try
+    {
+        pWorkspace->runSeamRemover(numSeamsToRemove, image, outImage);
+    }
+    catch (...)
+    {
+        releaseWorkspace(pWorkspace, pWorkspace->getNumAllocations() - numAllocationsBefore);
+        throw;
+    }
+
+    releaseWorkspace(pWorkspace, pWorkspace->getNumAllocations() - numAllocationsBefore);
+}
+
+void cv::SeamCarverPool::runSeamRemover(size_t numSeamsToRemove,
+                                        const std::vector<cv::Mat>& images,
+                                        std::vector<cv::Mat>& outImages)
+{
+    runSeamRemover(std::vector<size_t>(images.size(), numSeamsToRemove), images, outImages);
+}
+
+void cv::SeamCarverPool::runSeamRemover(const std::vector<size_t>& numSeamsToRemove,
+                                        const std::vector<cv::Mat>& images,
+                                        std::vector<cv::Mat>& outImages)
+{
+    if (numSeamsToRemove.size() != images.size())
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "SeamCarverPool::runSeamRemover() failed due to mismatched seam counts");
+    }
+
+    outImages.resize(images.size());
+
+    // every image is carved by whichever workspace is idle when its task starts
+    cv::parallel_for_(cv::Range(0, (int)images.size()), [&](const cv::Range& range)
+    {
+        for (int index = range.start; index < range.end; index++)
+        {
+            runSeamRemover(numSeamsToRemove[(size_t)index],
+                           images[(size_t)index],
+                           outImages[(size_t)index]);
+        }
+    });
+}
+
+size_t cv::SeamCarverPool::getNumWorkspaces() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return workspaces.size();
+}
+
+size_t cv::SeamCarverPool::getNumAllocations() const
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+    return numAllocations_;
+}
+
+cv::VerticalSeamCarver* cv::SeamCarverPool::acquireWorkspace()
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    if (idleWorkspaces.empty())
+    {
+        // owned here until the pool holds it, and room is kept for returning every workspace,
+        // so neither a failed push_back nor releaseWorkspace() can lose one
+        std::unique_ptr<VerticalSeamCarver> pNewWorkspace(new VerticalSeamCarver(marginEnergy_));
+        idleWorkspaces.reserve(workspaces.size() + 1);
+        workspaces.push_back(pNewWorkspace.get());
+        return pNewWorkspace.release();
+    }
+
+    VerticalSeamCarver* pWorkspace = idleWorkspaces.back();
+    idleWorkspaces.pop_back();
+    return pWorkspace;
+}
+
+void cv::SeamCarverPool::releaseWorkspace(VerticalSeamCarver* pWorkspace,
+                                          size_t numNewAllocations)
+{
+    std::lock_guard<std::mutex> lock(poolMutex);
+
+    numAllocations_ += numNewAllocations;
+    idleWorkspaces.push_back(pWorkspace);
+}
\ No newline at end of file
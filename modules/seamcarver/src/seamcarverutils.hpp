@@ -0,0 +1,302 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#ifndef OPENCV_SEAMCARVER_SEAMCARVERUTILS_HPP
+#define OPENCV_SEAMCARVER_SEAMCARVERUTILS_HPP
+
+#include <opencv2/core.hpp>
+#include <type_traits>
+
+namespace cv
+{
+    // working buffer rows are padded to a multiple of this many bytes so every row starts
+    //      on its own cache line and the DP sweep streams through memory
+    const size_t rowAlignment = 64;
+
+    /**
+     * @brief allocate a numRows x numColumns matrix whose row stride is padded to rowAlignment
+     * @param numRows: number of rows
+     * @param numColumns: number of columns
+     * @param type: matrix type
+     * @param outMat: output parameter, header of the allocated matrix
+     */
+    inline void allocateRowAlignedMat(size_t numRows, size_t numColumns, int type, cv::Mat& outMat)
+    {
+        size_t elementSize = (size_t)CV_ELEM_SIZE(type);
+        size_t paddedColumns = cv::alignSize(numColumns * elementSize, (int)rowAlignment) /
+                               elementSize;
+
+        cv::Mat paddedMat((int)numRows, (int)paddedColumns, type);
+        outMat = paddedMat.colRange(0, (int)numColumns);
+    }
+
+    /**
+     * @brief resize a matrix allocated by allocateRowAlignedMat within its current allocation
+     * @param numRows: number of rows
+     * @param numColumns: number of columns
+     * @param type: matrix type
+     * @param outMat: in/out parameter, header of the resized matrix
+     * @return true if the allocation was large enough, false if outMat is unchanged
+     */
+    inline bool reuseRowAlignedMat(size_t numRows, size_t numColumns, int type, cv::Mat& outMat)
+    {
+        if (outMat.empty() || outMat.type() != type)
+        {
+            return false;
+        }
+
+        cv::Size wholeSize;
+        cv::Point offset;
+        outMat.locateROI(wholeSize, offset);
+
+        if (offset != cv::Point(0, 0) ||
+            (size_t)wholeSize.height < numRows ||
+            (size_t)wholeSize.width < numColumns)
+        {
+            return false;
+        }
+
+        outMat.adjustROI(0, (int)numRows - outMat.rows, 0, (int)numColumns - outMat.cols);
+        return true;
+    }
+
+    /**
+     * @brief write the per channel average of two pixels
+     * @param pFirstPixel: pointer to the first pixel
+     * @param pSecondPixel: pointer to the second pixel
+     * @param pOutPixel: output parameter, pointer to the averaged pixel
+     * @param depth: depth of the pixel channels (CV_8U, CV_16U or CV_32F)
+     * @param numChannels: number of channels per pixel
+     */
+    inline void averagePixels(const uchar* pFirstPixel,
+                              const uchar* pSecondPixel,
+                              uchar* pOutPixel,
+                              int depth,
+                              size_t numChannels)
+    {
+        switch (depth)
+        {
+        case CV_8U:
+            for (size_t channel = 0; channel < numChannels; channel++)
+            {
+                pOutPixel[channel] =
+                    (uchar)((pFirstPixel[channel] + pSecondPixel[channel] + 1) >> 1);
+            }
+            break;
+        case CV_16U:
+        {
+            const ushort* pFirst = (const ushort*)pFirstPixel;
+            const ushort* pSecond = (const ushort*)pSecondPixel;
+            ushort* pOut = (ushort*)pOutPixel;
+            for (size_t channel = 0; channel < numChannels; channel++)
+            {
+                pOut[channel] = (ushort)((pFirst[channel] + pSecond[channel] + 1) >> 1);
+            }
+            break;
+        }
+        case CV_32F:
+        {
+            const float* pFirst = (const float*)pFirstPixel;
+            const float* pSecond = (const float*)pSecondPixel;
+            float* pOut = (float*)pOutPixel;
+            for (size_t channel = 0; channel < numChannels; channel++)
+            {
+                pOut[channel] = (pFirst[channel] + pSecond[channel]) * 0.5f;
+            }
+            break;
+        }
+        default:
+            CV_Error(Error::Code::StsUnsupportedFormat,
+                     "averagePixels() failed due to unsupported pixel depth");
+        }
+    }
+
+    /**
+     * @brief write the intensity of every pixel of a row, 0.114 B + 0.587 G + 0.299 R for
+     *        3 channel pixels or the value itself for 1 channel pixels
+     * @param pImageRow: pointer to the first pixel of the row
+     * @param pOutIntensityRow: output parameter, pointer to the first intensity of the row
+     * @param numColumns: number of pixels in the row
+     * @param numChannels: number of channels per pixel (1 or 3)
+     */
+    template<typename _Tp>
+    inline void calculateIntensityRow(const _Tp* pImageRow,
+                                      float* pOutIntensityRow,
+                                      size_t numColumns,
+                                      size_t numChannels)
+    {
+        if (numChannels == 1)
+        {
+            for (size_t column = 0; column < numColumns; column++)
+            {
+                pOutIntensityRow[column] = (float)pImageRow[column];
+            }
+            return;
+        }
+
+        for (size_t column = 0; column < numColumns; column++, pImageRow += 3)
+        {
+            pOutIntensityRow[column] = 0.114f * (float)pImageRow[0] +
+                                       0.587f * (float)pImageRow[1] +
+                                       0.299f * (float)pImageRow[2];
+        }
+    }
+
+    /**
+     * @brief calculate the intensity of every pixel used by the forward energy cost model
+     * @param image: input image (CV_8U, CV_16U or CV_32F with 1 or 3 channels)
+     * @param outIntensity: output parameter, CV_32FC1 intensity with the size of image.
+     *                      The existing buffer is reused if it already has that size and type
+     */
+    inline void calculateIntensity(const cv::Mat& image, cv::Mat& outIntensity)
+    {
+        const size_t numChannels = (size_t)image.channels();
+
+        if (numChannels != 1 && numChannels != 3)
+        {
+            CV_Error(Error::Code::StsUnsupportedFormat,
+                     "calculateIntensity() failed due to incorrect number of color channels");
+        }
+
+        outIntensity.create(image.rows, image.cols, CV_32FC1);
+
+        for (int row = 0; row < image.rows; row++)
+        {
+            float* pIntensityRow = outIntensity.ptr<float>(row);
+
+            switch (image.depth())
+            {
+            case CV_8U:
+                calculateIntensityRow(image.ptr<uchar>(row), pIntensityRow,
+                                      (size_t)image.cols, numChannels);
+                break;
+            case CV_16U:
+                calculateIntensityRow(image.ptr<ushort>(row), pIntensityRow,
+                                      (size_t)image.cols, numChannels);
+                break;
+            case CV_32F:
+                calculateIntensityRow(image.ptr<float>(row), pIntensityRow,
+                                      (size_t)image.cols, numChannels);
+                break;
+            default:
+                CV_Error(Error::Code::StsUnsupportedFormat,
+                         "calculateIntensity() failed due to unsupported pixel depth");
+            }
+        }
+    }
+
+    /**
+     * @brief average every 2x2 block of pixels of a row pair into one pixel
+     * @param pTopRow: pointer to the first pixel of the upper source row
+     * @param pBottomRow: pointer to the first pixel of the lower source row
+     * @param pOutRow: output parameter, pointer to the first pixel of the halved row
+     * @param numOutColumns: number of pixels in the halved row
+     * @param numChannels: number of channels per pixel
+     */
+    template<typename _Tp, typename _AccTp>
+    inline void downsampleRowByTwo(const _Tp* pTopRow,
+                                   const _Tp* pBottomRow,
+                                   _Tp* pOutRow,
+                                   size_t numOutColumns,
+                                   size_t numChannels)
+    {
+        for (size_t column = 0; column < numOutColumns; column++)
+        {
+            const size_t left = 2 * column * numChannels;
+            const size_t right = left + numChannels;
+
+            for (size_t channel = 0; channel < numChannels; channel++)
+            {
+                _AccTp sum = (_AccTp)pTopRow[left + channel] + (_AccTp)pTopRow[right + channel] +
+                             (_AccTp)pBottomRow[left + channel] +
+                             (_AccTp)pBottomRow[right + channel];
+                pOutRow[column * numChannels + channel] = std::is_floating_point<_Tp>::value ?
+                                                          (_Tp)(sum * (_AccTp)0.25) :
+                                                          (_Tp)((sum + 2) / 4);
+            }
+        }
+    }
+
+    /**
+     * @brief halve the width and height of an image by averaging 2x2 blocks of pixels. An odd
+     *        last row or column is dropped
+     * @param image: input image (CV_8U, CV_16U or CV_32F with any number of channels)
+     * @param outImage: output parameter, image of size (image.cols / 2, image.rows / 2)
+     */
+    inline void downsampleByTwo(const cv::Mat& image, cv::Mat& outImage)
+    {
+        const int numOutRows = image.rows / 2;
+        const size_t numOutColumns = (size_t)(image.cols / 2);
+        const size_t numChannels = (size_t)image.channels();
+
+        outImage.create(numOutRows, (int)numOutColumns, image.type());
+
+        for (int row = 0; row < numOutRows; row++)
+        {
+            switch (image.depth())
+            {
+            case CV_8U:
+                downsampleRowByTwo<uchar, int>(image.ptr<uchar>(2 * row),
+                                               image.ptr<uchar>(2 * row + 1),
+                                               outImage.ptr<uchar>(row),
+                                               numOutColumns, numChannels);
+                break;
+            case CV_16U:
+                downsampleRowByTwo<ushort, int>(image.ptr<ushort>(2 * row),
+                                                image.ptr<ushort>(2 * row + 1),
+                                                outImage.ptr<ushort>(row),
+                                                numOutColumns, numChannels);
+                break;
+            case CV_32F:
+                downsampleRowByTwo<float, float>(image.ptr<float>(2 * row),
+                                                 image.ptr<float>(2 * row + 1),
+                                                 outImage.ptr<float>(row),
+                                                 numOutColumns, numChannels);
+                break;
+            default:
+                CV_Error(Error::Code::StsUnsupportedFormat,
+                         "downsampleByTwo() failed due to unsupported pixel depth");
+            }
+        }
+    }
+}
+
+#endif
\ No newline at end of file
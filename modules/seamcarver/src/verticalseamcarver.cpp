@@ -41,6 +41,417 @@
 
 #include "opencv2/seamcarver/verticalseamcarver.hpp"
 #include "opencv2/seamcarver/gradientpixelenergy2d.hpp"
+#include "opencv2/core/hal/intrin.hpp"
+#include "seamcarverutils.hpp"
+#include <cstring>
+#include <algorithm>
+
+namespace cv
+{
+    namespace
+    {
+        /**
+         * @brief scalar cumulative path energy for columns [startColumn, endColumn) of one row
+         * @note marked pixels in the row above must already hold +INF cumulative energy, which is
+         *       always the case within a single top to bottom sweep
+         */
+        void cumulativePathEnergyRowScalar(const float* pTotalEnergyAbove,
+                                           const float* pPixelEnergyRow,
+                                           const uchar* pMarkedRow,
+                                           float* pTotalEnergyRow,
+                                           int32_t* pPreviousLocationRow,
+                                           size_t startColumn,
+                                           size_t endColumn,
+                                           size_t numColumns,
+                                           float posInf)
+        {
+            for (size_t column = startColumn; column < endColumn; column++)
+            {
+                // initialize min energy to +INF and initialize the previous column to -1
+                //   to set error state
+                float minEnergy = posInf;
+                int32_t minEnergyColumn = -1;
+
+                // save some cycles by not doing any comparisons if the current pixel has been
+                //      previously marked
+                if (!pMarkedRow[column])
+                {
+                    // check above
+                    if (pTotalEnergyAbove[column] < minEnergy)
+                    {
+                        minEnergy = pTotalEnergyAbove[column];
+                        minEnergyColumn = (int32_t)column;
+                    }
+
+                    // check if right/above is min
+                    if (column + 1 < numColumns && pTotalEnergyAbove[column + 1] < minEnergy)
+                    {
+                        minEnergy = pTotalEnergyAbove[column + 1];
+                        minEnergyColumn = (int32_t)column + 1;
+                    }
+
+                    // check if left/above is min
+                    if (column > 0 && pTotalEnergyAbove[column - 1] < minEnergy)
+                    {
+                        minEnergy = pTotalEnergyAbove[column - 1];
+                        minEnergyColumn = (int32_t)column - 1;
+                    }
+                }
+
+                // assign cumulative energy to current pixel and save the column of the parent pixel
+                if (minEnergyColumn == -1)
+                {
+                    // current pixel is unreachable from parent pixels since they are all marked
+                    //   OR current pixel already marked
+                    pTotalEnergyRow[column] = posInf;
+                }
+                else
+                {
+                    pTotalEnergyRow[column] = minEnergy + pPixelEnergyRow[column];
+                }
+                pPreviousLocationRow[column] = minEnergyColumn;
+            }
+        }
+
+#if CV_SIMD
+        /**
+         * @brief vectorized cumulative path energy for interior columns of one row
+         * @note startColumn must be at least 1 and endColumn at most numColumns - 1 so the
+         *       up/left and up/right loads stay inside the row. The neighbours are compared in the
+         *       same order as the scalar path, so the results are bit-identical.
+         * @return first column that was not calculated (less than v_float32::nlanes from endColumn)
+         */
+        size_t cumulativePathEnergyRowSIMD(const float* pTotalEnergyAbove,
+                                           const float* pPixelEnergyRow,
+                                           const uchar* pMarkedRow,
+                                           float* pTotalEnergyRow,
+                                           int32_t* pPreviousLocationRow,
+                                           size_t startColumn,
+                                           size_t endColumn,
+                                           float posInf)
+        {
+            const size_t numLanes = (size_t)v_float32::nlanes;
+
+            CV_DECL_ALIGNED(CV_SIMD_WIDTH) int32_t laneOffsets[v_int32::nlanes];
+            for (int lane = 0; lane < v_int32::nlanes; lane++)
+            {
+                laneOffsets[lane] = lane;
+            }
+
+            const v_float32 vPosInf = vx_setall_f32(posInf);
+            const v_int32 vNoParent = vx_setall_s32(-1);
+            const v_int32 vOne = vx_setall_s32(1);
+            const v_int32 vLaneOffsets = vx_load_aligned(laneOffsets);
+            const v_uint32 vUnmarked = vx_setzero_u32();
+
+            size_t column = startColumn;
+            for (; column + numLanes <= endColumn; column += numLanes)
+            {
+                v_int32 vColumn = vx_setall_s32((int32_t)column) + vLaneOffsets;
+
+                v_float32 vMinEnergy = vPosInf;
+                v_int32 vMinEnergyColumn = vNoParent;
+
+                // check above
+                v_float32 vEnergy = vx_load(pTotalEnergyAbove + column);
+                v_float32 vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn,
+                                            vMinEnergyColumn);
+
+                // check if right/above is min
+                vEnergy = vx_load(pTotalEnergyAbove + column + 1);
+                vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn + vOne,
+                                            vMinEnergyColumn);
+
+                // check if left/above is min
+                vEnergy = vx_load(pTotalEnergyAbove + column - 1);
+                vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn - vOne,
+                                            vMinEnergyColumn);
+
+                // a lane is reachable if the current pixel isn't marked and some parent was chosen
+                v_float32 vReachable =
+                    v_reinterpret_as_f32(vx_load_expand_q(pMarkedRow + column) == vUnmarked) &
+                    (vMinEnergy < vPosInf);
+
+                v_store(pTotalEnergyRow + column,
+                        v_select(vReachable,
+                                 vMinEnergy + vx_load(pPixelEnergyRow + column),
+                                 vPosInf));
+                v_store(pPreviousLocationRow + column,
+                        v_select(v_reinterpret_as_s32(vReachable), vMinEnergyColumn, vNoParent));
+            }
+            vx_cleanup();
+
+            return column;
+        }
+#endif
+
+        /**
+         * @brief scalar forward energy cumulative path energy for columns
+         *        [startColumn, endColumn) of one row (Rubinstein et al., "Improved Seam Carving
+         *        for Video Retargeting"). The cost of each parent is the intensity difference
+         *        of the pixels that become neighbours once the seam pixel is removed. The pixel
+         *        energy is added on top of that if pPixelEnergyRow isn't null
+         * @note marked pixels in the row above must already hold +INF cumulative energy
+         */
+        void cumulativeForwardEnergyRowScalar(const float* pTotalEnergyAbove,
+                                              const float* pPixelEnergyRow,
+                                              const float* pIntensityAbove,
+                                              const float* pIntensityRow,
+                                              const uchar* pMarkedRow,
+                                              float* pTotalEnergyRow,
+                                              int32_t* pPreviousLocationRow,
+                                              size_t startColumn,
+                                              size_t endColumn,
+                                              size_t numColumns,
+                                              float posInf)
+        {
+            for (size_t column = startColumn; column < endColumn; column++)
+            {
+                float minEnergy = posInf;
+                int32_t minEnergyColumn = -1;
+
+                if (!pMarkedRow[column])
+                {
+                    // replicate the border pixels
+                    const size_t leftColumn = column > 0 ? column - 1 : column;
+                    const size_t rightColumn = column + 1 < numColumns ? column + 1 : column;
+
+                    // left and right neighbours always become adjacent, going diagonally also
+                    //      joins the pixel above with the left or right neighbour
+                    const float costUp = std::abs(pIntensityRow[rightColumn] -
+                                                  pIntensityRow[leftColumn]);
+                    const float costUpLeft = costUp + std::abs(pIntensityAbove[column] -
+                                                               pIntensityRow[leftColumn]);
+                    const float costUpRight = costUp + std::abs(pIntensityAbove[column] -
+                                                                pIntensityRow[rightColumn]);
+
+                    // check above
+                    float energy = pTotalEnergyAbove[column] + costUp;
+                    if (energy < minEnergy)
+                    {
+                        minEnergy = energy;
+                        minEnergyColumn = (int32_t)column;
+                    }
+
+                    // check if right/above is min
+                    if (column + 1 < numColumns)
+                    {
+                        energy = pTotalEnergyAbove[column + 1] + costUpRight;
+                        if (energy < minEnergy)
+                        {
+                            minEnergy = energy;
+                            minEnergyColumn = (int32_t)column + 1;
+                        }
+                    }
+
+                    // check if left/above is min
+                    if (column > 0)
+                    {
+                        energy = pTotalEnergyAbove[column - 1] + costUpLeft;
+                        if (energy < minEnergy)
+                        {
+                            minEnergy = energy;
+                            minEnergyColumn = (int32_t)column - 1;
+                        }
+                    }
+                }
+
+                if (minEnergyColumn == -1)
+                {
+                    pTotalEnergyRow[column] = posInf;
+                }
+                else
+                {
+                    pTotalEnergyRow[column] =
+                        pPixelEnergyRow ? minEnergy + pPixelEnergyRow[column] : minEnergy;
+                }
+                pPreviousLocationRow[column] = minEnergyColumn;
+            }
+        }
+
+#if CV_SIMD
+        /**
+         * @brief vectorized forward energy cumulative path energy for interior columns of one
+         *        row, bit-identical to cumulativeForwardEnergyRowScalar()
+         * @note startColumn must be at least 1 and endColumn at most numColumns - 1
+         * @return first column that was not calculated (less than v_float32::nlanes from endColumn)
+         */
+        size_t cumulativeForwardEnergyRowSIMD(const float* pTotalEnergyAbove,
+                                              const float* pPixelEnergyRow,
+                                              const float* pIntensityAbove,
+                                              const float* pIntensityRow,
+                                              const uchar* pMarkedRow,
+                                              float* pTotalEnergyRow,
+                                              int32_t* pPreviousLocationRow,
+                                              size_t startColumn,
+                                              size_t endColumn,
+                                              float posInf)
+        {
+            const size_t numLanes = (size_t)v_float32::nlanes;
+
+            CV_DECL_ALIGNED(CV_SIMD_WIDTH) int32_t laneOffsets[v_int32::nlanes];
+            for (int lane = 0; lane < v_int32::nlanes; lane++)
+            {
+                laneOffsets[lane] = lane;
+            }
+
+            const v_float32 vPosInf = vx_setall_f32(posInf);
+            const v_int32 vNoParent = vx_setall_s32(-1);
+            const v_int32 vOne = vx_setall_s32(1);
+            const v_int32 vLaneOffsets = vx_load_aligned(laneOffsets);
+            const v_uint32 vUnmarked = vx_setzero_u32();
+
+            size_t column = startColumn;
+            for (; column + numLanes <= endColumn; column += numLanes)
+            {
+                v_int32 vColumn = vx_setall_s32((int32_t)column) + vLaneOffsets;
+
+                v_float32 vIntensityLeft = vx_load(pIntensityRow + column - 1);
+                v_float32 vIntensityRight = vx_load(pIntensityRow + column + 1);
+                v_float32 vIntensityAbove = vx_load(pIntensityAbove + column);
+
+                v_float32 vCostUp = v_absdiff(vIntensityRight, vIntensityLeft);
+                v_float32 vCostUpLeft = vCostUp + v_absdiff(vIntensityAbove, vIntensityLeft);
+                v_float32 vCostUpRight = vCostUp + v_absdiff(vIntensityAbove, vIntensityRight);
+
+                v_float32 vMinEnergy = vPosInf;
+                v_int32 vMinEnergyColumn = vNoParent;
+
+                // check above
+                v_float32 vEnergy = vx_load(pTotalEnergyAbove + column) + vCostUp;
+                v_float32 vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn,
+                                            vMinEnergyColumn);
+
+                // check if right/above is min
+                vEnergy = vx_load(pTotalEnergyAbove + column + 1) + vCostUpRight;
+                vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn + vOne,
+                                            vMinEnergyColumn);
+
+                // check if left/above is min
+                vEnergy = vx_load(pTotalEnergyAbove + column - 1) + vCostUpLeft;
+                vIsLess = vEnergy < vMinEnergy;
+                vMinEnergy = v_select(vIsLess, vEnergy, vMinEnergy);
+                vMinEnergyColumn = v_select(v_reinterpret_as_s32(vIsLess),
+                                            vColumn - vOne,
+                                            vMinEnergyColumn);
+
+                // a lane is reachable if the current pixel isn't marked and some parent was chosen
+                v_float32 vReachable =
+                    v_reinterpret_as_f32(vx_load_expand_q(pMarkedRow + column) == vUnmarked) &
+                    (vMinEnergy < vPosInf);
+
+                if (pPixelEnergyRow)
+                {
+                    vMinEnergy = vMinEnergy + vx_load(pPixelEnergyRow + column);
+                }
+
+                v_store(pTotalEnergyRow + column, v_select(vReachable, vMinEnergy, vPosInf));
+                v_store(pPreviousLocationRow + column,
+                        v_select(v_reinterpret_as_s32(vReachable), vMinEnergyColumn, vNoParent));
+            }
+            vx_cleanup();
+
+            return column;
+        }
+#endif
+
+        /**
+         * @brief cumulative path energy for columns [startColumn, endColumn) of one row,
+         *        vectorized over the interior columns if requested. Forward energy is used when
+         *        intensity rows are given, otherwise the pixel energy is added to the parents.
+         *        In forward energy mode pPixelEnergyRow is optional
+         */
+        void cumulativePathEnergyRow(const float* pTotalEnergyAbove,
+                                     const float* pPixelEnergyRow,
+                                     const float* pIntensityAbove,
+                                     const float* pIntensityRow,
+                                     const uchar* pMarkedRow,
+                                     float* pTotalEnergyRow,
+                                     int32_t* pPreviousLocationRow,
+                                     size_t startColumn,
+                                     size_t endColumn,
+                                     size_t numColumns,
+                                     float posInf,
+                                     bool bVectorize)
+        {
+            auto scalarRow = [&](size_t rangeStartColumn, size_t rangeEndColumn)
+            {
+                if (pIntensityRow)
+                {
+                    cumulativeForwardEnergyRowScalar(pTotalEnergyAbove, pPixelEnergyRow,
+                                                     pIntensityAbove, pIntensityRow, pMarkedRow,
+                                                     pTotalEnergyRow, pPreviousLocationRow,
+                                                     rangeStartColumn, rangeEndColumn,
+                                                     numColumns, posInf);
+                }
+                else
+                {
+                    cumulativePathEnergyRowScalar(pTotalEnergyAbove, pPixelEnergyRow, pMarkedRow,
+                                                  pTotalEnergyRow, pPreviousLocationRow,
+                                                  rangeStartColumn, rangeEndColumn,
+                                                  numColumns, posInf);
+                }
+            };
+
+            size_t column = startColumn;
+
+#if CV_SIMD
+            if (bVectorize && numColumns > 2)
+            {
+                // border columns are missing a neighbour, so leave them to the scalar path
+                size_t interiorStartColumn = std::max(startColumn, (size_t)1);
+                size_t interiorEndColumn = std::min(endColumn, numColumns - 1);
+
+                if (interiorStartColumn < interiorEndColumn)
+                {
+                    scalarRow(startColumn, interiorStartColumn);
+
+                    if (pIntensityRow)
+                    {
+                        column = cumulativeForwardEnergyRowSIMD(pTotalEnergyAbove,
+                                                                pPixelEnergyRow,
+                                                                pIntensityAbove, pIntensityRow,
+                                                                pMarkedRow, pTotalEnergyRow,
+                                                                pPreviousLocationRow,
+                                                                interiorStartColumn,
+                                                                interiorEndColumn,
+                                                                posInf);
+                    }
+                    else
+                    {
+                        column = cumulativePathEnergyRowSIMD(pTotalEnergyAbove, pPixelEnergyRow,
+                                                             pMarkedRow, pTotalEnergyRow,
+                                                             pPreviousLocationRow,
+                                                             interiorStartColumn,
+                                                             interiorEndColumn,
+                                                             posInf);
+                    }
+                }
+            }
+#else
+            CV_UNUSED(bVectorize);
+#endif
+
+            // remaining columns (or the whole range if not vectorized)
+            scalarRow(column, endColumn);
+        }
+    }
+}
 
 cv::VerticalSeamCarver::VerticalSeamCarver(
     double marginEnergy,
@@ -107,31 +518,57 @@ void cv::VerticalSeamCarver::runSeamRemover(size_t numSeamsToRemove,
                                             const cv::Mat& image,
                                             cv::Mat& outImage)
 {
-    try
+    if (bNeedToInitializeLocalData ||
+        (size_t)image.rows != numRows_ ||
+        (size_t)image.cols != numColumns_)
     {
-        if (bNeedToInitializeLocalData)
-        {
-            init(image, image.rows);
-        }
+        init(image, image.rows);
+    }
 
-        // check if removing more seams than columns available
-        if (numSeamsToRemove > numColumns_)
-        {
-            CV_Error(Error::Code::StsBadArg, "Removing more seams than columns available");
-        }
+    // check if removing more seams than columns available
+    if (numSeamsToRemove > numColumns_)
+    {
+        CV_Error(Error::Code::StsBadArg, "Removing more seams than columns available");
+    }
 
-        // set number of seams to remove this pass
-        numSeamsToRemove_ = numSeamsToRemove;
+    // set number of seams to remove this pass
+    numSeamsToRemove_ = numSeamsToRemove;
 
-        // reset vectors to their clean state
-        resetLocalVectors();
+    // reset vectors to their clean state
+    resetLocalVectors();
+
+    findAndRemoveSeams(image, outImage);
+}
 
-        findAndRemoveSeams(image, outImage);
+void cv::VerticalSeamCarver::runSeamInserter(size_t numSeamsToInsert,
+                                             const cv::Mat& image,
+                                             cv::Mat& outImage)
+{
+    if (bNeedToInitializeLocalData ||
+        (size_t)image.rows != numRows_ ||
+        (size_t)image.cols != numColumns_)
+    {
+        init(image, image.rows);
     }
-    catch (...)
+
+    // inserted seams can't overlap, so at most one per column
+    if (numSeamsToInsert > numColumns_)
     {
-        throw;
+        CV_Error(Error::Code::StsBadArg, "Inserting more seams than columns available");
     }
+
+    // seams to insert are discovered exactly like seams to remove
+    numSeamsToRemove_ = numSeamsToInsert;
+
+    // reset vectors to their clean state
+    resetLocalVectors();
+
+    findAndInsertSeams(image, outImage);
+}
+
+double cv::VerticalSeamCarver::getRemovedSeamsEnergy() const
+{
+    return removedSeamsEnergy_;
 }
 
 void cv::VerticalSeamCarver::setDimensions(size_t numRows, size_t numColumns)
@@ -141,14 +578,7 @@ void cv::VerticalSeamCarver::setDimensions(size_t numRows, size_t numColumns)
         CV_Error(Error::Code::StsBadArg, "setDimensions failed due bad dimensions");
     }
 
-    try
-    {
-        init(numRows, numColumns, numRows);
-    }
-    catch (...)
-    {
-        throw;
-    }
+    init(numRows, numColumns, numRows);
 }
 
 void cv::VerticalSeamCarver::setDimensions(const cv::Mat& image)
@@ -158,14 +588,7 @@ void cv::VerticalSeamCarver::setDimensions(const cv::Mat& image)
         CV_Error(Error::Code::StsBadArg, "setDimensions failed due to empty image");
     }
 
-    try
-    {
-        setDimensions((size_t)image.rows, (size_t)image.cols);
-    }
-    catch (...)
-    {
-        throw;
-    }
+    setDimensions((size_t)image.rows, (size_t)image.cols);
 }
 
 inline bool cv::VerticalSeamCarver::areDimensionsInitialized() const
@@ -188,16 +611,151 @@ void cv::VerticalSeamCarver::setPixelEnergyCalculator(PixelEnergy2D* pNewPixelEn
     pPixelEnergyCalculator_ = pNewPixelEnergyCalculator;
 }
 
-void cv::VerticalSeamCarver::init(const cv::Mat& img, size_t seamLength)
+void cv::VerticalSeamCarver::setEnergyMap(const cv::Mat& newEnergyMap)
 {
-    try
+    if (newEnergyMap.empty() || newEnergyMap.channels() != 1)
     {
-        init((size_t)img.rows, (size_t)img.cols, seamLength);
+        CV_Error(Error::Code::StsBadArg,
+                 "setEnergyMap failed due to an empty or multi channel energy map");
     }
-    catch (...)
+
+    newEnergyMap.convertTo(energyMap, CV_32F);
+}
+
+void cv::VerticalSeamCarver::clearEnergyMap()
+{
+    energyMap.release();
+}
+
+void cv::VerticalSeamCarver::addEnergyWeights(const cv::Mat& weights)
+{
+    if (weights.empty() || weights.channels() != 1)
     {
-        throw;
+        CV_Error(Error::Code::StsBadArg,
+                 "addEnergyWeights failed due to empty or multi channel weights");
+    }
+
+    if (!energyWeights.empty() && energyWeights.size() != weights.size())
+    {
+        CV_Error(Error::Code::StsBadArg,
+                 "addEnergyWeights failed due to weights of a different size");
+    }
+
+    if (energyWeights.empty())
+    {
+        weights.convertTo(energyWeights, CV_32F);
+    }
+    else
+    {
+        cv::add(energyWeights, weights, energyWeights, cv::noArray(), CV_32F);
+    }
+}
+
+void cv::VerticalSeamCarver::addProtectMask(const cv::Mat& mask, double weight)
+{
+    addMaskWeight(mask, weight);
+}
+
+void cv::VerticalSeamCarver::addRemoveMask(const cv::Mat& mask, double weight)
+{
+    addMaskWeight(mask, -weight);
+}
+
+void cv::VerticalSeamCarver::clearEnergyWeights()
+{
+    energyWeights.release();
+}
+
+void cv::VerticalSeamCarver::addMaskWeight(const cv::Mat& mask, double weight)
+{
+    if (mask.empty() || mask.type() != CV_8UC1)
+    {
+        CV_Error(Error::Code::StsBadArg, "Mask must be a non-empty CV_8UC1 matrix");
+    }
+
+    if (!energyWeights.empty() && energyWeights.size() != mask.size())
+    {
+        CV_Error(Error::Code::StsBadArg, "Mask size doesn't match the previous weights");
+    }
+
+    if (energyWeights.empty())
+    {
+        energyWeights.create(mask.size(), CV_32FC1);
+        energyWeights.setTo(cv::Scalar::all(0));
+    }
+
+    // masks may overlap, so weights accumulate
+    cv::add(energyWeights, cv::Scalar::all(weight), energyWeights, mask);
+}
+
+void cv::VerticalSeamCarver::setVectorization(bool bEnable)
+{
+    bVectorizationEnabled_ = bEnable;
+}
+
+bool cv::VerticalSeamCarver::isVectorizationEnabled() const
+{
+    return bVectorizationEnabled_;
+}
+
+void cv::VerticalSeamCarver::setNumThreads(size_t numThreads)
+{
+    if (numThreads == 0)
+    {
+        CV_Error(Error::Code::StsBadArg, "setNumThreads failed due to zero threads");
+    }
+
+    numThreads_ = numThreads;
+}
+
+size_t cv::VerticalSeamCarver::getNumThreads() const
+{
+    return numThreads_;
+}
+
+void cv::VerticalSeamCarver::setIncrementalMode(bool bEnable)
+{
+    bIncrementalModeEnabled_ = bEnable;
+}
+
+bool cv::VerticalSeamCarver::isIncrementalModeEnabled() const
+{
+    return bIncrementalModeEnabled_;
+}
+
+void cv::VerticalSeamCarver::setSeamSearchStrategy(SeamSearchStrategy strategy)
+{
+    if (strategy != SEAM_SEARCH_RESTART && strategy != SEAM_SEARCH_CONE_UPDATE)
+    {
+        CV_Error(Error::Code::StsBadArg, "setSeamSearchStrategy failed due to unknown strategy");
     }
+
+    seamSearchStrategy_ = strategy;
+}
+
+cv::VerticalSeamCarver::SeamSearchStrategy cv::VerticalSeamCarver::getSeamSearchStrategy() const
+{
+    return seamSearchStrategy_;
+}
+
+void cv::VerticalSeamCarver::setForwardEnergy(bool bEnable)
+{
+    bForwardEnergyEnabled_ = bEnable;
+}
+
+bool cv::VerticalSeamCarver::isForwardEnergyEnabled() const
+{
+    return bForwardEnergyEnabled_;
+}
+
+size_t cv::VerticalSeamCarver::getNumAllocations() const
+{
+    return numAllocations_;
+}
+
+void cv::VerticalSeamCarver::init(const cv::Mat& img, size_t seamLength)
+{
+    init((size_t)img.rows, (size_t)img.cols, seamLength);
 }
 
 void cv::VerticalSeamCarver::init(size_t numRows, size_t numColumns, size_t seamLength)
@@ -222,33 +780,40 @@ inline void cv::VerticalSeamCarver::initializeLocalVariables(size_t numRows,
 
 void cv::VerticalSeamCarver::initializeLocalVectors()
 {
-    pixelEnergy.resize(numRows_);
-    markedPixels.resize(numRows_);
-    totalEnergyTo.resize(numRows_);
-    previousLocationTo.resize(numRows_);
+    reserveWorkspaceMat(numRows_, numColumns_, CV_32FC1, pixelEnergy);
+    reserveWorkspaceMat(numRows_, numColumns_, CV_8UC1, markedPixels);
+    reserveWorkspaceMat(numRows_, numColumns_, CV_32FC1, totalEnergyTo);
+    reserveWorkspaceMat(numRows_, numColumns_, CV_32SC1, previousLocationTo);
 
-    for (size_t row = 0; row < numRows_; row++)
+    // only grow, so the seam queues of taller images stay allocated for later reuse
+    if (currentSeam.size() < seamLength_)
     {
-        pixelEnergy[row].resize(numColumns_);
-        markedPixels[row].resize(numColumns_);
-        totalEnergyTo[row].resize(numColumns_);
-        previousLocationTo[row].resize(numColumns_);
+        currentSeam.resize(seamLength_);
+    }
+    if (discoveredSeams.size() < seamLength_)
+    {
+        discoveredSeams.resize(seamLength_);
     }
-
-    currentSeam.resize(seamLength_);
-    discoveredSeams.resize(seamLength_);
 }
 
-void cv::VerticalSeamCarver::resetLocalVectors()
+void cv::VerticalSeamCarver::reserveWorkspaceMat(size_t numRows,
+                                                 size_t numColumns,
+                                                 int type,
+                                                 cv::Mat& outMat)
 {
-    for (size_t row = 0; row < numRows_; row++)
+    if (!reuseRowAlignedMat(numRows, numColumns, type, outMat))
     {
-        // set marked pixels to false for new run
-        for (size_t column = 0; column < numColumns_; column++)
-        {
-            markedPixels[row][column] = false;
-        }
+        allocateRowAlignedMat(numRows, numColumns, type, outMat);
+        numAllocations_++;
     }
+}
+
+void cv::VerticalSeamCarver::resetLocalVectors()
+{
+    // set marked pixels to false for new run
+    markedPixels.setTo(cv::Scalar::all(0));
+
+    removedSeamsEnergy_ = 0.0;
 
     for (size_t seamNum = 0; seamNum < seamLength_; seamNum++)
     {
@@ -256,6 +821,7 @@ void cv::VerticalSeamCarver::resetLocalVectors()
         if (numSeamsToRemove_ > discoveredSeams[seamNum].capacity())
         {
             discoveredSeams[seamNum].allocate(numSeamsToRemove_);
+            numAllocations_++;
         }
 
         // reset priority queue since it could be filled from a previous run
@@ -268,72 +834,362 @@ void cv::VerticalSeamCarver::resetLocalVectors()
 
 void cv::VerticalSeamCarver::findAndRemoveSeams(const cv::Mat& image, cv::Mat& outImage)
 {
+    if (bIncrementalModeEnabled_)
+    {
+        findAndRemoveSeamsIncremental(image, outImage);
+        return;
+    }
+
     numColorChannels_ = (size_t)image.channels();
 
-    if (numColorChannels_ == 3)
+    if (numColorChannels_ != 3 && numColorChannels_ != 1)
     {
-        if (bgr.size() != 3)
+        CV_Error(Error::Code::StsInternal, "VerticalSeamCarver::findAndRemoveSeams failed due to \
+                                            incorrect number of color channels");
+    }
+
+    // find pixel energy (or intensity) for this pass
+    calculateEnergy(image);
+
+    // find all vertical seams
+    findSeams();
+
+    // remove all found seams straight from the interleaved image
+    removeSeams(image, outImage);
+}
+
+void cv::VerticalSeamCarver::findAndInsertSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // find pixel energy (or intensity) for this pass
+    calculateEnergy(image);
+
+    // find all vertical seams (non-overlapping, lowest cumulative energy first)
+    findSeams();
+
+    // duplicate all found seams in one pass over the image
+    insertSeams(image, outImage);
+}
+
+void cv::VerticalSeamCarver::insertSeams(const cv::Mat& image, cv::Mat& outImage)
+{
+    // each row of seams stores an ordered queue of columns to duplicate, min column first
+    // the runs of pixels between seam columns are copied as is and every seam pixel is followed
+    //      by the average of itself and its right neighbour
+    const size_t pixelSize = image.elemSize();
+    const size_t numChannels = (size_t)image.channels();
+    const int depth = image.depth();
+
+    // write into a separate matrix in case outImage shares its data with image
+    cv::Mat enlargedImage(image.rows, image.cols + (int)numSeamsToRemove_, image.type());
+
+    for (size_t row = 0; row < numRows_; row++)
+    {
+        const uchar* pImageRow = image.ptr<uchar>((int)row);
+        uchar* pEnlargedRow = enlargedImage.ptr<uchar>((int)row);
+
+        size_t sourceColumn = 0;
+        while (!discoveredSeams[row].empty())
         {
-            bgr.resize(3);
+            const size_t seamColumn = (size_t)discoveredSeams[row].pop();
+            const size_t runLength = seamColumn + 1 - sourceColumn;
+
+            // copy up to and including the seam pixel
+            std::memcpy(pEnlargedRow, pImageRow + sourceColumn * pixelSize, runLength * pixelSize);
+            pEnlargedRow += runLength * pixelSize;
+
+            const size_t neighbourColumn = seamColumn < rightColumn_ ? seamColumn + 1 : seamColumn;
+            averagePixels(pImageRow + seamColumn * pixelSize,
+                          pImageRow + neighbourColumn * pixelSize,
+                          pEnlargedRow,
+                          depth,
+                          numChannels);
+            pEnlargedRow += pixelSize;
+
+            sourceColumn = seamColumn + 1;
         }
 
-        cv::split(image, bgr);
+        // copy the pixels after the last seam
+        std::memcpy(pEnlargedRow,
+                    pImageRow + sourceColumn * pixelSize,
+                    (numColumns_ - sourceColumn) * pixelSize);
+    }
+
+    outImage = enlargedImage;
+}
+
+void cv::VerticalSeamCarver::findAndRemoveSeamsIncremental(const cv::Mat& image,
+                                                           cv::Mat& outImage)
+{
+    const size_t originalNumColumns = numColumns_;
+
+    // seams are removed from a private copy of the image, and of the weights which are added
+    //      to the recalculated pixel energy
+    image.copyTo(carvedImage);
+    if (!energyWeights.empty())
+    {
+        energyWeights.copyTo(carvedEnergyWeights);
     }
-    else if (numColorChannels_ == 1)
+
+    try
     {
-        if (bgr.size() != 1)
+        // full pixel energy and cumulative energy calculation only happens once per run
+        calculateEnergy(carvedImage);
+        calculateCumulativePathEnergy();
+
+        for (size_t n = 0; n < numSeamsToRemove_ && numColumns_ > 1; n++)
         {
-            bgr.resize(1);
+            findLeastEnergySeam();
+            removeSeamIncremental();
         }
 
-        cv::extractChannel(image, bgr[0], 0);
+        carvedImage.colRange(0, (int)numColumns_).copyTo(outImage);
     }
-    else
+    catch (...)
     {
-        CV_Error(Error::Code::StsInternal, "VerticalSeamCarver::findAndRemoveSeams failed due to \
-                                            incorrect number of color channels");
+        numColumns_ = originalNumColumns;
+        rightColumn_ = numColumns_ - 1;
+        throw;
     }
 
-    try
+    // working buffers keep their allocated width, so only the dimensions need restoring
+    numColumns_ = originalNumColumns;
+    rightColumn_ = numColumns_ - 1;
+}
+
+void cv::VerticalSeamCarver::findLeastEnergySeam()
+{
+    // find the least cumulative energy pixel in the bottom row
+    const float* pTotalEnergyBottomRow = totalEnergyTo.ptr<float>((int)bottomRow_);
+    size_t minTotalEnergyColumn = 0;
+    for (size_t column = 1; column < numColumns_; column++)
+    {
+        if (pTotalEnergyBottomRow[column] < pTotalEnergyBottomRow[minTotalEnergyColumn])
+        {
+            minTotalEnergyColumn = column;
+        }
+    }
+
+    if (!(pTotalEnergyBottomRow[minTotalEnergyColumn] < posInf_))
+    {
+        CV_Error(Error::Code::StsInternal,
+                 "VerticalSeamCarver::findLeastEnergySeam() failed due to no reachable seam");
+    }
+
+    removedSeamsEnergy_ += pTotalEnergyBottomRow[minTotalEnergyColumn];
+
+    // follow the parents back up to the top row
+    currentSeam[bottomRow_] = minTotalEnergyColumn;
+    for (size_t row = bottomRow_; row > 0; row--)
+    {
+        currentSeam[row - 1] =
+            (size_t)previousLocationTo.ptr<int32_t>((int)row)[currentSeam[row]];
+    }
+}
+
+void cv::VerticalSeamCarver::removeSeamIncremental()
+{
+    // rows of the cone of influence whose pixel energy is recalculated with one call
+    const size_t energyStripHeight = 16;
+
+    const size_t pixelSize = carvedImage.elemSize();
+
+    /*** SHIFT EVERYTHING RIGHT OF THE SEAM ONE COLUMN TO THE LEFT ***/
+    // only the columns right of the seam move, but that is still half of every row on average,
+    //      so this pass is O(rows * columns) per seam while everything after it is bounded by
+    //      the cone of influence
+    for (size_t row = 0; row < numRows_; row++)
+    {
+        const size_t seamColumn = currentSeam[row];
+        const size_t numShiftedColumns = numColumns_ - 1 - seamColumn;
+
+        uchar* pImageRow = carvedImage.ptr<uchar>((int)row);
+        std::memmove(pImageRow + seamColumn * pixelSize,
+                     pImageRow + (seamColumn + 1) * pixelSize,
+                     numShiftedColumns * pixelSize);
+
+        float* pPixelEnergyRow = pixelEnergy.ptr<float>((int)row);
+        std::memmove(pPixelEnergyRow + seamColumn,
+                     pPixelEnergyRow + seamColumn + 1,
+                     numShiftedColumns * sizeof(float));
+
+        float* pTotalEnergyRow = totalEnergyTo.ptr<float>((int)row);
+        std::memmove(pTotalEnergyRow + seamColumn,
+                     pTotalEnergyRow + seamColumn + 1,
+                     numShiftedColumns * sizeof(float));
+
+        if (!energyWeights.empty())
+        {
+            float* pEnergyWeightsRow = carvedEnergyWeights.ptr<float>((int)row);
+            std::memmove(pEnergyWeightsRow + seamColumn,
+                         pEnergyWeightsRow + seamColumn + 1,
+                         numShiftedColumns * sizeof(float));
+        }
+
+        if (bForwardEnergyEnabled_)
+        {
+            float* pIntensityRow = intensity.ptr<float>((int)row);
+            std::memmove(pIntensityRow + seamColumn,
+                         pIntensityRow + seamColumn + 1,
+                         numShiftedColumns * sizeof(float));
+        }
+
+        uchar* pMarkedRow = markedPixels.ptr<uchar>((int)row);
+        std::memmove(pMarkedRow + seamColumn,
+                     pMarkedRow + seamColumn + 1,
+                     numShiftedColumns);
+
+        int32_t* pPreviousLocationRow = previousLocationTo.ptr<int32_t>((int)row);
+        std::memmove(pPreviousLocationRow + seamColumn,
+                     pPreviousLocationRow + seamColumn + 1,
+                     numShiftedColumns * sizeof(int32_t));
+
+        // parents to the right of the seam pixel in the row above moved left as well
+        // a parent is at most 2 columns right of its (shifted) pixel, so columns further left
+        //      than that can't point past the seam; the branchless update vectorizes
+        if (row > 0)
+        {
+            const int32_t parentSeamColumn = (int32_t)currentSeam[row - 1];
+            const size_t startColumn = (size_t)std::max(0, parentSeamColumn - 2);
+            for (size_t column = startColumn; column < numColumns_ - 1; column++)
+            {
+                pPreviousLocationRow[column] -=
+                    (int32_t)(pPreviousLocationRow[column] > parentSeamColumn);
+            }
+        }
+    }
+
+    numColumns_--;
+    rightColumn_ = numColumns_ - 1;
+
+    // the pixels next to the seam (and between the seam columns of adjacent rows) have new
+    //      neighbours, so their energy and parents must be recalculated
+    auto getDirtyColumns = [this](size_t row, size_t& startColumn, size_t& endColumn)
     {
-        // find pixel energy for this pass
-        pPixelEnergyCalculator_->calculatePixelEnergy(image, pixelEnergy);
+        const size_t seamAbove = currentSeam[row > 0 ? row - 1 : row];
+        const size_t seamBelow = currentSeam[row < bottomRow_ ? row + 1 : row];
+        const size_t minSeamColumn = std::min(std::min(seamAbove, seamBelow), currentSeam[row]);
+        const size_t maxSeamColumn = std::max(std::max(seamAbove, seamBelow), currentSeam[row]);
+
+        startColumn = minSeamColumn > 0 ? minSeamColumn - 1 : 0;
+        endColumn = std::min(maxSeamColumn + 1, numColumns_);
+    };
+
+    /*** RECALCULATE PIXEL ENERGY NEXT TO THE SEAM ***/
+    // forward energy costs only depend on the intensity of neighbours and a precomputed energy
+    //      map belongs to its pixels, both of which moved along with the pixels, so there is
+    //      nothing to recalculate
+    const bool bRecalculatePixelEnergy = !bForwardEnergyEnabled_ && energyMap.empty();
+
+    cv::Mat carvedImageView = carvedImage.colRange(0, (int)numColumns_);
+    cv::Mat pixelEnergyView = pixelEnergy.colRange(0, (int)numColumns_);
+    for (size_t stripStartRow = 0;
+         bRecalculatePixelEnergy && stripStartRow < numRows_;
+         stripStartRow += energyStripHeight)
+    {
+        const size_t stripEndRow = std::min(stripStartRow + energyStripHeight, numRows_);
+
+        size_t stripStartColumn = numColumns_;
+        size_t stripEndColumn = 0;
+        for (size_t row = stripStartRow; row < stripEndRow; row++)
+        {
+            size_t startColumn = 0;
+            size_t endColumn = 0;
+            getDirtyColumns(row, startColumn, endColumn);
+
+            stripStartColumn = std::min(stripStartColumn, startColumn);
+            stripEndColumn = std::max(stripEndColumn, endColumn);
+        }
+
+        if (stripStartColumn < stripEndColumn)
+        {
+            const cv::Rect strip((int)stripStartColumn,
+                                 (int)stripStartRow,
+                                 (int)(stripEndColumn - stripStartColumn),
+                                 (int)(stripEndRow - stripStartRow));
+
+            pPixelEnergyCalculator_->calculatePixelEnergyForRegion(carvedImageView,
+                                                                   strip,
+                                                                   pixelEnergyView);
 
-        // find all vertical seams
-        findSeams();
+            if (!energyWeights.empty())
+            {
+                cv::Mat pixelEnergyStrip = pixelEnergyView(strip);
+                cv::add(pixelEnergyStrip, carvedEnergyWeights(strip), pixelEnergyStrip);
+            }
+        }
+    }
 
-        // remove all found seams, least cumulative energy first
-        removeSeams();
+    /*** RECALCULATE CUMULATIVE ENERGY INSIDE THE CONE OF INFLUENCE ***/
+    // the top row only holds the margin energy, so changes start at the second row
+    // a change in the row above can only reach one column further on each side
+    size_t changedStartColumn = 0;
+    size_t changedEndColumn = 0;
 
-        // combine separate channels into output image
-        cv::merge(bgr, outImage);
+    if (previousTotalEnergyRow.size() < numColumns_)
+    {
+        previousTotalEnergyRow.resize(numColumns_);
     }
-    catch (const cv::Exception& caughtException)
+
+    for (size_t row = 1; row < numRows_; row++)
     {
-        throw caughtException;
+        size_t startColumn = 0;
+        size_t endColumn = 0;
+        getDirtyColumns(row, startColumn, endColumn);
+
+        if (changedStartColumn < changedEndColumn)
+        {
+            startColumn = std::min(startColumn,
+                                   changedStartColumn > 0 ? changedStartColumn - 1 : 0);
+            endColumn = std::max(endColumn, std::min(changedEndColumn + 1, numColumns_));
+        }
+
+        float* pTotalEnergyRow = totalEnergyTo.ptr<float>((int)row);
+        std::copy(pTotalEnergyRow + startColumn,
+                  pTotalEnergyRow + endColumn,
+                  previousTotalEnergyRow.begin() + startColumn);
+
+        calculateCumulativePathEnergyRow(row, startColumn, endColumn);
+
+        // narrow the cone to the columns whose cumulative energy actually changed
+        changedStartColumn = endColumn;
+        changedEndColumn = startColumn;
+        for (size_t column = startColumn; column < endColumn; column++)
+        {
+            if (pTotalEnergyRow[column] != previousTotalEnergyRow[column])
+            {
+                changedStartColumn = std::min(changedStartColumn, column);
+                changedEndColumn = column + 1;
+            }
+        }
     }
 }
 
 void cv::VerticalSeamCarver::findSeams()
 {
-    if (pixelEnergy.size() == 0)
+    if (pixelEnergy.empty())
     {
         CV_Error(Error::Code::StsInternal,
-                 "SeamCarver::findSeams() failed due to zero-size pixelEnergy vector");
+                 "SeamCarver::findSeams() failed due to zero-size pixelEnergy matrix");
     }
 
-    if (discoveredSeams.size() != pixelEnergy.size())
+    if (discoveredSeams.size() < (size_t)pixelEnergy.rows)
     {
         CV_Error(Error::Code::StsInternal,
                  "SeamCarver::findSeams() failed due to different sized vectors");
     }
 
+    if (seamSearchStrategy_ == SEAM_SEARCH_CONE_UPDATE)
+    {
+        findSeamsWithConeUpdates();
+        return;
+    }
+
     // initial cumulative energy path calculation
     calculateCumulativePathEnergy();
 
     // declare/initialize variables used in currentSeam discovery when looking for the least
     //      cumulative energy column in the bottom row
-    double minTotalEnergy = posInf_;
+    float minTotalEnergy = posInf_;
     int32_t minTotalEnergyColumn = -1;
     bool bRestartSeamDiscovery = false;   // seam discovery needs to be restarted for currentSeam
 
@@ -341,6 +1197,9 @@ void cv::VerticalSeamCarver::findSeams()
     size_t prevColumn = 0;
     size_t currentColumn = 0;
 
+    float* pTotalEnergyBottomRow = totalEnergyTo.ptr<float>((int)bottomRow_);
+    const uchar* pMarkedBottomRow = markedPixels.ptr<uchar>((int)bottomRow_);
+
     /*** RUN SEAM DISCOVERY ***/
     for (int32_t n = 0; n < (int32_t)numSeamsToRemove_; n++)
     {
@@ -350,10 +1209,9 @@ void cv::VerticalSeamCarver::findSeams()
         minTotalEnergyColumn = -1;
         for (size_t column = 0; column < numColumns_; column++)
         {
-            if (!markedPixels[bottomRow_][column] &&
-                totalEnergyTo[bottomRow_][column] < minTotalEnergy)
+            if (!pMarkedBottomRow[column] && pTotalEnergyBottomRow[column] < minTotalEnergy)
             {
-                minTotalEnergy = totalEnergyTo[bottomRow_][column];
+                minTotalEnergy = pTotalEnergyBottomRow[column];
                 minTotalEnergyColumn = column;
             }
         }
@@ -385,14 +1243,14 @@ void cv::VerticalSeamCarver::findSeams()
         {
             // using the below pixel's row and column, extract the column of the pixel in the
             //      current row
-            currentColumn = previousLocationTo[(size_t)row + 1][prevColumn];
+            currentColumn = previousLocationTo.ptr<int32_t>(row + 1)[prevColumn];
 
             // check if the current pixel of the current seam has been used part of another seam
-            if (markedPixels[(size_t)row][currentColumn])
+            if (markedPixels.ptr<uchar>(row)[currentColumn])
             {
                 // mark the starting pixel in bottom row as having +INF cumulative energy so it
                 //      will not be chosen again
-                totalEnergyTo[bottomRow_][minTotalEnergyColumn] = posInf_;
+                pTotalEnergyBottomRow[minTotalEnergyColumn] = posInf_;
 
                 // decrement seam iterator since this seam is invalid and this iteration will
                 // need to be restarted
@@ -418,174 +1276,422 @@ void cv::VerticalSeamCarver::findSeams()
         }
         else
         {
-            // copy current seam into the discovered seams and mark appropriate pixels
-            for (size_t row = 0; row < numRows_; row++)
+            removedSeamsEnergy_ += minTotalEnergy;
+
+            addCurrentSeam();
+        }
+    }   // for (int32_t n = 0; n < (int32_t)numSeamsToRemove_; n++)
+}
+
+void cv::VerticalSeamCarver::findSeamsWithConeUpdates()
+{
+    // the cumulative energy is always up to date with the marked pixels, so the least energy
+    //      seam never runs into a previous seam
+    calculateCumulativePathEnergy();
+
+    for (size_t n = 0; n < numSeamsToRemove_; n++)
+    {
+        findLeastEnergySeam();
+        addCurrentSeam();
+
+        if (n + 1 < numSeamsToRemove_)
+        {
+            updateCumulativePathEnergyBelowSeam();
+        }
+    }
+}
+
+void cv::VerticalSeamCarver::updateCumulativePathEnergyBelowSeam()
+{
+    // a marked pixel becomes unreachable, which can only change the pixels below it that
+    //      reach one column further on each side per row, and only as long as the cumulative
+    //      energy of the row above actually changed
+    if (previousTotalEnergyRow.size() < numColumns_)
+    {
+        previousTotalEnergyRow.resize(numColumns_);
+    }
+
+    const size_t topSeamColumn = currentSeam[0];
+    totalEnergyTo.ptr<float>(0)[topSeamColumn] = posInf_;
+    previousLocationTo.ptr<int32_t>(0)[topSeamColumn] = -1;
+
+    size_t changedStartColumn = topSeamColumn;
+    size_t changedEndColumn = topSeamColumn + 1;
+
+    for (size_t row = 1; row < numRows_; row++)
+    {
+        // the seam pixel of this row always changes
+        size_t startColumn = currentSeam[row];
+        size_t endColumn = currentSeam[row] + 1;
+
+        if (changedStartColumn < changedEndColumn)
+        {
+            startColumn = std::min(startColumn,
+                                   changedStartColumn > 0 ? changedStartColumn - 1 : 0);
+            endColumn = std::max(endColumn, std::min(changedEndColumn + 1, numColumns_));
+        }
+
+        float* pTotalEnergyRow = totalEnergyTo.ptr<float>((int)row);
+        std::copy(pTotalEnergyRow + startColumn,
+                  pTotalEnergyRow + endColumn,
+                  previousTotalEnergyRow.begin() + startColumn);
+
+        calculateCumulativePathEnergyRow(row, startColumn, endColumn);
+
+        // narrow the cone to the columns whose cumulative energy actually changed
+        changedStartColumn = endColumn;
+        changedEndColumn = startColumn;
+        for (size_t column = startColumn; column < endColumn; column++)
+        {
+            if (pTotalEnergyRow[column] != previousTotalEnergyRow[column])
             {
-                currentColumn = currentSeam[row];
-                discoveredSeams[row].push(currentColumn);
-                markedPixels[row][currentColumn] = true;
+                changedStartColumn = std::min(changedStartColumn, column);
+                changedEndColumn = column + 1;
             }
         }
-    }   // for (int32_t n = 0; n < (int32_t)numSeamsToRemove_; n++)
+    }
+}
+
+bool cv::VerticalSeamCarver::findSeamInBand(const std::vector<size_t>& guideSeam,
+                                             size_t bandWidth)
+{
+    // columns [startColumn, endColumn) of a row are inside the band
+    auto getBand = [this, &guideSeam, bandWidth](size_t row,
+                                                size_t& startColumn,
+                                                size_t& endColumn)
+    {
+        const size_t guideColumn = std::min(guideSeam[row], rightColumn_);
+        startColumn = guideColumn > bandWidth ? guideColumn - bandWidth : 0;
+        endColumn = std::min(guideColumn + bandWidth + 1, numColumns_);
+    };
+
+    size_t startColumn = 0;
+    size_t endColumn = 0;
+
+    // top row of the band
+    getBand(0, startColumn, endColumn);
+    float* pTotalEnergyTopRow = totalEnergyTo.ptr<float>(0);
+    int32_t* pPreviousLocationTopRow = previousLocationTo.ptr<int32_t>(0);
+    const uchar* pMarkedTopRow = markedPixels.ptr<uchar>(0);
+    for (size_t column = startColumn; column < endColumn; column++)
+    {
+        pTotalEnergyTopRow[column] = pMarkedTopRow[column] ? posInf_ : (float)marginEnergy_;
+        pPreviousLocationTopRow[column] = -1;
+    }
+
+    // cumulative energy sweep restricted to the band
+    for (size_t row = 1; row < numRows_; row++)
+    {
+        const size_t startColumnAbove = startColumn;
+        const size_t endColumnAbove = endColumn;
+        getBand(row, startColumn, endColumn);
+
+        // the parents outside of the band in the row above must be unreachable
+        float* pTotalEnergyAbove = totalEnergyTo.ptr<float>((int)row - 1);
+        for (size_t column = startColumn > 0 ? startColumn - 1 : 0;
+             column < startColumnAbove;
+             column++)
+        {
+            pTotalEnergyAbove[column] = posInf_;
+        }
+        for (size_t column = endColumnAbove;
+             column < std::min(endColumn + 1, numColumns_);
+             column++)
+        {
+            pTotalEnergyAbove[column] = posInf_;
+        }
+
+        calculateCumulativePathEnergyRow(row, startColumn, endColumn);
+    }
+
+    // find the least cumulative energy pixel in the bottom row of the band
+    const float* pTotalEnergyBottomRow = totalEnergyTo.ptr<float>((int)bottomRow_);
+    size_t minTotalEnergyColumn = startColumn;
+    for (size_t column = startColumn + 1; column < endColumn; column++)
+    {
+        if (pTotalEnergyBottomRow[column] < pTotalEnergyBottomRow[minTotalEnergyColumn])
+        {
+            minTotalEnergyColumn = column;
+        }
+    }
+
+    // every path through the band crosses a marked pixel
+    if (!(pTotalEnergyBottomRow[minTotalEnergyColumn] < posInf_))
+    {
+        return false;
+    }
+
+    removedSeamsEnergy_ += pTotalEnergyBottomRow[minTotalEnergyColumn];
+
+    // follow the parents back up to the top row
+    currentSeam[bottomRow_] = minTotalEnergyColumn;
+    for (size_t row = bottomRow_; row > 0; row--)
+    {
+        currentSeam[row - 1] =
+            (size_t)previousLocationTo.ptr<int32_t>((int)row)[currentSeam[row]];
+    }
+
+    return true;
+}
+
+void cv::VerticalSeamCarver::addCurrentSeam()
+{
+    // copy current seam into the discovered seams and mark appropriate pixels
+    for (size_t row = 0; row < numRows_; row++)
+    {
+        const size_t column = currentSeam[row];
+        discoveredSeams[row].push((int32_t)column);
+        markedPixels.ptr<uchar>((int)row)[column] = 1;
+    }
+}
+
+void cv::VerticalSeamCarver::calculateEnergy(const cv::Mat& image)
+{
+    // only allocated once forward energy is used
+    if (bForwardEnergyEnabled_ &&
+        (intensity.rows != (int)numRows_ || intensity.cols != (int)numColumns_))
+    {
+        reserveWorkspaceMat(numRows_, numColumns_, CV_32FC1, intensity);
+    }
+
+    calculateImageLayoutEnergy(image, energyMap, energyWeights, intensity, pixelEnergy);
+}
+
+void cv::VerticalSeamCarver::calculateImageLayoutEnergy(const cv::Mat& image,
+                                                        const cv::Mat& imageEnergyMap,
+                                                        const cv::Mat& imageEnergyWeights,
+                                                        cv::Mat& outIntensity,
+                                                        cv::Mat& outPixelEnergy)
+{
+    if (!imageEnergyMap.empty() && imageEnergyMap.size() != image.size())
+    {
+        CV_Error(Error::Code::StsBadArg, "Energy map size doesn't match the image size");
+    }
+
+    if (!imageEnergyWeights.empty() && imageEnergyWeights.size() != image.size())
+    {
+        CV_Error(Error::Code::StsBadArg, "Energy weights size doesn't match the image size");
+    }
+
+    if (bForwardEnergyEnabled_)
+    {
+        calculateIntensity(image, outIntensity);
+
+        // forward energy only needs pixel energy if there is something to add to its costs
+        bAddPixelEnergy_ = !imageEnergyMap.empty() || !imageEnergyWeights.empty();
+        if (!bAddPixelEnergy_)
+        {
+            return;
+        }
+
+        if (!imageEnergyMap.empty())
+        {
+            imageEnergyMap.copyTo(outPixelEnergy);
+        }
+        else
+        {
+            outPixelEnergy.create(image.rows, image.cols, CV_32FC1);
+            outPixelEnergy.setTo(cv::Scalar::all(0));
+        }
+    }
+    else
+    {
+        bAddPixelEnergy_ = true;
+
+        // a precomputed energy map replaces the pixel energy calculator
+        if (!imageEnergyMap.empty())
+        {
+            imageEnergyMap.copyTo(outPixelEnergy);
+        }
+        else
+        {
+            pPixelEnergyCalculator_->calculatePixelEnergy(image, outPixelEnergy);
+        }
+    }
+
+    if (!imageEnergyWeights.empty())
+    {
+        cv::add(outPixelEnergy, imageEnergyWeights, outPixelEnergy);
+    }
 }
 
 void cv::VerticalSeamCarver::calculateCumulativePathEnergy()
 {
     // initialize top row
+    float* pTotalEnergyTopRow = totalEnergyTo.ptr<float>(0);
+    int32_t* pPreviousLocationTopRow = previousLocationTo.ptr<int32_t>(0);
+    const uchar* pMarkedTopRow = markedPixels.ptr<uchar>(0);
     for (size_t column = 0; column < numColumns_; column++)
     {
         // if previously markedPixels, set its energy to +INF
-        if (markedPixels[0][column])
+        if (pMarkedTopRow[column])
         {
-            totalEnergyTo[0][column] = posInf_;
+            pTotalEnergyTopRow[column] = posInf_;
         }
         else
         {
-            totalEnergyTo[0][column] = marginEnergy_;
+            pTotalEnergyTopRow[column] = (float)marginEnergy_;
         }
-        previousLocationTo[0][column] = -1;
+        pPreviousLocationTopRow[column] = -1;
     }
 
-    // cache the total energy to the pixels up/left, directly above, and up/right
-    //   instead of accessing memory for the same pixels
-    // shift energy values to the left and access memory only once
-    // SHIFT OPERATION:
-    //   left/above <== directly above
-    //   directly above <== right/above
-    //   right/above = access new memory
-    double energyUpLeft = posInf_;
-    double energyUp = posInf_;
-    double energyUpRight = posInf_;
+    if (numThreads_ > 1 && numColumns_ > 1)
+    {
+        calculateCumulativePathEnergyParallel();
+        return;
+    }
 
-    bool markedUpLeft = false;
-    bool markedUp = false;
-    bool markedUpRight = false;
+    for (size_t row = 1; row < numRows_; row++)
+    {
+        calculateCumulativePathEnergyRow(row, 0, numColumns_);
+    }
+}
 
-    double minEnergy = posInf_;
-    int32_t minEnergyColumn = -1;
+void cv::VerticalSeamCarver::calculateCumulativePathEnergyRow(size_t row,
+                                                              size_t startColumn,
+                                                              size_t endColumn)
+{
+    // every row is a contiguous run in each working buffer, so the sweep only walks linearly
+    //      through the previous and current rows
+    cumulativePathEnergyRow(totalEnergyTo.ptr<float>((int)row - 1),
+                            bAddPixelEnergy_ ? pixelEnergy.ptr<float>((int)row) : nullptr,
+                            bForwardEnergyEnabled_ ? intensity.ptr<float>((int)row - 1) : nullptr,
+                            bForwardEnergyEnabled_ ? intensity.ptr<float>((int)row) : nullptr,
+                            markedPixels.ptr<uchar>((int)row),
+                            totalEnergyTo.ptr<float>((int)row),
+                            previousLocationTo.ptr<int32_t>((int)row),
+                            startColumn, endColumn,
+                            numColumns_, posInf_,
+                            bVectorizationEnabled_);
+}
 
-    for (size_t row = 1; row < numRows_; row++)
+void cv::VerticalSeamCarver::calculateCumulativePathEnergyParallel()
+{
+    const size_t numTiles = std::min(numThreads_, numColumns_);
+    const size_t tileWidth = (numColumns_ + numTiles - 1) / numTiles;
+
+    // every tile recomputes a halo that widens by one column per row above the bottom of the
+    //      band, so the band height trades redundant work against synchronization points
+    const size_t bandHeight = std::max((size_t)1, std::min((size_t)64, tileWidth / 4));
+
+    // each tile gets a private double buffered cumulative energy row and a parent row so the
+    //      halo columns never touch the shared tables
+    if (tileTotalEnergyTo.rows != (int)(2 * numTiles) || tileTotalEnergyTo.cols != (int)numColumns_)
     {
-        energyUpLeft = posInf_;
-        energyUp = totalEnergyTo[row - 1][0];
-        energyUpRight = numColumns_ > 1 ? totalEnergyTo[row - 1][1] : posInf_;
+        reserveWorkspaceMat(2 * numTiles, numColumns_, CV_32FC1, tileTotalEnergyTo);
+        reserveWorkspaceMat(numTiles, numColumns_, CV_32SC1, tilePreviousLocationTo);
+    }
 
-        markedUpLeft = true;
-        markedUp = markedPixels[row - 1][0];
-        markedUpRight = numColumns_ > 1 ? markedPixels[row - 1][1] : true;
+    for (size_t bandStartRow = 1; bandStartRow < numRows_; bandStartRow += bandHeight)
+    {
+        const size_t bandEndRow = std::min(bandStartRow + bandHeight, numRows_);
 
-        // find minimum energy path from previous row to every pixel in the current row
-        for (size_t column = 0; column < numColumns_; column++)
+        cv::parallel_for_(cv::Range(0, (int)numTiles), [&](const cv::Range& range)
         {
-            // initialize min energy to +INF and initialize the previous column to -1
-            //   to set error state
-            minEnergy = posInf_;
-            minEnergyColumn = -1;
-
-            // save some cycles by not doing any comparisons if the current pixel has been
-            //      previously markedPixels
-            if (!markedPixels[row][column])
+            for (int tile = range.start; tile < range.end; tile++)
             {
-                // check above
-                if (!markedUp && energyUp < minEnergy)
-                {
-                    minEnergy = energyUp;
-                    minEnergyColumn = column;
-                }
+                const size_t tileStartColumn = std::min((size_t)tile * tileWidth, numColumns_);
+                const size_t tileEndColumn = std::min(tileStartColumn + tileWidth, numColumns_);
 
-                // check if right/above is min
-                if (column < numColumns_ - 1)
-                {
-                    if (!markedUpRight && energyUpRight < minEnergy)
-                    {
-                        minEnergy = energyUpRight;
-                        minEnergyColumn = column + 1;
-                    }
-                }
+                float* pLocalTotalEnergy[2] = { tileTotalEnergyTo.ptr<float>(2 * tile),
+                                                tileTotalEnergyTo.ptr<float>(2 * tile + 1) };
+                int32_t* pLocalPreviousLocation = tilePreviousLocationTo.ptr<int32_t>(tile);
 
-                // check if left/above is min
-                if (column > 0)
+                // first row of the band reads the shared row completed by the previous band
+                const float* pTotalEnergyAbove = totalEnergyTo.ptr<float>((int)bandStartRow - 1);
+
+                for (size_t row = bandStartRow; row < bandEndRow; row++)
                 {
-                    if (!markedUpLeft && energyUpLeft < minEnergy)
-                    {
-                        minEnergy = energyUpLeft;
-                        minEnergyColumn = column - 1;
-                    }
+                    // columns this tile has to compute for the current row including its halo
+                    const size_t halo = bandEndRow - 1 - row;
+                    const size_t startColumn = tileStartColumn > halo ? tileStartColumn - halo : 0;
+                    const size_t endColumn = std::min(tileEndColumn + halo, numColumns_);
+
+                    float* pLocalTotalEnergyRow = pLocalTotalEnergy[row & 1];
+
+                    cumulativePathEnergyRow(pTotalEnergyAbove,
+                                            bAddPixelEnergy_ ?
+                                                pixelEnergy.ptr<float>((int)row) : nullptr,
+                                            bForwardEnergyEnabled_ ?
+                                                intensity.ptr<float>((int)row - 1) : nullptr,
+                                            bForwardEnergyEnabled_ ?
+                                                intensity.ptr<float>((int)row) : nullptr,
+                                            markedPixels.ptr<uchar>((int)row),
+                                            pLocalTotalEnergyRow,
+                                            pLocalPreviousLocation,
+                                            startColumn, endColumn,
+                                            numColumns_, posInf_,
+                                            bVectorizationEnabled_);
+
+                    // publish only the columns owned by this tile
+                    std::copy(pLocalTotalEnergyRow + tileStartColumn,
+                              pLocalTotalEnergyRow + tileEndColumn,
+                              totalEnergyTo.ptr<float>((int)row) + tileStartColumn);
+                    std::copy(pLocalPreviousLocation + tileStartColumn,
+                              pLocalPreviousLocation + tileEndColumn,
+                              previousLocationTo.ptr<int32_t>((int)row) + tileStartColumn);
+
+                    pTotalEnergyAbove = pLocalTotalEnergyRow;
                 }
             }
-
-            // shift energy to the left
-            energyUpLeft = energyUp;
-            markedUpLeft = markedUp;
-            energyUp = energyUpRight;
-            markedUp = markedUpRight;
-
-            // get markedPixels and totalEnergyTo data for pixels right/above
-            if (numColumns_ > 1 && column < numColumns_ - 2)
-            {
-                energyUpRight = totalEnergyTo[row - 1][column + 2];
-                markedUpRight = markedPixels[row - 1][column + 2];
-            }
-
-            // assign cumulative energy to current pixel and save the column of the parent pixel
-            if (minEnergyColumn == -1)
-            {
-                // current pixel is unreachable from parent pixels since they are all markedPixels
-                //   OR current pixel already markedPixels
-                // set energy to reach current pixel to +INF
-                totalEnergyTo[row][column] = posInf_;
-            }
-            else
-            {
-                totalEnergyTo[row][column] = minEnergy + pixelEnergy[row][column];
-            }
-            previousLocationTo[row][column] = minEnergyColumn;
-        }
+        }, (double)numTiles);
     }
 }
 
-void cv::VerticalSeamCarver::removeSeams()
+void cv::VerticalSeamCarver::removeSeams(const cv::Mat& image, cv::Mat& outImage)
 {
-    // each row of seams stores an ordered queue of pixels to remove in that row
-    //   starting with the min number column
-    // each time a new column is encountered, move the pixels to the right of it
-    //   (up until the next column number) to the left by the number of pixels already removed
+    // each row of seams stores an ordered queue of columns to remove, min column first
+    // the runs of pixels between consecutive seam columns are moved to the left by the number of
+    //      seams already removed from the row, one memmove per run covering all channels
+    const size_t pixelSize = image.elemSize();
+    const size_t numRemainingColumns = numColumns_ - numSeamsToRemove_;
+
+    // compact in place if the caller carves an image into itself, otherwise write into a
+    //      separate matrix in case outImage shares only part of its data with image
+    const bool bInPlace = outImage.data == image.data &&
+                          outImage.step == image.step &&
+                          outImage.size() == image.size() &&
+                          outImage.type() == image.type();
+
+    cv::Mat carvedImage;
+    if (bInPlace)
+    {
+        carvedImage = outImage;
+    }
+    else
+    {
+        carvedImage.create(image.rows, (int)numRemainingColumns, image.type());
+    }
 
-    size_t colToRemove = 0;
-    size_t numSeamsRemoved = 0;
-    /*** REMOVE PIXELS FOR EVERY ROW ***/
     for (size_t row = 0; row < numRows_; row++)
     {
-        // seamRecalculationCount the number of seams to the left of the current pixel
-        //   to indicate how many spaces to move pixels that aren't being removed to the left
-        numSeamsRemoved = 0;
-        // loop through all pixels to remove in current row
+        const uchar* pImageRow = image.ptr<uchar>((int)row);
+        uchar* pCarvedRow = carvedImage.ptr<uchar>((int)row);
+
+        size_t sourceColumn = 0;
+        size_t carvedColumn = 0;
         while (!discoveredSeams[row].empty())
         {
-            numSeamsRemoved++;
-            // column location of pixel to remove in row row
-            colToRemove = discoveredSeams[row].pop();
-            //seams[row].pop();
-            // mark right endpoint/next pixel column
-            size_t rightColBorder = (discoveredSeams[row].empty() ?
-                                     numColumns_ : discoveredSeams[row].top());
-            // starting at the column to the right of the column to remove,
-            //      move the pixel to the left, by the number of seams to the left of the pixel,
-            //      until the right end point which is either the last column or the next column
-            //      to remove whichever comes first
-            for (size_t column = colToRemove + 1; column < rightColBorder; column++)
+            const size_t seamColumn = (size_t)discoveredSeams[row].pop();
+            const size_t runLength = seamColumn - sourceColumn;
+
+            // an in place run left of the first seam doesn't move
+            if (carvedColumn != sourceColumn || !bInPlace)
             {
-                for (size_t j = 0; j < numColorChannels_; j++)
-                {
-                    bgr[j].at<uchar>(row, column - numSeamsRemoved) = bgr[j].at<uchar>(row, column);
-                }
+                std::memmove(pCarvedRow + carvedColumn * pixelSize,
+                             pImageRow + sourceColumn * pixelSize,
+                             runLength * pixelSize);
             }
+
+            carvedColumn += runLength;
+            sourceColumn = seamColumn + 1;
         }
-    }
 
-    /*** SHRINK IMAGE BY REMOVING SEAMS ***/
-    for (size_t channel = 0; channel < numColorChannels_; channel++)
-    {
-        bgr[channel] = bgr[channel].colRange(0, numColumns_ - numSeamsRemoved);
+        // move the pixels after the last seam
+        std::memmove(pCarvedRow + carvedColumn * pixelSize,
+                     pImageRow + sourceColumn * pixelSize,
+                     (numColumns_ - sourceColumn) * pixelSize);
     }
+
+    outImage = carvedImage.colRange(0, (int)numRemainingColumns);
 }
\ No newline at end of file
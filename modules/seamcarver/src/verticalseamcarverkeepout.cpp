@@ -34,63 +34,55 @@ void cv::VerticalSeamCarverKeepout::runSeamRemover(size_t numSeams,
                                                    const cv::Mat& img,
                                                    cv::Mat& outImg)
 {
-    try
+    // verify keepout region dimensions
+    if (!bKeepoutRegionDefined)
     {
-        // verify keepout region dimensions
-        if (!bKeepoutRegionDefined)
+        CV_Error(Error::Code::StsInternal, "Keepout region hasn't been defined");
+    }
+    else
+    {
+        if (bNeedToInitializeLocalData ||
+            (size_t)img.rows != numRows_ ||
+            (size_t)img.cols != numColumns_)
         {
-            CV_Error(Error::Code::StsInternal, "Keepout region hasn't been defined");
+            init(img, img.rows);
         }
-        else
+
+        if (keepoutRegionDimensions_.column_ > rightColumn_ ||
+            keepoutRegionDimensions_.row_ > bottomRow_)
         {
-            if (bNeedToInitializeLocalData)
-            {
-                init(img, img.rows);
-            }
-
-            if (keepoutRegionDimensions_.column_ > rightColumn_ ||
-                keepoutRegionDimensions_.row_ > bottomRow_)
-            {
-                CV_Error(Error::Code::StsInternal, "Keepout region begins past borders");
-            }
-
-            if (keepoutRegionDimensions_.column_ + keepoutRegionDimensions_.width_ >= rightColumn_
-                || keepoutRegionDimensions_.row_ + keepoutRegionDimensions_.height_ >= bottomRow_)
-            {
-                CV_Error(Error::Code::StsInternal, "Keepout region extends past borders");
-            }
+            CV_Error(Error::Code::StsInternal, "Keepout region begins past borders");
         }
 
-        // check if removing more seams than columns available
-        if (numSeams > numColumns_)
+        if (keepoutRegionDimensions_.column_ + keepoutRegionDimensions_.width_ >= rightColumn_
+            || keepoutRegionDimensions_.row_ + keepoutRegionDimensions_.height_ >= bottomRow_)
         {
-            CV_Error(Error::Code::StsBadArg, "Removing more seams than columns available");
+            CV_Error(Error::Code::StsInternal, "Keepout region extends past borders");
         }
-
-        resetLocalVectors();
-
-        findAndRemoveSeams(img, outImg);
     }
-    catch (...)
+
+    // check if removing more seams than columns available
+    if (numSeams > numColumns_)
     {
-        throw;
+        CV_Error(Error::Code::StsBadArg, "Removing more seams than columns available");
     }
+
+    // set number of seams to remove this pass
+    numSeamsToRemove_ = numSeams;
+
+    resetLocalVectors();
+
+    findAndRemoveSeams(img, outImg);
 }
 
 void cv::VerticalSeamCarverKeepout::resetLocalVectors()
 {
     VerticalSeamCarver::resetLocalVectors();
 
-    for (size_t row = keepoutRegionDimensions_.row_;
-         row < keepoutRegionDimensions_.row_ + keepoutRegionDimensions_.height_; row++)
-    {
-        for (size_t column = keepoutRegionDimensions_.column_;
-             column < keepoutRegionDimensions_.column_ + keepoutRegionDimensions_.width_;
-             column++)
-        {
-            markedPixels[row][column] = true;
-        }
-    }
+    markedPixels(cv::Rect((int)keepoutRegionDimensions_.column_,
+                          (int)keepoutRegionDimensions_.row_,
+                          (int)keepoutRegionDimensions_.width_,
+                          (int)keepoutRegionDimensions_.height_)).setTo(cv::Scalar::all(1));
 }
 
 void cv::VerticalSeamCarverKeepout::setKeepoutRegion(size_t startingRow,
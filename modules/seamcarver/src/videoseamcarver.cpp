@@ -0,0 +1,219 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "opencv2/seamcarver/videoseamcarver.hpp"
+#include "opencv2/seamcarver/pixelenergy2d.hpp"
+#include <cstring>
+
+cv::VideoSeamCarver::VideoSeamCarver(
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::VideoSeamCarver::VideoSeamCarver(
+    size_t numRows,
+    size_t numColumns,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(numRows, numColumns, marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::VideoSeamCarver::VideoSeamCarver(
+    const cv::Mat& img,
+    double marginEnergy,
+    PixelEnergy2D* pNewPixelEnergyCalculator) :
+    VerticalSeamCarver(img, marginEnergy, pNewPixelEnergyCalculator)
+{}
+
+cv::VideoSeamCarver::~VideoSeamCarver() {}
+
+void cv::VideoSeamCarver::setBandWidth(size_t bandWidth)
+{
+    bandWidth_ = bandWidth;
+}
+
+size_t cv::VideoSeamCarver::getBandWidth() const
+{
+    return bandWidth_;
+}
+
+void cv::VideoSeamCarver::setTileSize(size_t tileSize)
+{
+    if (tileSize == 0)
+    {
+        CV_Error(Error::Code::StsBadArg, "setTileSize failed due to zero tile size");
+    }
+
+    tileSize_ = tileSize;
+}
+
+size_t cv::VideoSeamCarver::getTileSize() const
+{
+    return tileSize_;
+}
+
+void cv::VideoSeamCarver::reset()
+{
+    previousFrame.release();
+    numPreviousSeams_ = 0;
+}
+
+void cv::VideoSeamCarver::setIncrementalMode(bool bEnable)
+{
+    if (bEnable)
+    {
+        CV_Error(Error::Code::StsNotImplemented,
+                 "VideoSeamCarver doesn't support incremental mode");
+    }
+
+    VerticalSeamCarver::setIncrementalMode(bEnable);
+}
+
+void cv::VideoSeamCarver::init(size_t numRows, size_t numColumns, size_t seamLength)
+{
+    VerticalSeamCarver::init(numRows, numColumns, seamLength);
+
+    // pixel energy and seams of a frame with different dimensions can't be reused
+    reset();
+}
+
+void cv::VideoSeamCarver::calculateEnergy(const cv::Mat& image)
+{
+    // forward energy only needs a single intensity pass, which isn't worth tiling, and an
+    //      energy map or weights replace or change the calculated pixel energy, so pixelEnergy
+    //      can't be reused for the next frame
+    if (bForwardEnergyEnabled_ || !energyMap.empty() || !energyWeights.empty())
+    {
+        VerticalSeamCarver::calculateEnergy(image);
+        previousFrame.release();
+        return;
+    }
+
+    if (previousFrame.size() != image.size() || previousFrame.type() != image.type())
+    {
+        VerticalSeamCarver::calculateEnergy(image);
+        image.copyTo(previousFrame);
+        return;
+    }
+
+    const size_t pixelSize = image.elemSize();
+    const cv::Rect frameRect(0, 0, image.cols, image.rows);
+
+    for (size_t tileRow = 0; tileRow < numRows_; tileRow += tileSize_)
+    {
+        const size_t tileHeight = std::min(tileSize_, numRows_ - tileRow);
+
+        for (size_t tileColumn = 0; tileColumn < numColumns_; tileColumn += tileSize_)
+        {
+            const size_t tileWidth = std::min(tileSize_, numColumns_ - tileColumn);
+
+            bool bTileChanged = false;
+            for (size_t row = tileRow; row < tileRow + tileHeight && !bTileChanged; row++)
+            {
+                bTileChanged = std::memcmp(image.ptr<uchar>((int)row) + tileColumn * pixelSize,
+                                           previousFrame.ptr<uchar>((int)row) +
+                                               tileColumn * pixelSize,
+                                           tileWidth * pixelSize) != 0;
+            }
+
+            if (!bTileChanged)
+            {
+                continue;
+            }
+
+            const cv::Rect tile((int)tileColumn, (int)tileRow, (int)tileWidth, (int)tileHeight);
+
+            // the energy of the pixels bordering the tile depends on the changed pixels as well
+            const cv::Rect region = cv::Rect(tile.x - 1,
+                                             tile.y - 1,
+                                             tile.width + 2,
+                                             tile.height + 2) & frameRect;
+
+            pPixelEnergyCalculator_->calculatePixelEnergyForRegion(image, region, pixelEnergy);
+
+            image(tile).copyTo(previousFrame(tile));
+        }
+    }
+}
+
+void cv::VideoSeamCarver::findSeams()
+{
+    numCurrentSeams_ = 0;
+
+    if (numPreviousSeams_ == 0)
+    {
+        // nothing to follow, so search the whole frame once for all seams
+        VerticalSeamCarver::findSeams();
+    }
+    else
+    {
+        for (size_t n = 0; n < numSeamsToRemove_; n++)
+        {
+            // follow seam n of the previous frame, unless it's blocked by the seams found before
+            if (n >= numPreviousSeams_ || !findSeamInBand(previousSeams[n], bandWidth_))
+            {
+                calculateCumulativePathEnergy();
+                findLeastEnergySeam();
+            }
+
+            addCurrentSeam();
+        }
+    }
+
+    previousSeams.swap(currentSeams);
+    numPreviousSeams_ = numCurrentSeams_;
+}
+
+void cv::VideoSeamCarver::addCurrentSeam()
+{
+    VerticalSeamCarver::addCurrentSeam();
+
+    if (currentSeams.size() <= numCurrentSeams_)
+    {
+        currentSeams.resize(numCurrentSeams_ + 1);
+    }
+
+    // assign() reuses the capacity of the seam stored by an earlier frame
+    currentSeams[numCurrentSeams_].assign(currentSeam.begin(), currentSeam.begin() + numRows_);
+    numCurrentSeams_++;
+}
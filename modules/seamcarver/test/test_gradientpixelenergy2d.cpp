@@ -107,5 +107,62 @@ namespace opencv_test
             //DebugDisplay d;
             //d.Display2DVector<double>(calculatedPixelEnergy, initialMarginEnergy);
         }
+
+        TEST(GradientPixelEnergy2D, MatchesDualGradient)
+        {
+            cv::Mat image(37, 53, CV_8UC3);
+            cv::randu(image, cv::Scalar::all(0), cv::Scalar::all(256));
+
+            cv::GradientPixelEnergy2D pixelEnergyCalculator(initialMarginEnergy);
+            cv::Mat pixelEnergy;
+            pixelEnergyCalculator.calculatePixelEnergy(image, pixelEnergy);
+
+            ASSERT_EQ(pixelEnergy.size(), image.size());
+            ASSERT_EQ(pixelEnergy.type(), CV_32FC1);
+
+            for (int row = 0; row < image.rows; row++)
+            {
+                for (int column = 0; column < image.cols; column++)
+                {
+                    double expectedEnergy = initialMarginEnergy;
+                    if (row > 0 && column > 0 && row < image.rows - 1 && column < image.cols - 1)
+                    {
+                        expectedEnergy = 0.0;
+                        for (int channel = 0; channel < 3; channel++)
+                        {
+                            double deltaX = (double)image.at<cv::Vec3b>(row, column + 1)[channel] -
+                                            (double)image.at<cv::Vec3b>(row, column - 1)[channel];
+                            double deltaY = (double)image.at<cv::Vec3b>(row + 1, column)[channel] -
+                                            (double)image.at<cv::Vec3b>(row - 1, column)[channel];
+                            expectedEnergy += deltaX * deltaX + deltaY * deltaY;
+                        }
+                    }
+
+                    ASSERT_EQ(pixelEnergy.at<float>(row, column), (float)expectedEnergy);
+                }
+            }
+        }
+
+        TEST(GradientPixelEnergy2D, VectorizedMatchesScalar)
+        {
+            cv::Mat grayImg;
+            cv::extractChannel(img, grayImg, 1);
+
+            cv::GradientPixelEnergy2D pixelEnergyCalculator(initialMarginEnergy);
+
+            for (const cv::Mat& image : { img, grayImg })
+            {
+                cv::Mat vectorizedPixelEnergy;
+                cv::Mat scalarPixelEnergy;
+
+                pixelEnergyCalculator.setVectorization(true);
+                pixelEnergyCalculator.calculatePixelEnergy(image, vectorizedPixelEnergy);
+                pixelEnergyCalculator.setVectorization(false);
+                EXPECT_EQ(pixelEnergyCalculator.isVectorizationEnabled(), false);
+                pixelEnergyCalculator.calculatePixelEnergy(image, scalarPixelEnergy);
+
+                EXPECT_EQ(cv::norm(vectorizedPixelEnergy, scalarPixelEnergy, cv::NORM_INF), 0.0);
+            }
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,140 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "test_precomp.hpp"
+#include "opencv2/seamcarver/debugdisplay.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        double initialMarginEnergy = 390150.0;
+
+        cv::Mat img = cv::imread("../../../../opencv_contrib/modules/seamcarver/test/eagle.jpg");
+
+        cv::Mat outImg;
+
+        TEST(HorizontalSeamCarver, CanOpenImage)
+        {
+            ASSERT_EQ(img.empty(), false);
+        }
+
+        TEST(HorizontalSeamCarver, DefaultCtor)
+        {
+            HorizontalSeamCarver hSeamCarver(initialMarginEnergy);
+            EXPECT_EQ(hSeamCarver.areDimensionsInitialized(), false);
+        }
+
+        TEST(HorizontalSeamCarver, ImgCtor)
+        {
+            HorizontalSeamCarver hSeamCarver(img, initialMarginEnergy);
+            EXPECT_EQ(hSeamCarver.areDimensionsInitialized(), true);
+        }
+
+        TEST(HorizontalSeamCarver, CheckRunSeamRemoverThrows)
+        {
+            HorizontalSeamCarver hSeamCarver(initialMarginEnergy);
+
+            try
+            {
+                hSeamCarver.runSeamRemover((size_t)(img.rows + 1), img, outImg);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+        }
+
+        TEST(HorizontalSeamCarver, RemoveMultipleHorizontalSeams)
+        {
+            size_t numSeamsToRemove = 3;
+            HorizontalSeamCarver hSeamCarver(img, initialMarginEnergy);
+
+            hSeamCarver.runSeamRemover(numSeamsToRemove, img, outImg);
+
+            EXPECT_EQ((size_t)outImg.rows, (size_t)img.rows - numSeamsToRemove);
+            EXPECT_EQ(outImg.cols, img.cols);
+        }
+
+        TEST(HorizontalSeamCarver, InsertMultipleHorizontalSeams)
+        {
+            size_t numSeamsToInsert = 25;
+            HorizontalSeamCarver hSeamCarver(img, initialMarginEnergy);
+
+            hSeamCarver.runSeamInserter(numSeamsToInsert, img, outImg);
+            EXPECT_EQ((size_t)outImg.rows, (size_t)img.rows + numSeamsToInsert);
+            EXPECT_EQ(outImg.cols, img.cols);
+
+            // inserting horizontal seams matches inserting vertical seams in the transposed image
+            cv::Mat transposedImg;
+            cv::Mat transposedOutImg;
+            cv::Mat verticalOutImg;
+            cv::transpose(img, transposedImg);
+            VerticalSeamCarver vSeamCarver(transposedImg, initialMarginEnergy);
+            vSeamCarver.runSeamInserter(numSeamsToInsert, transposedImg, transposedOutImg);
+            cv::transpose(transposedOutImg, verticalOutImg);
+
+            EXPECT_EQ(cv::norm(outImg, verticalOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(HorizontalSeamCarver, MatchesVerticalSeamsOnTransposedImage)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat horizontalOutImg;
+            cv::Mat transposedImg;
+            cv::Mat transposedOutImg;
+            cv::Mat verticalOutImg;
+
+            HorizontalSeamCarver hSeamCarver(img, initialMarginEnergy);
+            hSeamCarver.runSeamRemover(numSeamsToRemove, img, horizontalOutImg);
+
+            cv::transpose(img, transposedImg);
+            VerticalSeamCarver vSeamCarver(transposedImg, initialMarginEnergy);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, transposedImg, transposedOutImg);
+            cv::transpose(transposedOutImg, verticalOutImg);
+
+            ASSERT_EQ(horizontalOutImg.size(), verticalOutImg.size());
+            EXPECT_EQ(cv::norm(horizontalOutImg, verticalOutImg, cv::NORM_INF), 0.0);
+            EXPECT_EQ(hSeamCarver.getRemovedSeamsEnergy(), vSeamCarver.getRemovedSeamsEnergy());
+        }
+    }
+}
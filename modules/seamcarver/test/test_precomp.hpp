@@ -9,5 +9,10 @@
 #include "opencv2/seamcarver/constsizeminbinaryheap.hpp"
 #include "opencv2/seamcarver/verticalseamcarver.hpp"
 #include "opencv2/seamcarver/verticalseamcarverkeepout.hpp"
+#include "opencv2/seamcarver/horizontalseamcarver.hpp"
+#include "opencv2/seamcarver/retargetingseamcarver.hpp"
+#include "opencv2/seamcarver/videoseamcarver.hpp"
+#include "opencv2/seamcarver/pyramidseamcarver.hpp"
+#include "opencv2/seamcarver/seamcarverpool.hpp"
 
 #endif
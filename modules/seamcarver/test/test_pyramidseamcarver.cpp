@@ -0,0 +1,131 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "test_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        double initialMarginEnergy = 390150.0;
+
+        cv::Mat img = cv::imread("../../../../opencv_contrib/modules/seamcarver/test/eagle.jpg");
+
+        TEST(PyramidSeamCarver, CanOpenImage)
+        {
+            ASSERT_EQ(img.empty(), false);
+        }
+
+        TEST(PyramidSeamCarver, ImgCtor)
+        {
+            PyramidSeamCarver pyramidSeamCarver(img, initialMarginEnergy);
+            EXPECT_EQ(pyramidSeamCarver.areDimensionsInitialized(), true);
+        }
+
+        TEST(PyramidSeamCarver, CheckSettersThrow)
+        {
+            PyramidSeamCarver pyramidSeamCarver(initialMarginEnergy);
+
+            try
+            {
+                pyramidSeamCarver.setNumLevels(0);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+
+            try
+            {
+                pyramidSeamCarver.setIncrementalMode(true);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsNotImplemented);
+            }
+        }
+
+        TEST(PyramidSeamCarver, SingleLevelMatchesConeUpdate)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat pyramidOutImg;
+            cv::Mat verticalOutImg;
+
+            // without coarse levels every seam is searched for in the whole image
+            PyramidSeamCarver pyramidSeamCarver(img, initialMarginEnergy);
+            pyramidSeamCarver.setNumLevels(1);
+            pyramidSeamCarver.runSeamRemover(numSeamsToRemove, img, pyramidOutImg);
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.setSeamSearchStrategy(VerticalSeamCarver::SEAM_SEARCH_CONE_UPDATE);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, verticalOutImg);
+
+            ASSERT_EQ(pyramidOutImg.size(), verticalOutImg.size());
+            EXPECT_EQ(cv::norm(pyramidOutImg, verticalOutImg, cv::NORM_INF), 0.0);
+            EXPECT_FLOAT_EQ((float)pyramidSeamCarver.getRemovedSeamsEnergy(),
+                            (float)vSeamCarver.getRemovedSeamsEnergy());
+        }
+
+        TEST(PyramidSeamCarver, RemovesAndInsertsRequestedSeams)
+        {
+            size_t numSeamsToRemove = 25;
+            cv::Mat removedOutImg;
+            cv::Mat insertedOutImg;
+
+            PyramidSeamCarver pyramidSeamCarver(img, initialMarginEnergy);
+            pyramidSeamCarver.setNumLevels(3);
+            pyramidSeamCarver.setCorridorWidth(2);
+            EXPECT_EQ(pyramidSeamCarver.getCorridorWidth(), (size_t)2);
+
+            pyramidSeamCarver.runSeamRemover(numSeamsToRemove, img, removedOutImg);
+            EXPECT_EQ(removedOutImg.rows, img.rows);
+            EXPECT_EQ((size_t)removedOutImg.cols, (size_t)img.cols - numSeamsToRemove);
+            EXPECT_GT(pyramidSeamCarver.getRemovedSeamsEnergy(), 0.0);
+
+            pyramidSeamCarver.runSeamInserter(numSeamsToRemove, img, insertedOutImg);
+            EXPECT_EQ(insertedOutImg.rows, img.rows);
+            EXPECT_EQ((size_t)insertedOutImg.cols, (size_t)img.cols + numSeamsToRemove);
+        }
+    }
+}
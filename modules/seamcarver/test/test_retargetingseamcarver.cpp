@@ -0,0 +1,116 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+#include "test_precomp.hpp"
+#include "opencv2/seamcarver/debugdisplay.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        double initialMarginEnergy = 390150.0;
+
+        cv::Mat img = cv::imread("../../../../opencv_contrib/modules/seamcarver/test/eagle.jpg");
+
+        TEST(RetargetingSeamCarver, CanOpenImage)
+        {
+            ASSERT_EQ(img.empty(), false);
+        }
+
+        TEST(RetargetingSeamCarver, CheckRetargetThrows)
+        {
+            RetargetingSeamCarver retargeter(initialMarginEnergy);
+            cv::Mat outImg;
+
+            try
+            {
+                retargeter.retarget(img, cv::Size(img.cols + 1, img.rows), outImg);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+        }
+
+        TEST(RetargetingSeamCarver, ShrinkBothDimensions)
+        {
+            // the transport map removes a seam for every entry, so keep the image small
+            cv::Mat smallImg = img(cv::Rect(0, 0, 64, 48)).clone();
+
+            RetargetingSeamCarver retargeter(initialMarginEnergy);
+            cv::Size targetSize(smallImg.cols - 4, smallImg.rows - 3);
+            cv::Mat outImg;
+
+            retargeter.retarget(smallImg, targetSize, outImg);
+
+            EXPECT_EQ(outImg.size(), targetSize);
+            EXPECT_EQ(outImg.type(), smallImg.type());
+
+            // every removed seam is on the path through the transport map
+            const std::vector<bool>& seamOrder = retargeter.getSeamOrder();
+            ASSERT_EQ(seamOrder.size(), (size_t)(4 + 3));
+            EXPECT_EQ(std::count(seamOrder.begin(), seamOrder.end(), true), 4);
+        }
+
+        TEST(RetargetingSeamCarver, ShrinkWidthMatchesVerticalSeams)
+        {
+            // with a single map row the path only removes vertical seams, one at a time
+            cv::Mat smallImg = img(cv::Rect(0, 0, 64, 48)).clone();
+
+            RetargetingSeamCarver retargeter(initialMarginEnergy);
+            cv::Mat outImg;
+            retargeter.retarget(smallImg, cv::Size(smallImg.cols - 5, smallImg.rows), outImg);
+
+            VerticalSeamCarver carver(initialMarginEnergy);
+            cv::Mat expectedImg = smallImg;
+            for (int i = 0; i < 5; i++)
+            {
+                cv::Mat nextImg;
+                carver.runSeamRemover(1, expectedImg, nextImg);
+                expectedImg = nextImg;
+            }
+
+            ASSERT_EQ(outImg.size(), expectedImg.size());
+            EXPECT_EQ(cv::norm(outImg, expectedImg, cv::NORM_INF), 0.0);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "test_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        double initialMarginEnergy = 390150.0;
+
+        cv::Mat img = cv::imread("../../../../opencv_contrib/modules/seamcarver/test/eagle.jpg");
+
+        TEST(SeamCarverPool, CanOpenImage)
+        {
+            ASSERT_EQ(img.empty(), false);
+        }
+
+        TEST(SeamCarverPool, MismatchedSeamCountsThrow)
+        {
+            SeamCarverPool seamCarverPool(initialMarginEnergy);
+            std::vector<cv::Mat> images(2, img);
+            std::vector<cv::Mat> outImages;
+
+            try
+            {
+                seamCarverPool.runSeamRemover(std::vector<size_t>(1, 10), images, outImages);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+        }
+
+        TEST(SeamCarverPool, BatchMatchesVerticalSeamCarver)
+        {
+            std::vector<cv::Mat> images;
+            images.push_back(img);
+            images.push_back(img(cv::Rect(0, 0, img.cols / 2, img.rows / 2)).clone());
+            images.push_back(img(cv::Rect(img.cols / 4, 0, img.cols / 2, img.rows)).clone());
+            images.push_back(img);
+            std::vector<size_t> numSeamsToRemove = { 10, 5, 20, 1 };
+
+            SeamCarverPool seamCarverPool(initialMarginEnergy);
+            std::vector<cv::Mat> outImages;
+            seamCarverPool.runSeamRemover(numSeamsToRemove, images, outImages);
+
+            ASSERT_EQ(outImages.size(), images.size());
+            EXPECT_GE(seamCarverPool.getNumWorkspaces(), (size_t)1);
+            EXPECT_LE(seamCarverPool.getNumWorkspaces(), images.size());
+
+            for (size_t index = 0; index < images.size(); index++)
+            {
+                VerticalSeamCarver vSeamCarver(initialMarginEnergy);
+                cv::Mat expectedOutImage;
+                vSeamCarver.runSeamRemover(numSeamsToRemove[index], images[index],
+                                           expectedOutImage);
+
+                ASSERT_EQ(outImages[index].size(), expectedOutImage.size());
+                EXPECT_EQ(cv::norm(outImages[index], expectedOutImage, cv::NORM_INF), 0.0);
+            }
+        }
+
+        TEST(SeamCarverPool, SmallerImagesReuseWorkspace)
+        {
+            SeamCarverPool seamCarverPool(initialMarginEnergy);
+            cv::Mat outImg;
+
+            seamCarverPool.runSeamRemover(10, img, outImg);
+            size_t numAllocations = seamCarverPool.getNumAllocations();
+            EXPECT_GT(numAllocations, (size_t)0);
+
+            // same or smaller images and seam counts fit into the buffers already allocated
+            cv::Mat smallerImg = img(cv::Rect(0, 0, img.cols / 2, img.rows / 3)).clone();
+            seamCarverPool.runSeamRemover(5, smallerImg, outImg);
+            EXPECT_EQ((size_t)outImg.cols, (size_t)smallerImg.cols - 5);
+            seamCarverPool.runSeamRemover(10, img, outImg);
+            EXPECT_EQ((size_t)outImg.cols, (size_t)img.cols - 10);
+
+            EXPECT_EQ(seamCarverPool.getNumWorkspaces(), (size_t)1);
+            EXPECT_EQ(seamCarverPool.getNumAllocations(), numAllocations);
+        }
+    }
+}
@@ -144,5 +144,323 @@ namespace opencv_test
             //DebugDisplay d;
             //d.displayMatrix(outImg);
         }
+
+        TEST(VerticalSeamCarver, InsertMultipleVerticalSeams)
+        {
+            size_t numSeamsToInsert = 25;
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+
+            vSeamCarver.runSeamInserter(numSeamsToInsert, img, outImg);
+            EXPECT_EQ(outImg.rows, img.rows);
+            EXPECT_EQ((size_t)outImg.cols, (size_t)img.cols + numSeamsToInsert);
+            EXPECT_EQ(outImg.type(), img.type());
+
+            // removing the same number of seams from the enlarged image restores the width
+            cv::Mat restoredImg;
+            vSeamCarver.runSeamRemover(numSeamsToInsert, outImg, restoredImg);
+            EXPECT_EQ(restoredImg.size(), img.size());
+        }
+
+        TEST(VerticalSeamCarver, VectorizedMatchesScalar)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat scalarOutImg;
+            cv::Mat vectorizedOutImg;
+
+            VerticalSeamCarver scalarSeamCarver(img, initialMarginEnergy);
+            scalarSeamCarver.setVectorization(false);
+            EXPECT_FALSE(scalarSeamCarver.isVectorizationEnabled());
+            scalarSeamCarver.runSeamRemover(numSeamsToRemove, img, scalarOutImg);
+
+            VerticalSeamCarver vectorizedSeamCarver(img, initialMarginEnergy);
+            vectorizedSeamCarver.setVectorization(true);
+            EXPECT_TRUE(vectorizedSeamCarver.isVectorizationEnabled());
+            vectorizedSeamCarver.runSeamRemover(numSeamsToRemove, img, vectorizedOutImg);
+
+            ASSERT_EQ(scalarOutImg.size(), vectorizedOutImg.size());
+            EXPECT_EQ(cv::norm(scalarOutImg, vectorizedOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, ParallelMatchesSerial)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat serialOutImg;
+            cv::Mat parallelOutImg;
+
+            VerticalSeamCarver serialSeamCarver(img, initialMarginEnergy);
+            serialSeamCarver.runSeamRemover(numSeamsToRemove, img, serialOutImg);
+
+            VerticalSeamCarver parallelSeamCarver(img, initialMarginEnergy);
+            parallelSeamCarver.setNumThreads(7);
+            EXPECT_EQ(parallelSeamCarver.getNumThreads(), (size_t)7);
+            parallelSeamCarver.runSeamRemover(numSeamsToRemove, img, parallelOutImg);
+
+            ASSERT_EQ(serialOutImg.size(), parallelOutImg.size());
+            EXPECT_EQ(cv::norm(serialOutImg, parallelOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, RemoveMultipleVerticalSeamsIncremental)
+        {
+            size_t numSeamsToRemove = 20;
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.setIncrementalMode(true);
+            EXPECT_TRUE(vSeamCarver.isIncrementalModeEnabled());
+
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, outImg);
+            EXPECT_EQ(outImg.rows, img.rows);
+            EXPECT_EQ((size_t)outImg.cols, (size_t)img.cols - numSeamsToRemove);
+
+            // carver must be reusable at the original width afterwards
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, outImg);
+            EXPECT_EQ((size_t)outImg.cols, (size_t)img.cols - numSeamsToRemove);
+        }
+
+        TEST(VerticalSeamCarver, IncrementalMatchesOneSeamPerCall)
+        {
+            size_t numSeamsToRemove = 5;
+            cv::Mat incrementalOutImg;
+
+            VerticalSeamCarver incrementalSeamCarver(img, initialMarginEnergy);
+            incrementalSeamCarver.setIncrementalMode(true);
+            incrementalSeamCarver.runSeamRemover(numSeamsToRemove, img, incrementalOutImg);
+
+            // removing one seam per call recalculates everything from scratch every time
+            cv::Mat oneSeamOutImg = img.clone();
+            for (size_t n = 0; n < numSeamsToRemove; n++)
+            {
+                VerticalSeamCarver oneSeamCarver(oneSeamOutImg, initialMarginEnergy);
+                cv::Mat carvedImg;
+                oneSeamCarver.runSeamRemover(1, oneSeamOutImg, carvedImg);
+                oneSeamOutImg = carvedImg;
+            }
+
+            ASSERT_EQ(incrementalOutImg.size(), oneSeamOutImg.size());
+            EXPECT_EQ(cv::norm(incrementalOutImg, oneSeamOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, ForwardEnergyVectorizedMatchesScalar)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat scalarOutImg;
+            cv::Mat vectorizedOutImg;
+
+            VerticalSeamCarver scalarSeamCarver(img, initialMarginEnergy);
+            scalarSeamCarver.setForwardEnergy(true);
+            EXPECT_TRUE(scalarSeamCarver.isForwardEnergyEnabled());
+            scalarSeamCarver.setVectorization(false);
+            scalarSeamCarver.runSeamRemover(numSeamsToRemove, img, scalarOutImg);
+
+            VerticalSeamCarver vectorizedSeamCarver(img, initialMarginEnergy);
+            vectorizedSeamCarver.setForwardEnergy(true);
+            vectorizedSeamCarver.runSeamRemover(numSeamsToRemove, img, vectorizedOutImg);
+
+            ASSERT_EQ(scalarOutImg.size(), vectorizedOutImg.size());
+            EXPECT_EQ(scalarOutImg.cols, img.cols - (int)numSeamsToRemove);
+            EXPECT_EQ(cv::norm(scalarOutImg, vectorizedOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, ForwardEnergyIncrementalMatchesOneSeamPerCall)
+        {
+            size_t numSeamsToRemove = 5;
+            cv::Mat incrementalOutImg;
+
+            VerticalSeamCarver incrementalSeamCarver(img, initialMarginEnergy);
+            incrementalSeamCarver.setForwardEnergy(true);
+            incrementalSeamCarver.setIncrementalMode(true);
+            incrementalSeamCarver.runSeamRemover(numSeamsToRemove, img, incrementalOutImg);
+
+            cv::Mat oneSeamOutImg = img.clone();
+            for (size_t n = 0; n < numSeamsToRemove; n++)
+            {
+                VerticalSeamCarver oneSeamCarver(oneSeamOutImg, initialMarginEnergy);
+                oneSeamCarver.setForwardEnergy(true);
+                cv::Mat carvedImg;
+                oneSeamCarver.runSeamRemover(1, oneSeamOutImg, carvedImg);
+                oneSeamOutImg = carvedImg;
+            }
+
+            ASSERT_EQ(incrementalOutImg.size(), oneSeamOutImg.size());
+            EXPECT_EQ(cv::norm(incrementalOutImg, oneSeamOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, RemoveSeamsInPlace)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat copiedOutImg;
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, copiedOutImg);
+
+            cv::Mat inPlaceImg = img.clone();
+            const uchar* pInPlaceData = inPlaceImg.data;
+            vSeamCarver.runSeamRemover(numSeamsToRemove, inPlaceImg, inPlaceImg);
+
+            EXPECT_EQ(inPlaceImg.data, pInPlaceData);
+            ASSERT_EQ(inPlaceImg.size(), copiedOutImg.size());
+            EXPECT_EQ(cv::norm(inPlaceImg, copiedOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VerticalSeamCarver, RemoveSeamsFromInterleavedDepths)
+        {
+            size_t numSeamsToRemove = 10;
+
+            // forward energy handles every depth, so the seams only depend on the pixel values
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.setForwardEnergy(true);
+
+            cv::Mat expectedOutImg;
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, expectedOutImg);
+
+            for (int depth : { CV_16U, CV_32F })
+            {
+                cv::Mat convertedImg;
+                cv::Mat convertedOutImg;
+                cv::Mat expectedConvertedOutImg;
+                img.convertTo(convertedImg, depth);
+                expectedOutImg.convertTo(expectedConvertedOutImg, depth);
+
+                vSeamCarver.runSeamRemover(numSeamsToRemove, convertedImg, convertedOutImg);
+
+                EXPECT_EQ(convertedOutImg.type(), CV_MAKETYPE(depth, 3));
+                ASSERT_EQ(convertedOutImg.size(), expectedConvertedOutImg.size());
+                EXPECT_EQ(cv::norm(convertedOutImg, expectedConvertedOutImg, cv::NORM_INF), 0.0);
+            }
+        }
+
+        TEST(VerticalSeamCarver, EnergyMapMatchesPixelEnergyCalculator)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat calculatorOutImg;
+            cv::Mat energyMapOutImg;
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, calculatorOutImg);
+
+            cv::Mat energyMap;
+            GradientPixelEnergy2D pixelEnergyCalculator(initialMarginEnergy);
+            pixelEnergyCalculator.calculatePixelEnergy(img, energyMap);
+
+            vSeamCarver.setEnergyMap(energyMap);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, energyMapOutImg);
+
+            ASSERT_EQ(calculatorOutImg.size(), energyMapOutImg.size());
+            EXPECT_EQ(cv::norm(calculatorOutImg, energyMapOutImg, cv::NORM_INF), 0.0);
+
+            // a map of the wrong size is rejected when carving
+            vSeamCarver.setEnergyMap(energyMap.colRange(1, energyMap.cols));
+            try
+            {
+                vSeamCarver.runSeamRemover(numSeamsToRemove, img, energyMapOutImg);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+        }
+
+        TEST(VerticalSeamCarver, ProtectMaskKeepsPixels)
+        {
+            size_t numSeamsToRemove = 20;
+            cv::Rect protectedStripe(img.cols / 3, 0, 40, img.rows);
+
+            cv::Mat mask(img.size(), CV_8UC1, cv::Scalar::all(0));
+            mask(protectedStripe).setTo(cv::Scalar::all(255));
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.addProtectMask(mask, 1e6);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, outImg);
+
+            // no seam crosses the stripe, so every seam is on the same side of it in every row
+            bool bStripeFound = false;
+            for (int shift = 0; shift <= (int)numSeamsToRemove && !bStripeFound; shift++)
+            {
+                cv::Rect shiftedStripe = protectedStripe - cv::Point(shift, 0);
+                bStripeFound = cv::norm(outImg(shiftedStripe), img(protectedStripe),
+                                        cv::NORM_INF) == 0.0;
+            }
+            EXPECT_TRUE(bStripeFound);
+        }
+
+        TEST(VerticalSeamCarver, RemoveMaskRemovesPixels)
+        {
+            int removedColumn = img.cols / 2;
+
+            cv::Mat mask(img.size(), CV_8UC1, cv::Scalar::all(0));
+            mask.col(removedColumn).setTo(cv::Scalar::all(255));
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.addRemoveMask(mask, 1e6);
+            vSeamCarver.runSeamRemover(1, img, outImg);
+
+            cv::Mat expectedOutImg;
+            cv::hconcat(img.colRange(0, removedColumn),
+                        img.colRange(removedColumn + 1, img.cols),
+                        expectedOutImg);
+
+            ASSERT_EQ(outImg.size(), expectedOutImg.size());
+            EXPECT_EQ(cv::norm(outImg, expectedOutImg, cv::NORM_INF), 0.0);
+
+            vSeamCarver.clearEnergyWeights();
+            cv::Mat unweightedOutImg;
+            vSeamCarver.runSeamRemover(1, img, unweightedOutImg);
+            EXPECT_EQ(unweightedOutImg.cols, img.cols - 1);
+        }
+
+        TEST(VerticalSeamCarver, ConeUpdateMatchesRestartForOneSeam)
+        {
+            cv::Mat restartOutImg;
+            cv::Mat coneUpdateOutImg;
+
+            VerticalSeamCarver restartSeamCarver(img, initialMarginEnergy);
+            EXPECT_EQ(restartSeamCarver.getSeamSearchStrategy(),
+                      VerticalSeamCarver::SEAM_SEARCH_RESTART);
+            restartSeamCarver.runSeamRemover(1, img, restartOutImg);
+
+            VerticalSeamCarver coneUpdateSeamCarver(img, initialMarginEnergy);
+            coneUpdateSeamCarver.setSeamSearchStrategy(VerticalSeamCarver::SEAM_SEARCH_CONE_UPDATE);
+            coneUpdateSeamCarver.runSeamRemover(1, img, coneUpdateOutImg);
+
+            ASSERT_EQ(restartOutImg.size(), coneUpdateOutImg.size());
+            EXPECT_EQ(cv::norm(restartOutImg, coneUpdateOutImg, cv::NORM_INF), 0.0);
+            EXPECT_EQ(restartSeamCarver.getRemovedSeamsEnergy(),
+                      coneUpdateSeamCarver.getRemovedSeamsEnergy());
+        }
+
+        TEST(VerticalSeamCarver, ConeUpdateMatchesFullRecalculation)
+        {
+            size_t numSeamsToRemove = 40;
+            cv::Mat coneUpdateOutImg;
+            cv::Mat scalarOutImg;
+            cv::Mat fullRecalculationOutImg;
+
+            VerticalSeamCarver coneUpdateSeamCarver(img, initialMarginEnergy);
+            coneUpdateSeamCarver.setSeamSearchStrategy(VerticalSeamCarver::SEAM_SEARCH_CONE_UPDATE);
+            coneUpdateSeamCarver.runSeamRemover(numSeamsToRemove, img, coneUpdateOutImg);
+
+            EXPECT_EQ((size_t)coneUpdateOutImg.cols, (size_t)img.cols - numSeamsToRemove);
+
+            VerticalSeamCarver scalarSeamCarver(img, initialMarginEnergy);
+            scalarSeamCarver.setSeamSearchStrategy(VerticalSeamCarver::SEAM_SEARCH_CONE_UPDATE);
+            scalarSeamCarver.setVectorization(false);
+            scalarSeamCarver.runSeamRemover(numSeamsToRemove, img, scalarOutImg);
+
+            ASSERT_EQ(coneUpdateOutImg.size(), scalarOutImg.size());
+            EXPECT_EQ(cv::norm(coneUpdateOutImg, scalarOutImg, cv::NORM_INF), 0.0);
+
+            // once it has seen a frame, a video seam carver with a band covering the whole frame
+            //      recalculates all of the cumulative energy for every seam after the first
+            VideoSeamCarver fullRecalculationSeamCarver(img, initialMarginEnergy);
+            fullRecalculationSeamCarver.setBandWidth((size_t)img.cols);
+            fullRecalculationSeamCarver.runSeamRemover(1, img, fullRecalculationOutImg);
+            fullRecalculationSeamCarver.runSeamRemover(numSeamsToRemove,
+                                                       img,
+                                                       fullRecalculationOutImg);
+
+            ASSERT_EQ(coneUpdateOutImg.size(), fullRecalculationOutImg.size());
+            EXPECT_EQ(cv::norm(coneUpdateOutImg, fullRecalculationOutImg, cv::NORM_INF), 0.0);
+            EXPECT_EQ(coneUpdateSeamCarver.getRemovedSeamsEnergy(),
+                      fullRecalculationSeamCarver.getRemovedSeamsEnergy());
+        }
     }
 }
\ No newline at end of file
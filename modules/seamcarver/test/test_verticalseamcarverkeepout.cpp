@@ -154,5 +154,30 @@ namespace opencv_test
                 EXPECT_EQ(e.code, cv::Error::Code::StsInternal);
             }
         }
+
+        TEST(VerticalSeamCarverKeepout, RemoveSeamsAroundKeepoutRegion)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Rect keepoutRegion(img.cols / 3, img.rows / 4, 40, img.rows / 2);
+
+            VerticalSeamCarverKeepout vsck(initialMarginEnergy);
+            vsck.setKeepoutRegion((size_t)keepoutRegion.y,
+                                  (size_t)keepoutRegion.x,
+                                  (size_t)keepoutRegion.width,
+                                  (size_t)keepoutRegion.height);
+            vsck.runSeamRemover(numSeamsToRemove, img, outImg);
+
+            EXPECT_EQ((size_t)outImg.cols, (size_t)img.cols - numSeamsToRemove);
+
+            // seams go around the region, so it is only shifted left as a whole
+            bool bRegionFound = false;
+            for (int shift = 0; shift <= (int)numSeamsToRemove && !bRegionFound; shift++)
+            {
+                cv::Rect shiftedRegion = keepoutRegion - cv::Point(shift, 0);
+                bRegionFound = cv::norm(outImg(shiftedRegion), img(keepoutRegion),
+                                        cv::NORM_INF) == 0.0;
+            }
+            EXPECT_TRUE(bRegionFound);
+        }
     }
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*M///////////////////////////////////////////////////////////////////////////////////////
+//
+//  IMPORTANT: READ BEFORE DOWNLOADING, COPYING, INSTALLING OR USING.
+//
+//  By downloading, copying, installing or using the software you agree to this license.
+//  If you do not agree to this license, do not download, install,
+//  copy or use the software.
+//
+//
+//                        Intel License Agreement
+//                For Open Source Computer Vision Library
+//
+// Copyright (C) 2000, Intel Corporation, all rights reserved.
+// Third party copyrights are property of their respective owners.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//   * Redistribution's of source code must retain the above copyright notice,
+//     this list of conditions and the following disclaimer.
+//
+//   * Redistribution's in binary form must reproduce the above copyright notice,
+//     this list of conditions and the following disclaimer in the documentation
+//     and/or other materials provided with the distribution.
+//
+//   * The name of Intel Corporation may not be used to endorse or promote products
+//     derived from this software without specific prior written permission.
+//
+// This software is provided by the copyright holders and contributors "as is" and
+// any express or implied warranties, including, but not limited to, the implied
+// warranties of merchantability and fitness for a particular purpose are disclaimed.
+// In no event shall the Intel Corporation or contributors be liable for any direct,
+// indirect, incidental, special, exemplary, or consequential damages
+// (including, but not limited to, procurement of substitute goods or services;
+// loss of use, data, or profits; or business interruption) however caused
+// and on any theory of liability, whether in contract, strict liability,
+// or tort (including negligence or otherwise) arising in any way out of
+// the use of this software, even if advised of the possibility of such damage.
+//
+//M*/
+
+
+#include "test_precomp.hpp"
+
+namespace opencv_test
+{
+    namespace
+    {
+        double initialMarginEnergy = 390150.0;
+
+        cv::Mat img = cv::imread("../../../../opencv_contrib/modules/seamcarver/test/eagle.jpg");
+
+        TEST(VideoSeamCarver, CanOpenImage)
+        {
+            ASSERT_EQ(img.empty(), false);
+        }
+
+        TEST(VideoSeamCarver, ImgCtor)
+        {
+            VideoSeamCarver videoSeamCarver(img, initialMarginEnergy);
+            EXPECT_EQ(videoSeamCarver.areDimensionsInitialized(), true);
+        }
+
+        TEST(VideoSeamCarver, CheckSettersThrow)
+        {
+            VideoSeamCarver videoSeamCarver(initialMarginEnergy);
+
+            try
+            {
+                videoSeamCarver.setTileSize(0);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsBadArg);
+            }
+
+            try
+            {
+                videoSeamCarver.setIncrementalMode(true);
+                FAIL();
+            }
+            catch (const cv::Exception& e)
+            {
+                EXPECT_EQ(e.code, cv::Error::Code::StsNotImplemented);
+            }
+        }
+
+        TEST(VideoSeamCarver, FirstFrameMatchesVerticalSeamCarver)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat videoOutImg;
+            cv::Mat verticalOutImg;
+
+            VideoSeamCarver videoSeamCarver(img, initialMarginEnergy);
+            videoSeamCarver.runSeamRemover(numSeamsToRemove, img, videoOutImg);
+
+            VerticalSeamCarver vSeamCarver(img, initialMarginEnergy);
+            vSeamCarver.runSeamRemover(numSeamsToRemove, img, verticalOutImg);
+
+            ASSERT_EQ(videoOutImg.size(), verticalOutImg.size());
+            EXPECT_EQ(cv::norm(videoOutImg, verticalOutImg, cv::NORM_INF), 0.0);
+        }
+
+        TEST(VideoSeamCarver, ZeroBandWidthRepeatsSeams)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat firstOutImg;
+            cv::Mat secondOutImg;
+
+            VideoSeamCarver videoSeamCarver(img, initialMarginEnergy);
+            videoSeamCarver.setBandWidth(0);
+            EXPECT_EQ(videoSeamCarver.getBandWidth(), (size_t)0);
+
+            videoSeamCarver.runSeamRemover(numSeamsToRemove, img, firstOutImg);
+            double firstRemovedSeamsEnergy = videoSeamCarver.getRemovedSeamsEnergy();
+            videoSeamCarver.runSeamRemover(numSeamsToRemove, img, secondOutImg);
+
+            ASSERT_EQ(firstOutImg.size(), secondOutImg.size());
+            EXPECT_EQ(cv::norm(firstOutImg, secondOutImg, cv::NORM_INF), 0.0);
+            EXPECT_EQ(videoSeamCarver.getRemovedSeamsEnergy(), firstRemovedSeamsEnergy);
+        }
+
+        TEST(VideoSeamCarver, ChangedTilesMatchFullPixelEnergy)
+        {
+            size_t numSeamsToRemove = 10;
+            cv::Mat changedImg = img.clone();
+            changedImg(cv::Rect(changedImg.cols / 3, changedImg.rows / 3, 20, 30))
+                .setTo(cv::Scalar::all(255));
+
+            // a tile covering the whole frame always recalculates all of the pixel energy
+            VideoSeamCarver tiledSeamCarver(img, initialMarginEnergy);
+            tiledSeamCarver.setTileSize(16);
+            VideoSeamCarver untiledSeamCarver(img, initialMarginEnergy);
+            untiledSeamCarver.setTileSize((size_t)std::max(img.rows, img.cols));
+
+            cv::Mat tiledOutImg;
+            cv::Mat untiledOutImg;
+            tiledSeamCarver.runSeamRemover(numSeamsToRemove, img, tiledOutImg);
+            untiledSeamCarver.runSeamRemover(numSeamsToRemove, img, untiledOutImg);
+            tiledSeamCarver.runSeamRemover(numSeamsToRemove, changedImg, tiledOutImg);
+            untiledSeamCarver.runSeamRemover(numSeamsToRemove, changedImg, untiledOutImg);
+
+            EXPECT_EQ((size_t)tiledOutImg.cols, (size_t)img.cols - numSeamsToRemove);
+            ASSERT_EQ(tiledOutImg.size(), untiledOutImg.size());
+            EXPECT_EQ(cv::norm(tiledOutImg, untiledOutImg, cv::NORM_INF), 0.0);
+        }
+    }
+}
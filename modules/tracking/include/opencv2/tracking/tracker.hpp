@@ -525,6 +525,17 @@ class CV_EXPORTS_W Tracker : public virtual Algorithm
 {
  public:
 
+  /** @brief Stages of update() timed by getStageTime()
+   */
+  enum Stage
+  {
+    STAGE_FEATURE_EXTRACTION = 0, //!< color conversion, sampling and feature extraction on the frame
+    STAGE_DETECTION = 1,          //!< detection or correlation that locates the target
+    STAGE_MODEL_UPDATE = 2,       //!< learning the target appearance at the new location
+    NUM_STAGES = 3
+  };
+
+  Tracker();
   virtual ~Tracker() CV_OVERRIDE;
 
   /** @brief Initialize the tracker with a known bounding box that surrounded the target
@@ -546,6 +557,18 @@ class CV_EXPORTS_W Tracker : public virtual Algorithm
      */
   CV_WRAP bool update( InputArray image, CV_OUT Rect2d& boundingBox );
 
+  /** @brief Returns the time in milliseconds the last update() spent in a stage
+    @param stage One of Tracker::Stage
+
+    Stages a tracker doesn't have, or doesn't reach because the target was lost, report 0. The
+    difference between getUpdateTime() and the sum of the stages is bookkeeping outside the stages.
+     */
+  CV_WRAP double getStageTime( int stage ) const;
+
+  /** @brief Returns the time in milliseconds spent by the last update()
+     */
+  CV_WRAP double getUpdateTime() const;
+
   virtual void read( const FileNode& fn ) CV_OVERRIDE = 0;
   virtual void write( FileStorage& fs ) const CV_OVERRIDE = 0;
 
@@ -554,8 +577,25 @@ class CV_EXPORTS_W Tracker : public virtual Algorithm
   virtual bool initImpl( const Mat& image, const Rect2d& boundingBox ) = 0;
   virtual bool updateImpl( const Mat& image, Rect2d& boundingBox ) = 0;
 
+  /** @brief Adds the time elapsed since startTicks, taken with getTickCount(), to a stage of the
+    current update
+     */
+  void addStageTime( int stage, int64 startTicks );
+
+  /** @brief Clears the stage times of the previous update and returns the start ticks of a new one,
+    for updates which don't go through update()
+     */
+  int64 startUpdate();
+
+  /** @brief Sets the update time from the start ticks returned by startUpdate()
+     */
+  void finishUpdate( int64 startTicks );
+
   bool isInit;
 
+  double stageTimes[NUM_STAGES];  //!< per stage time of the last update in milliseconds
+  double updateTime;              //!< time of the last update in milliseconds
+
   Ptr<TrackerFeatureSet> featureSet;
   Ptr<TrackerSampler> sampler;
   Ptr<TrackerModel> model;
@@ -1153,6 +1193,8 @@ class CV_EXPORTS_W TrackerMedianFlow : public Tracker
     TermCriteria termCriteria; //!<termination criteria for Lucas-Kanade optical flow
     cv::Size winSizeNCC;   //!<window size around a point for normalized cross-correlation check
     double maxMedianLengthOfDisplacementDifference; //!<criterion for loosing the tracked object
+    int maxScalePairs;     //!<maximal number of point pairs whose distance ratios give the scale median;
+                           //!<above it pairs are randomly sampled, 0 always uses all pairs
 
     void read( const FileNode& /*fn*/ );
     void write( FileStorage& /*fs*/ ) const;
@@ -1377,6 +1419,28 @@ public:
   */
   CV_WRAP const std::vector<Rect2d>& getObjects() const;
 
+  /**
+  * \brief Enables updating the trackers concurrently with cv::parallel_for_.
+  * Every tracker only reads the shared frame and writes its own bounding box, so the results are the
+  * same as with the serial update. TrackerBoosting draws from the process wide rand() state while
+  * updating, so Boosting trackers are still updated one after another in the order they were added.
+  * MIL seeds its sampler from the clock and is not reproducible in either mode. The frame is not
+  * preprocessed once for all trackers, use TrackerBatch to share the grayscale conversion of a frame.
+  * @param parallelUpdate true to update the trackers concurrently, false (default) to update them in order
+  */
+  CV_WRAP void setParallelUpdate(bool parallelUpdate);
+
+  /**
+  * \brief Returns true if the trackers are updated concurrently
+  */
+  CV_WRAP bool getParallelUpdate() const;
+
+  /**
+  * \brief Returns the time in milliseconds every tracker spent in its update() during the last update,
+  * in the same order as getObjects()
+  */
+  CV_WRAP const std::vector<double>& getUpdateTimes() const;
+
   /**
   * \brief Returns a pointer to a new instance of MultiTracker
   */
@@ -1388,6 +1452,15 @@ protected:
 
   //!<  storage for the tracked objects, each object corresponds to one tracker algorithm.
   std::vector<Rect2d> objects;
+
+  //!<  update time of every tracker in milliseconds, measured by the last update.
+  std::vector<double> updateTimes;
+
+  //!<  per tracker status of the last update, kept so the parallel update doesn't share a flag.
+  std::vector<uchar> updateStatus;
+
+  //!<  update the trackers concurrently.
+  bool parallelUpdate_;
 };
 
 /************************************ Multi-Tracker Classes ---By Tyan Vladimir---************************************/
@@ -1502,6 +1575,7 @@ public:
     bool use_rgb;
     bool use_channel_weights;
     bool use_segmentation;
+    bool use_float_precision; //!< compute HOG features and segmentation in float instead of double
 
     std::string window_function; //!<  Window function: "hann", "cheb", "kaiser"
     float kaiser_alpha;
@@ -1540,6 +1614,60 @@ public:
   virtual ~TrackerCSRT() CV_OVERRIDE {}
 };
 
+/************************************ Batch Tracker Class ************************************/
+/** @brief Tracks many targets of the same algorithm in one frame.
+
+Unlike MultiTracker, which runs one independent tracker per object, the batch tracker does the
+frame-level work once per frame for all of its targets: the grayscale conversion for MOSSE, the
+half resolution frame for KCF, and the grayscale conversion, the image pyramids and the
+Lucas-Kanade calls for MedianFlow. The per-target work runs concurrently with cv::parallel_for_.
+ */
+class CV_EXPORTS_W TrackerBatch : public Algorithm
+{
+public:
+  virtual ~TrackerBatch() CV_OVERRIDE {}
+
+  /** @brief Adds targets to be tracked.
+  @param image the frame the targets are selected in, which must be the first frame or the frame last
+  passed to update()
+  @param boundingBoxes the initial bounding boxes of the new targets
+  @return true if all new targets were initialized
+  */
+  CV_WRAP virtual bool add(InputArray image, const std::vector<Rect2d>& boundingBoxes) = 0;
+
+  /** @brief Updates all targets on the next frame.
+  @param image the next frame
+  @param boundingBoxes the bounding boxes of all targets in the order they were added; lost targets
+  keep their last bounding box
+  @param status 1 for the targets found in image, 0 for the lost ones
+  @return true if at least one target was found
+  */
+  CV_WRAP virtual bool update(InputArray image, CV_OUT std::vector<Rect2d>& boundingBoxes,
+                              CV_OUT std::vector<uchar>& status) = 0;
+
+  /** @brief Returns the number of targets added so far
+  */
+  CV_WRAP virtual int getNumTargets() const = 0;
+
+  /** @brief Creates a batch of KCF trackers sharing the parameters
+  @param parameters KCF parameters TrackerKCF::Params
+  */
+  static Ptr<TrackerBatch> createKCF(const TrackerKCF::Params &parameters);
+
+  CV_WRAP static Ptr<TrackerBatch> createKCF();
+
+  /** @brief Creates a batch of MOSSE trackers
+  */
+  CV_WRAP static Ptr<TrackerBatch> createMOSSE();
+
+  /** @brief Creates a batch of MedianFlow trackers sharing the parameters
+  @param parameters Median Flow parameters TrackerMedianFlow::Params
+  */
+  static Ptr<TrackerBatch> createMedianFlow(const TrackerMedianFlow::Params &parameters);
+
+  CV_WRAP static Ptr<TrackerBatch> createMedianFlow();
+};
+
 //! @}
 } /* namespace cv */
 
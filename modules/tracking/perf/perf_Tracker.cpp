@@ -40,6 +40,7 @@
  //M*/
 
 #include "perf_precomp.hpp"
+#include "../test/test_synthetic_frames.hpp"
 
 namespace opencv_test { namespace {
 
@@ -409,4 +410,139 @@ PERF_TEST_P(tracking, GOTURN, testing::Combine(TESTSET_NAMES, SEGMENTS))
 
 }
 
+//per-frame latency of a single target on synthetic 640x480 frames, no dataset needed
+typedef perf::TestBaseWithParam<int> tracking_kcf_frame;
+
+PERF_TEST_P(tracking_kcf_frame, kcf_update,
+            testing::Values( (int)TrackerKCF::GRAY, (int)TrackerKCF::CN, (int)( TrackerKCF::GRAY | TrackerKCF::CN ) ))
+{
+  TrackerKCF::Params params;
+  params.desc_pca = GetParam();
+  params.desc_npca = 0;
+  params.compress_feature = true;
+
+  Mat frames[2];
+  Rect target;
+  makeMovingSquareFrame( 1, frames[1], target, Size( 640, 480 ), Point( 200, 150 ), 64 );
+  makeMovingSquareFrame( 0, frames[0], target, Size( 640, 480 ), Point( 200, 150 ), 64 );
+
+  Ptr<Tracker> tracker = TrackerKCF::create( params );
+  Rect2d boundingBox( target );
+  ASSERT_TRUE( tracker->init( frames[0], boundingBox ) );
+
+  // the target moves back and forth between two frames so every cycle is a regular update
+  int frameIdx = 0;
+  TEST_CYCLE()
+  {
+    frameIdx ^= 1;
+    tracker->update( frames[frameIdx], boundingBox );
+  }
+
+  SANITY_CHECK_NOTHING();
+}
+
+//per-frame latency of every tracker on synthetic 640x480 sequences, no dataset needed
+enum SyntheticMotion
+{
+  MOTION_TRANSLATE = 0,  // the target moves along a line
+  MOTION_SCALE = 1       // the target grows in place
+};
+#define SYNTHETIC_TRACKERS testing::Values("KCF", "CSRT", "MOSSE", "MIL", "BOOSTING", "MEDIANFLOW", "TLD")
+#define SYNTHETIC_TARGET_SIZES testing::Values(32, 64, 128)
+#define SYNTHETIC_MOTIONS testing::Values((int)MOTION_TRANSLATE, (int)MOTION_SCALE)
+
+const int SYNTHETIC_FRAMES = 10;
+
+typedef perf::TestBaseWithParam<tuple<string, int, int> > tracking_synthetic;
+
+static Ptr<Tracker> createTrackerByName( const string& name )
+{
+  if( name == "KCF" )
+    return TrackerKCF::create();
+  if( name == "CSRT" )
+    return TrackerCSRT::create();
+  if( name == "MOSSE" )
+    return TrackerMOSSE::create();
+  if( name == "MIL" )
+    return TrackerMIL::create();
+  if( name == "BOOSTING" )
+    return TrackerBoosting::create();
+  if( name == "MEDIANFLOW" )
+    return TrackerMedianFlow::create();
+  if( name == "TLD" )
+    return TrackerTLD::create();
+  CV_Error( Error::StsBadArg, "Unknown tracker " + name );
+  return Ptr<Tracker>();
+}
+
+static void makeSyntheticSequence( int motion, int targetSize, std::vector<Mat>& frames, Rect& initialTarget )
+{
+  frames.resize( SYNTHETIC_FRAMES );
+  if( motion == MOTION_TRANSLATE )
+  {
+    for ( int i = 0; i < SYNTHETIC_FRAMES; i++ )
+    {
+      Rect target;
+      makeMovingSquareFrame( i, frames[i], target, Size( 640, 480 ), Point( 200, 150 ), targetSize );
+      if( i == 0 )
+        initialTarget = target;
+    }
+    return;
+  }
+
+  // the growing square is centered on the first one and always covers it
+  Mat background;
+  makeMovingSquareFrame( 0, background, initialTarget, Size( 640, 480 ),
+                         Point( 320 - targetSize / 2, 240 - targetSize / 2 ), targetSize );
+  Mat patch = background( initialTarget ).clone();
+  for ( int i = 0; i < SYNTHETIC_FRAMES; i++ )
+  {
+    int side = cvRound( targetSize * ( 1.0 + 0.02 * i ) );
+    Mat scaledPatch;
+    resize( patch, scaledPatch, Size( side, side ), 0, 0, INTER_LINEAR_EXACT );
+    background.copyTo( frames[i] );
+    scaledPatch.copyTo( frames[i]( Rect( 320 - side / 2, 240 - side / 2, side, side ) ) );
+  }
+}
+
+PERF_TEST_P(tracking_synthetic, update,
+            testing::Combine(SYNTHETIC_TRACKERS, SYNTHETIC_TARGET_SIZES, SYNTHETIC_MOTIONS))
+{
+  string trackerName = get<0>( GetParam() );
+  int targetSize = get<1>( GetParam() );
+  int motion = get<2>( GetParam() );
+
+  std::vector<Mat> frames;
+  Rect target;
+  makeSyntheticSequence( motion, targetSize, frames, target );
+
+  Ptr<Tracker> tracker = createTrackerByName( trackerName );
+  Rect2d boundingBox( target );
+  ASSERT_TRUE( tracker->init( frames[0], boundingBox ) );
+
+  // the sequence is played back and forth so the motion between two updates stays small
+  int frameIdx = 0;
+  int step = 1;
+  double stageTimes[Tracker::NUM_STAGES] = { 0.0, 0.0, 0.0 };
+  int numUpdates = 0;
+  TEST_CYCLE()
+  {
+    if( frameIdx + step < 0 || frameIdx + step >= SYNTHETIC_FRAMES )
+      step = -step;
+    frameIdx += step;
+    tracker->update( frames[frameIdx], boundingBox );
+
+    for ( int stage = 0; stage < Tracker::NUM_STAGES; stage++ )
+      stageTimes[stage] += tracker->getStageTime( stage );
+    numUpdates++;
+  }
+
+  // mean time of every stage, reported next to the perf results
+  const char* stageNames[Tracker::NUM_STAGES] = { "feature_extraction_ms", "detection_ms", "model_update_ms" };
+  for ( int stage = 0; stage < Tracker::NUM_STAGES; stage++ )
+    RecordProperty( stageNames[stage], format( "%.4f", stageTimes[stage] / std::max( numUpdates, 1 ) ) );
+
+  SANITY_CHECK_NOTHING();
+}
+
 }} // namespace
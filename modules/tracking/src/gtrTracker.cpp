@@ -117,6 +117,7 @@ bool TrackerGOTURNImpl::initImpl(const Mat& image, const Rect2d& boundingBox)
 bool TrackerGOTURNImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
 {
     int INPUT_SIZE = 227;
+    int64 stageStart = getTickCount();
     //Using prevFrame & prevBB from model and curFrame GOTURN calculating curBB
     Mat curFrame = image.clone();
     Mat prevFrame = ((TrackerGOTURNModel*)static_cast<TrackerModel*>(model))->getImage();
@@ -151,7 +152,9 @@ bool TrackerGOTURNImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
     //Convert to Float type and subtract mean
     Mat targetBlob = dnn::blobFromImage(targetPatch, 1.0f, Size(), Scalar::all(128), false);
     Mat searchBlob = dnn::blobFromImage(searchPatch, 1.0f, Size(), Scalar::all(128), false);
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
 
+    stageStart = getTickCount();
     net.setInput(targetBlob, "data1");
     net.setInput(searchBlob, "data2");
 
@@ -164,10 +167,13 @@ bool TrackerGOTURNImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
 
     //Predicted BB
     boundingBox = curBB;
+    addStageTime(STAGE_DETECTION, stageStart);
 
     //Set new model image and BB from current frame
+    stageStart = getTickCount();
     ((TrackerGOTURNModel*)static_cast<TrackerModel*>(model))->setImage(curFrame);
     ((TrackerGOTURNModel*)static_cast<TrackerModel*>(model))->setBoudingBox(curBB);
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
 
     return true;
 }
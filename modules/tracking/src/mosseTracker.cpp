@@ -14,6 +14,8 @@
 //
 
 #include "opencv2/tracking.hpp"
+#include "tracking_utils.hpp"
+#include "trackerBatch.hpp"
 
 namespace cv {
 namespace tracking {
@@ -37,41 +39,10 @@ protected:
     Point2d center; //center of the bounding box
     Size size;      //size of the bounding box
     Mat hanWin;
+    // spectrums are kept in the packed CCS format of dft() on real input
     Mat G;          //goal
     Mat H, A, B;    //state
 
-    //  Element-wise division of complex numbers in src1 and src2
-    Mat divDFTs( const Mat &src1, const Mat &src2 ) const
-    {
-        Mat c1[2],c2[2],a1,a2,s1,s2,denom,re,im;
-
-        // split into re and im per src
-        cv::split(src1, c1);
-        cv::split(src2, c2);
-
-        // (Re2*Re2 + Im2*Im2) = denom
-        //   denom is same for both channels
-        cv::multiply(c2[0], c2[0], s1);
-        cv::multiply(c2[1], c2[1], s2);
-        cv::add(s1, s2, denom);
-
-        // (Re1*Re2 + Im1*Im1)/(Re2*Re2 + Im2*Im2) = Re
-        cv::multiply(c1[0], c2[0], a1);
-        cv::multiply(c1[1], c2[1], a2);
-        cv::divide(a1+a2, denom, re, 1.0 );
-
-        // (Im1*Re2 - Re1*Im2)/(Re2*Re2 + Im2*Im2) = Im
-        cv::multiply(c1[1], c2[0], a1);
-        cv::multiply(c1[0], c2[1], a2);
-        cv::divide(a1+a2, denom, im, -1.0);
-
-        // Merge Re and Im back into a complex matrix
-        Mat dst, chn[] = {re,im};
-        cv::merge(chn, 2, dst);
-        return dst;
-    }
-
-
     void preProcess( Mat &window ) const
     {
         window.convertTo(window, CV_32F);
@@ -91,7 +62,7 @@ protected:
     {
         Mat IMAGE_SUB, RESPONSE, response;
         // filter in dft space
-        dft(image_sub, IMAGE_SUB, DFT_COMPLEX_OUTPUT);
+        dft(image_sub, IMAGE_SUB);
         mulSpectrums(IMAGE_SUB, H, RESPONSE, 0, true );
         idft(RESPONSE, response, DFT_SCALE|DFT_REAL_OUTPUT);
         // update center position
@@ -162,7 +133,7 @@ protected:
         double maxVal;
         minMaxLoc(g, 0, &maxVal);
         g = g / maxVal;
-        dft(g, G, DFT_COMPLEX_OUTPUT);
+        dft(g, G);
 
         // initial A,B and H
         A = Mat::zeros(G.size(), G.type());
@@ -173,13 +144,13 @@ protected:
             preProcess(window_warp);
 
             Mat WINDOW_WARP, A_i, B_i;
-            dft(window_warp, WINDOW_WARP, DFT_COMPLEX_OUTPUT);
+            dft(window_warp, WINDOW_WARP);
             mulSpectrums(G          , WINDOW_WARP, A_i, 0, true);
             mulSpectrums(WINDOW_WARP, WINDOW_WARP, B_i, 0, true);
             A+=A_i;
             B+=B_i;
         }
-        H = divDFTs(A,B);
+        tracking_internal::divSpectrumsCCS(A, B, H);
         return true;
     }
 
@@ -188,15 +159,19 @@ protected:
         if (H.empty()) // not initialized
             return false;
 
+        int64 stageStart = getTickCount();
         Mat image_sub;
         getRectSubPix(image, size, center, image_sub);
 
         if (image_sub.channels() != 1)
             cvtColor(image_sub, image_sub, COLOR_BGR2GRAY);
         preProcess(image_sub);
+        addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
 
+        stageStart = getTickCount();
         Point delta_xy;
         double PSR = correlate(image_sub, delta_xy);
+        addStageTime(STAGE_DETECTION, stageStart);
         if (PSR < psrThreshold)
             return false;
 
@@ -204,22 +179,26 @@ protected:
         center.x += delta_xy.x;
         center.y += delta_xy.y;
 
+        stageStart = getTickCount();
         Mat img_sub_new;
         getRectSubPix(image, size, center, img_sub_new);
         if (img_sub_new.channels() != 1)
             cvtColor(img_sub_new, img_sub_new, COLOR_BGR2GRAY);
         preProcess(img_sub_new);
+        addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
 
         // new state for A and B
+        stageStart = getTickCount();
         Mat F, A_new, B_new;
-        dft(img_sub_new, F, DFT_COMPLEX_OUTPUT);
+        dft(img_sub_new, F);
         mulSpectrums(G, F, A_new, 0, true );
         mulSpectrums(F, F, B_new, 0, true );
 
         // update A ,B, and H
         A = A*(1-rate) + A_new*rate;
         B = B*(1-rate) + B_new*rate;
-        H = divDFTs(A, B);
+        tracking_internal::divSpectrumsCCS(A, B, H);
+        addStageTime(STAGE_MODEL_UPDATE, stageStart);
 
         // return tracked rect
         double x=center.x, y=center.y;
@@ -237,6 +216,38 @@ public:
 
 }; // MosseImpl
 
+
+// MOSSE only looks at the grayscale frame, so the conversion is done once for all targets
+struct TrackerBatchMOSSEImpl CV_FINAL : TrackerBatchImpl
+{
+protected:
+    virtual bool updateTarget( size_t idx ) CV_OVERRIDE
+    {
+        Rect2d boundingBox;
+        if (!trackers[idx]->update(gray, boundingBox))
+            return false;
+        objects[idx] = boundingBox;
+        return true;
+    }
+
+    virtual void prepareFrame( const Mat& image ) CV_OVERRIDE
+    {
+        if (image.channels() == 1)
+            gray = image;
+        else
+            cvtColor(image, gray, COLOR_BGR2GRAY);
+    }
+
+    virtual bool initTarget( size_t idx ) CV_OVERRIDE
+    {
+        trackers.push_back(TrackerMOSSE::create());
+        return trackers[idx]->init(gray, objects[idx]);
+    }
+
+    std::vector< Ptr<TrackerMOSSE> > trackers;
+    Mat gray;
+}; // TrackerBatchMOSSEImpl
+
 } // tracking
 
 
@@ -245,5 +256,10 @@ Ptr<TrackerMOSSE> TrackerMOSSE::create()
     return makePtr<tracking::MosseImpl>();
 }
 
+Ptr<TrackerBatch> TrackerBatch::createMOSSE()
+{
+    return makePtr<tracking::TrackerBatchMOSSEImpl>();
+}
+
 
 } // cv
@@ -43,8 +43,45 @@
 
 namespace cv {
 
+  // updates a range of the listed trackers of a MultiTracker on the same frame
+  class ParallelUpdateTrackers : public ParallelLoopBody
+  {
+  public:
+    ParallelUpdateTrackers( const Mat& image_, const std::vector<int>& indices_, std::vector< Ptr<Tracker> >& trackers_,
+                            std::vector<Rect2d>& objects_, std::vector<uchar>& status_, std::vector<double>& times_ ) :
+        image(image_), indices(indices_), trackers(trackers_), objects(objects_), status(status_), times(times_)
+    {
+    }
+
+    virtual void operator ()( const Range& range ) const CV_OVERRIDE
+    {
+      for( int k = range.start; k < range.end; k++ )
+      {
+        int i = indices[k];
+        int64 start = getTickCount();
+        status[i] = trackers[i]->update( image, objects[i] ) ? 1 : 0;
+        times[i] = ( getTickCount() - start ) * 1000.0 / getTickFrequency();
+      }
+    }
+
+  private:
+    const Mat& image;
+    const std::vector<int>& indices;
+    std::vector< Ptr<Tracker> >& trackers;
+    std::vector<Rect2d>& objects;
+    std::vector<uchar>& status;
+    std::vector<double>& times;
+  };
+
+  // the online boosting classifier of TrackerBoosting samples with rand(), whose state is shared by all
+  // threads, so the order of its draws is only reproducible when these trackers run one after another
+  static bool drawsFromSharedRand( const Ptr<Tracker>& tracker )
+  {
+    return !tracker.dynamicCast<TrackerBoosting>().empty();
+  }
+
   // constructor
-  MultiTracker::MultiTracker(){};
+  MultiTracker::MultiTracker() : parallelUpdate_(false) {};
 
   // destructor
   MultiTracker::~MultiTracker(){};
@@ -80,9 +117,31 @@ namespace cv {
   // update position of the tracked objects, the result is stored in internal storage
   bool MultiTracker::update(InputArray image)
   {
+    // the frame is fetched once and shared by all trackers, a UMat is only mapped once
+    Mat frame = image.getMat();
+
+    updateStatus.resize(trackerList.size());
+    updateTimes.resize(trackerList.size());
+
+    std::vector<int> concurrent, inOrder;
+    for(int i = 0; i < (int)trackerList.size(); i++){
+      if(parallelUpdate_ && !drawsFromSharedRand(trackerList[i]))
+        concurrent.push_back(i);
+      else
+        inOrder.push_back(i);
+    }
+
+    if(concurrent.size() > 1){
+      parallel_for_(Range(0, (int)concurrent.size()),
+                    ParallelUpdateTrackers(frame, concurrent, trackerList, objects, updateStatus, updateTimes));
+    }else{
+      inOrder.insert(inOrder.begin(), concurrent.begin(), concurrent.end());
+    }
+    ParallelUpdateTrackers(frame, inOrder, trackerList, objects, updateStatus, updateTimes)(Range(0, (int)inOrder.size()));
+
     bool status = true;
     for(unsigned i=0;i< trackerList.size(); i++){
-      status &= trackerList[i]->update(image, objects[i]);
+      status &= updateStatus[i] != 0;
     }
     return status;
   };
@@ -100,6 +159,21 @@ namespace cv {
       return objects;
   }
 
+  void MultiTracker::setParallelUpdate(bool parallelUpdate)
+  {
+      parallelUpdate_ = parallelUpdate;
+  }
+
+  bool MultiTracker::getParallelUpdate() const
+  {
+      return parallelUpdate_;
+  }
+
+  const std::vector<double>& MultiTracker::getUpdateTimes() const
+  {
+      return updateTimes;
+  }
+
   Ptr<MultiTracker> MultiTracker::create()
   {
       return makePtr<MultiTracker>();
@@ -43,11 +43,57 @@
 #include "tracking_utils.hpp"
 
 #include <opencv2/core/utility.hpp>
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv
 {
 	namespace tld
 	{
+		void patchSums(const uchar* p, unsigned& sum, unsigned& sqsum)
+		{
+			sum = 0;
+			sqsum = 0;
+			for (int j = 0; j < STANDARD_PATCH_AREA; j++)
+			{
+				sum += p[j];
+				sqsum += p[j] * p[j];
+			}
+		}
+
+		unsigned storedPatchSums(const uchar* stored, const uchar* query, unsigned& sum, unsigned& sqsum)
+		{
+			unsigned prod = 0;
+			sum = 0;
+			sqsum = 0;
+			int j = 0;
+#if CV_SIMD128
+			// 16 bit lanes hold the pixels, the dot products widen to exact 32 bit sums
+			const v_int16x8 ones = v_setall_s16(1);
+			v_int32x4 vsum = v_setzero_s32(), vsqsum = v_setzero_s32(), vprod = v_setzero_s32();
+			for (; j <= STANDARD_PATCH_AREA - v_uint8x16::nlanes; j += v_uint8x16::nlanes)
+			{
+				v_uint16x8 s0, s1, q0, q1;
+				v_expand(v_load(stored + j), s0, s1);
+				v_expand(v_load(query + j), q0, q1);
+				v_int16x8 a0 = v_reinterpret_as_s16(s0), a1 = v_reinterpret_as_s16(s1);
+				v_int16x8 b0 = v_reinterpret_as_s16(q0), b1 = v_reinterpret_as_s16(q1);
+				vsum += v_dotprod(a0, ones) + v_dotprod(a1, ones);
+				vsqsum += v_dotprod(a0, a0) + v_dotprod(a1, a1);
+				vprod += v_dotprod(a0, b0) + v_dotprod(a1, b1);
+			}
+			sum = (unsigned)v_reduce_sum(vsum);
+			sqsum = (unsigned)v_reduce_sum(vsqsum);
+			prod = (unsigned)v_reduce_sum(vprod);
+#endif
+			for (; j < STANDARD_PATCH_AREA; j++)
+			{
+				sum += stored[j];
+				sqsum += stored[j] * stored[j];
+				prod += stored[j] * query[j];
+			}
+			return prod;
+		}
+
 		// Calculate offsets for classifiers
 		void TLDDetector::prepareClassifiers(int rowstep)
 		{
@@ -65,15 +111,73 @@ namespace cv
 			return p;
 		}
 
+		// Lay the measurements of all classifiers out as pixel offsets for one row step
+		void TLDDetector::prepareFerns(int rowstep)
+		{
+			if (rowstep == fernRowStep && !fernOffsetsA.empty())
+				return;
+			fernRowStep = rowstep;
+			fernMeasures = classifiers.empty() ? 0 : (int)classifiers[0].measurements.size();
+			fernOffsetsA.resize(classifiers.size() * fernMeasures);
+			fernOffsetsB.resize(classifiers.size() * fernMeasures);
+			for (int k = 0; k < (int)classifiers.size(); k++)
+			{
+				CV_Assert((int)classifiers[k].measurements.size() == fernMeasures);
+				for (int i = 0; i < fernMeasures; i++)
+				{
+					const Vec4b& m = classifiers[k].measurements[i];
+					fernOffsetsA[k * fernMeasures + i] = rowstep * m.val[2] + m.val[0];
+					fernOffsetsB[k * fernMeasures + i] = rowstep * m.val[3] + m.val[1];
+				}
+			}
+		}
+
+		// Posterior of every code of every fern, the ensemble only changes between detections
+		void TLDDetector::prepareFernPosteriors()
+		{
+			fernPosteriors.resize(classifiers.empty() ? 0 : classifiers.size() * classifiers[0].posAndNeg.size());
+			int idx = 0;
+			for (int k = 0; k < (int)classifiers.size(); k++)
+			{
+				const std::vector<Point2i>& posAndNeg = classifiers[k].posAndNeg;
+				CV_Assert(idx + (int)posAndNeg.size() <= (int)fernPosteriors.size());
+				for (int c = 0; c < (int)posAndNeg.size(); c++, idx++)
+				{
+					double posNum = (double)posAndNeg[c].x, negNum = (double)posAndNeg[c].y;
+					fernPosteriors[idx] = (posNum == 0.0 && negNum == 0.0) ? 0.0 : posNum / (posNum + negNum);
+				}
+			}
+		}
+
+		double fernsPosterior(const uchar* data, const int* offsetsA, const int* offsetsB, const double* posteriors,
+			int numFerns, int numMeasures)
+		{
+			const int numCodes = 1 << numMeasures;
+			double p = 0;
+			for (int k = 0; k < numFerns; k++, offsetsA += numMeasures, offsetsB += numMeasures)
+			{
+				int position = 0;
+				for (int i = 0; i < numMeasures; i++)
+					position = (position << 1) + (data[offsetsA[i]] < data[offsetsB[i]] ? 1 : 0);
+				p += posteriors[k * numCodes + position];
+			}
+			p /= numFerns;
+			return p;
+		}
+
+		// Same as ensembleClassifierNum() on the fern arrays prepared for the row step of data
+		double TLDDetector::ensembleClassifierFerns(const uchar* data) const
+		{
+			return fernsPosterior(data, &fernOffsetsA[0], &fernOffsetsB[0], &fernPosteriors[0],
+				(int)classifiers.size(), fernMeasures);
+		}
+
         double TLDDetector::computeSminus(const Mat_<uchar>& patch) const
         {
             double sminus = 0.0;
-            Mat_<uchar> modelSample(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
+            StoreSimilarity similarity(patch);
             for (int i = 0; i < *negNum; i++)
-            {
-                modelSample.data = &(negExp->data[i * 225]);
-                sminus = std::max(sminus, 0.5 * (tracking_internal::computeNCC(modelSample, patch) + 1.0));
-            }
+                sminus = std::max(sminus, similarity(*negExp, i));
             return sminus;
         }
 
@@ -81,12 +185,9 @@ namespace cv
 		double TLDDetector::Sr(const Mat_<uchar>& patch) const
 		{
 			double splus = 0.0, sminus = 0.0;
-            Mat_<uchar> modelSample(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
+            StoreSimilarity similarity(patch);
 			for (int i = 0; i < *posNum; i++)
-			{
-				modelSample.data = &(posExp->data[i * 225]);
-                splus = std::max(splus, 0.5 * (tracking_internal::computeNCC(modelSample, patch) + 1.0));
-			}
+                splus = std::max(splus, similarity(*posExp, i));
             sminus = computeSminus(patch);
 
 			if (splus + sminus == 0.0)
@@ -97,12 +198,11 @@ namespace cv
         std::pair<double, double> TLDDetector::SrAndSc(const Mat_<uchar>& patch) const
         {
             double splusC = 0.0, sminus = 0.0, splus = 0.0;
-            Mat_<uchar> modelSample(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
+            StoreSimilarity similarity(patch);
             int med = tracking_internal::getMedian((*timeStampsPositive));
             for (int i = 0; i < *posNum; i++)
             {
-                modelSample.data = &(posExp->data[i * 225]);
-                double s = 0.5 * (tracking_internal::computeNCC(modelSample, patch) + 1.0);
+                double s = similarity(*posExp, i);
 
                 if ((int)(*timeStampsPositive)[i] <= med)
                     splusC = std::max(splusC, s);
@@ -226,15 +326,12 @@ namespace cv
 		double TLDDetector::Sc(const Mat_<uchar>& patch) const
 		{
 			double splus = 0.0, sminus = 0.0;
-			Mat_<uchar> modelSample(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
+			StoreSimilarity similarity(patch);
             int med = tracking_internal::getMedian((*timeStampsPositive));
 			for (int i = 0; i < *posNum; i++)
 			{
 				if ((int)(*timeStampsPositive)[i] <= med)
-				{
-					modelSample.data = &(posExp->data[i * 225]);
-                    splus = std::max(splus, 0.5 * (tracking_internal::computeNCC(modelSample, patch) + 1.0));
-				}
+                    splus = std::max(splus, similarity(*posExp, i));
 			}
             sminus = computeSminus(patch);
 
@@ -357,6 +454,57 @@ namespace cv
 			CalcScSrParallelLoopBody& operator= (const CalcScSrParallelLoopBody&);
 		};
 
+		// Variance filter and ensemble classification of the windows of one scale, a column of windows at a time.
+		// Every column writes its own part of the results, the windows keep the order of the serial scan.
+		class ScanWindowsParallelLoopBody: public cv::ParallelLoopBody
+		{
+		public:
+			ScanWindowsParallelLoopBody (const TLDDetector * detector, const Mat_<double>& intImgP, const Mat_<double>& intImgP2,
+				const Mat& blurred, int dx, int dy, int numRows, Size initSize, uchar * results):
+				detectorF (detector), intImgPF (intImgP), intImgP2F (intImgP2), blurredF (blurred),
+				dxF (dx), dyF (dy), numRowsF (numRows), initSizeF (initSize), resultsF (results)
+			{
+			}
+
+			virtual void operator () (const cv::Range & r) const CV_OVERRIDE
+			{
+				const int width = initSizeF.width, height = initSizeF.height;
+				const double minVariance = VARIANCE_THRESHOLD * *detectorF->originalVariancePtr;
+				for (int i = r.start; i < r.end; i++)
+				{
+					const int x = dxF * i;
+					for (int j = 0; j < numRowsF; j++)
+					{
+						const int y = dyF * j;
+
+						// batched variance filter on the integral images, same arithmetic as patchVariance()
+						const double* top = intImgPF[y];
+						const double* bottom = intImgPF[y + height];
+						double p = (top[x] + bottom[x + width] - top[x + width] - bottom[x]) / (width * height);
+						top = intImgP2F[y];
+						bottom = intImgP2F[y + height];
+						double p2 = (top[x] + bottom[x + width] - top[x + width] - bottom[x]) / (width * height);
+
+						uchar result = 0;
+						if ((p2 - p * p) > minVariance)
+							result = detectorF->ensembleClassifierFerns(blurredF.ptr<uchar>(y) + x) <= ENSEMBLE_THRESHOLD ? 1 : 2;
+						resultsF[i * numRowsF + j] = result;
+					}
+				}
+			}
+
+		private:
+			const TLDDetector * detectorF;
+			const Mat_<double>& intImgPF;
+			const Mat_<double>& intImgP2F;
+			const Mat& blurredF;
+			const int dxF, dyF, numRowsF;
+			const Size initSizeF;
+			uchar * resultsF;
+			ScanWindowsParallelLoopBody (const ScanWindowsParallelLoopBody&);
+			ScanWindowsParallelLoopBody& operator= (const ScanWindowsParallelLoopBody&);
+		};
+
 		bool TLDDetector::detect(const Mat& img, const Mat& imgBlurred, Rect2d& res, std::vector<LabeledPatch>& patches, Size initSize)
 		{
 			patches.clear();
@@ -377,7 +525,8 @@ namespace cv
 			ensScaleIDs.clear ();
 
 			//Detection part
-			//Generate windows and filter by variance
+			//Generate windows, filter them by variance and classify them with the ensemble
+			prepareFernPosteriors();
 			scaleID = 0;
 			resized_imgs.push_back(img);
 			blurred_imgs.push_back(imgBlurred);
@@ -385,14 +534,29 @@ namespace cv
 			{
 				Mat_<double> intImgP, intImgP2;
 				computeIntegralImages(resized_imgs[scaleID], intImgP, intImgP2);
-				for (int i = 0, imax = cvFloor((0.0 + resized_imgs[scaleID].cols - initSize.width) / dx); i < imax; i++)
+				prepareFerns(static_cast<int> (blurred_imgs[scaleID].step[0]));
+
+				const int imax = std::max(cvFloor((0.0 + resized_imgs[scaleID].cols - initSize.width) / dx), 0);
+				const int jmax = std::max(cvFloor((0.0 + resized_imgs[scaleID].rows - initSize.height) / dy), 0);
+				windowResults.resize((size_t)imax * jmax);
+				if (imax > 0 && jmax > 0)
 				{
-					for (int j = 0, jmax = cvFloor((0.0 + resized_imgs[scaleID].rows - initSize.height) / dy); j < jmax; j++)
+					cv::parallel_for_ (cv::Range (0, imax), ScanWindowsParallelLoopBody (this, intImgP, intImgP2,
+						blurred_imgs[scaleID], dx, dy, jmax, initSize, &windowResults[0]));
+				}
+				for (int i = 0; i < imax; i++)
+				{
+					for (int j = 0; j < jmax; j++)
 					{
-						if (!patchVariance(intImgP, intImgP2, originalVariancePtr, Point(dx * i, dy * j), initSize))
+						const uchar result = windowResults[i * jmax + j];
+						if (result == 0)
 							continue;
 						varBuffer.push_back(Point(dx * i, dy * j));
 						varScaleIDs.push_back(scaleID);
+						if (result == 1)
+							continue;
+						ensBuffer.push_back(Point(dx * i, dy * j));
+						ensScaleIDs.push_back(scaleID);
 					}
 				}
 				scaleID++;
@@ -405,16 +569,6 @@ namespace cv
 				blurred_imgs.push_back(tmp);
 			} while (size.width >= initSize.width && size.height >= initSize.height);
 
-			//Encsemble classification
-			for (int i = 0; i < (int)varBuffer.size(); i++)
-			{
-				prepareClassifiers(static_cast<int> (blurred_imgs[varScaleIDs[i]].step[0]));
-				if (ensembleClassifierNum(&blurred_imgs[varScaleIDs[i]].at<uchar>(varBuffer[i].y, varBuffer[i].x)) <= ENSEMBLE_THRESHOLD)
-					continue;
-				ensBuffer.push_back(varBuffer[i]);
-				ensScaleIDs.push_back(varScaleIDs[i]);
-			}
-
 			//Batch preparation
 			srValues.resize (ensBuffer.size());
 			scValues.resize (ensBuffer.size());
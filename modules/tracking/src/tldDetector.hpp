@@ -69,10 +69,51 @@ namespace cv
 
 
 
+		const int STANDARD_PATCH_AREA = STANDARD_PATCH_SIZE * STANDARD_PATCH_SIZE;
+
+		// Sum and sum of squares of a standard patch
+		CV_EXPORTS void patchSums(const uchar* p, unsigned& sum, unsigned& sqsum);
+		// Sum and sum of squares of a stored standard patch together with its dot product with the query patch
+		CV_EXPORTS unsigned storedPatchSums(const uchar* stored, const uchar* query, unsigned& sum, unsigned& sqsum);
+		// Mean posterior of numFerns ferns at data: measure i of fern k compares the pixels at offsetsA and offsetsB
+		// [k * numMeasures + i], the code of fern k picks its posterior from posteriors[k << numMeasures ...]
+		CV_EXPORTS double fernsPosterior(const uchar* data, const int* offsetsA, const int* offsetsB, const double* posteriors,
+			int numFerns, int numMeasures);
+
+		// Similarity of a query patch of STANDARD_PATCH_SIZE x STANDARD_PATCH_SIZE with the patches of a
+		// positive or negative store. The sums of the query are computed once for the whole store.
+		class StoreSimilarity
+		{
+		public:
+			explicit StoreSimilarity(const Mat_<uchar>& patch) : query(patch.data)
+			{
+				CV_DbgAssert(patch.isContinuous() && (int)patch.total() == STANDARD_PATCH_AREA);
+				unsigned sum, sqsum;
+				patchSums(query, sum, sqsum);
+				s2 = sum;
+				sq2 = sqrt(std::max(0.0, sqsum - 1.0 * sum * sum / STANDARD_PATCH_AREA));
+			}
+
+			// 0.5 * (NCC + 1) of the stored patch idx, the same value as tracking_internal::computeNCC gives
+			double operator()(const Mat& store, int idx) const
+			{
+				unsigned s1, n1;
+				unsigned prod = storedPatchSums(store.data + idx * STANDARD_PATCH_AREA, query, s1, n1);
+				double sq1 = sqrt(std::max(0.0, n1 - 1.0 * s1 * s1 / STANDARD_PATCH_AREA));
+				double ncc = (sq2 == 0) ? sq1 / std::abs(sq1) : (prod - 1.0 * s1 * s2 / STANDARD_PATCH_AREA) / sq1 / sq2;
+				return 0.5 * (ncc + 1.0);
+			}
+
+		private:
+			const uchar* query;
+			unsigned s2;
+			double sq2;
+		};
+
 		class TLDDetector
 		{
 		public:
-			TLDDetector(){}
+			TLDDetector() : fernMeasures(0), fernRowStep(-1) {}
 			~TLDDetector(){}
 			double ensembleClassifierNum(const uchar* data);
 			void prepareClassifiers(int rowstep);
@@ -98,6 +139,14 @@ namespace cv
 			std::vector <Point> varBuffer, ensBuffer;
 			std::vector <int> varScaleIDs, ensScaleIDs;
 
+			// Ferns as struct of arrays: pixel offsets of the compared pairs, fern after fern, for one row step,
+			// and the posterior of every fern code, rebuilt from the classifiers by every detect()
+			std::vector <int> fernOffsetsA, fernOffsetsB;
+			std::vector <double> fernPosteriors;
+			int fernMeasures, fernRowStep;
+			// Result of the window scan of one scale: 0 rejected by variance, 1 by the ensemble, 2 accepted
+			std::vector <uchar> windowResults;
+
 			static void generateScanGrid(int rows, int cols, Size initBox, std::vector<Rect2d>& res, bool withScaling = false);
 			struct LabeledPatch
 			{
@@ -111,6 +160,10 @@ namespace cv
 			static void computeIntegralImages(const Mat& img, Mat_<double>& intImgP, Mat_<double>& intImgP2){ integral(img, intImgP, intImgP2, CV_64F); }
 			static inline bool patchVariance(Mat_<double>& intImgP, Mat_<double>& intImgP2, double *originalVariance, Point pt, Size size);
 
+			void prepareFerns(int rowstep);
+			void prepareFernPosteriors();
+			double ensembleClassifierFerns(const uchar* data) const;
+
         protected:
             double computeSminus(const Mat_<uchar>& patch) const;
 		};
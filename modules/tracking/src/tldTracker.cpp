@@ -117,6 +117,7 @@ bool TrackerTLDImpl::initImpl(const Mat& image, const Rect2d& boundingBox)
 
 bool TrackerTLDImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
 {
+    int64 stageStart = getTickCount();
     Mat image_gray, image_blurred, imageForDetector;
     if(image.channels() > 1)
     {
@@ -132,6 +133,10 @@ bool TrackerTLDImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
     else
         imageForDetector = image_gray;
     GaussianBlur(imageForDetector, image_blurred, GaussBlurKernelSize, 0.0);
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+
+    // the short-term tracker and the detector both propose candidates
+    stageStart = getTickCount();
     TrackerTLDModel* tldModel = ((TrackerTLDModel*)static_cast<TrackerModel*>(model));
     data->frameNum++;
     Mat_<uchar> standardPatch(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
@@ -173,6 +178,7 @@ bool TrackerTLDImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
 
     if( it == candidatesRes.end() ) //candidates are empty
     {
+        addStageTime(STAGE_DETECTION, stageStart);
         data->confident = false;
         data->failedLastTime = true;
         return false;
@@ -180,6 +186,8 @@ bool TrackerTLDImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
     else
     {
         boundingBox = candidates[it - candidatesRes.begin()];
+        addStageTime(STAGE_DETECTION, stageStart);
+        stageStart = getTickCount();
         data->failedLastTime = false;
         if( trackerNeedsReInit || it != candidatesRes.begin() )
             trackerProxy->init(image, boundingBox);
@@ -241,6 +249,7 @@ bool TrackerTLDImpl::updateImpl(const Mat& image, Rect2d& boundingBox)
         tldModel->integrateRelabeled(imageForDetector, image_blurred, detectorResults);
 #endif
     }
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
 
     return true;
 }
@@ -40,6 +40,7 @@
  //M*/
 
 #include "precomp.hpp"
+#include <algorithm>
 
 namespace cv
 {
@@ -48,6 +49,11 @@ namespace cv
  *  Tracker
  */
 
+Tracker::Tracker() : updateTime( 0 )
+{
+  std::fill( stageTimes, stageTimes + NUM_STAGES, 0.0 );
+}
+
 Tracker::~Tracker()
 {
 }
@@ -94,7 +100,40 @@ bool Tracker::update( InputArray image, Rect2d& boundingBox )
   if( image.empty() )
     return false;
 
-  return updateImpl( image.getMat(), boundingBox );
+  int64 startTicks = startUpdate();
+
+  bool found = updateImpl( image.getMat(), boundingBox );
+
+  finishUpdate( startTicks );
+  return found;
+}
+
+double Tracker::getStageTime( int stage ) const
+{
+  CV_Assert( stage >= 0 && stage < NUM_STAGES );
+  return stageTimes[stage];
+}
+
+double Tracker::getUpdateTime() const
+{
+  return updateTime;
+}
+
+void Tracker::addStageTime( int stage, int64 startTicks )
+{
+  CV_DbgAssert( stage >= 0 && stage < NUM_STAGES );
+  stageTimes[stage] += ( getTickCount() - startTicks ) * 1000.0 / getTickFrequency();
+}
+
+int64 Tracker::startUpdate()
+{
+  std::fill( stageTimes, stageTimes + NUM_STAGES, 0.0 );
+  return getTickCount();
+}
+
+void Tracker::finishUpdate( int64 startTicks )
+{
+  updateTime = ( getTickCount() - startTicks ) * 1000.0 / getTickFrequency();
 }
 
 } /* namespace cv */
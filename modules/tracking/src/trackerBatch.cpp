@@ -0,0 +1,86 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "trackerBatch.hpp"
+#include <algorithm>
+
+namespace cv
+{
+
+class ParallelUpdateTargets : public ParallelLoopBody
+{
+public:
+  ParallelUpdateTargets(TrackerBatchImpl* batch_, const std::vector<uchar>& initialized_,
+                        std::vector<uchar>& status_) :
+    batch(batch_), initialized(initialized_), status(status_)
+  {
+  }
+
+  virtual void operator ()(const Range& range) const CV_OVERRIDE
+  {
+    for (int i = range.start; i < range.end; i++)
+    {
+      // every target only writes its own box and status
+      status[i] = initialized[i] && batch->updateTarget((size_t)i) ? 1 : 0;
+    }
+  }
+
+private:
+  TrackerBatchImpl* batch;
+  const std::vector<uchar>& initialized;
+  std::vector<uchar>& status;
+};
+
+bool TrackerBatchImpl::add(InputArray image, const std::vector<Rect2d>& boundingBoxes)
+{
+  if (image.empty())
+    return false;
+
+  prepareFrame(image.getMat());
+
+  bool allInitialized = true;
+  for (size_t i = 0; i < boundingBoxes.size(); i++)
+  {
+    size_t idx = objects.size();
+    objects.push_back(boundingBoxes[i]);
+    objectStatus.push_back(0);
+    initialized.push_back(0);
+
+    initialized[idx] = initTarget(idx) ? 1 : 0;
+    objectStatus[idx] = initialized[idx];
+    allInitialized = allInitialized && initialized[idx];
+  }
+  return allInitialized;
+}
+
+bool TrackerBatchImpl::update(InputArray image, std::vector<Rect2d>& boundingBoxes, std::vector<uchar>& status)
+{
+  if (image.empty())
+    return false;
+
+  prepareFrame(image.getMat());
+  updateTargets();
+
+  boundingBoxes = objects;
+  status = objectStatus;
+  return std::find(objectStatus.begin(), objectStatus.end(), (uchar)1) != objectStatus.end();
+}
+
+int TrackerBatchImpl::getNumTargets() const
+{
+  return (int)objects.size();
+}
+
+void TrackerBatchImpl::updateTargets()
+{
+  parallel_for_(Range(0, (int)objects.size()), ParallelUpdateTargets(this, initialized, objectStatus));
+}
+
+bool TrackerBatchImpl::updateTarget(size_t /*idx*/)
+{
+  CV_Error(Error::StsNotImplemented, "The batch tracker has to implement updateTarget() or updateTargets()");
+  return false;
+}
+
+} /* namespace cv */
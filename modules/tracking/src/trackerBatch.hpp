@@ -0,0 +1,48 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef OPENCV_TRACKER_BATCH
+#define OPENCV_TRACKER_BATCH
+
+#include "precomp.hpp"
+
+namespace cv
+{
+
+/** Shared part of the batch trackers: keeps the targets and their status, prepares every frame once
+* and updates the targets concurrently. Every algorithm implements the frame preparation and the per
+* target init and update on the prepared frame.
+*/
+class TrackerBatchImpl : public TrackerBatch
+{
+public:
+  bool add(InputArray image, const std::vector<Rect2d>& boundingBoxes) CV_OVERRIDE;
+  bool update(InputArray image, std::vector<Rect2d>& boundingBoxes, std::vector<uchar>& status) CV_OVERRIDE;
+  int getNumTargets() const CV_OVERRIDE;
+
+protected:
+  friend class ParallelUpdateTargets;
+
+  /** frame-level work done once for all targets, e.g. the color conversion */
+  virtual void prepareFrame(const Mat& image) = 0;
+
+  /** initializes the new target idx with objects[idx] on the prepared frame */
+  virtual bool initTarget(size_t idx) = 0;
+
+  /** updates all initialized targets, concurrently through updateTarget() by default */
+  virtual void updateTargets();
+
+  /** updates the target idx on the prepared frame, only called for initialized targets by the
+  * default updateTargets(); algorithms which override updateTargets() don't have to implement it
+  */
+  virtual bool updateTarget(size_t idx);
+
+  std::vector<Rect2d> objects;        //!< last bounding box of every target
+  std::vector<uchar> objectStatus;    //!< 1 if the target was found in the last frame
+  std::vector<uchar> initialized;     //!< 1 if the target was initialized successfully
+};
+
+} /* namespace cv */
+
+#endif
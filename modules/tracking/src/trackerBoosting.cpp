@@ -205,6 +205,7 @@ bool TrackerBoostingImpl::initImpl( const Mat& image, const Rect2d& boundingBox
 
 bool TrackerBoostingImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
 {
+  int64 stageStart = getTickCount();
   Mat_<int> intImage;
   Mat_<double> intSqImage;
   Mat image_;
@@ -243,15 +244,19 @@ bool TrackerBoostingImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
   Ptr<TrackerFeatureHAAR> extractor = featureSet->getTrackerFeature()[0].second.staticCast<TrackerFeatureHAAR>();
   extractor->extractSelected( classifiers, detectSamples, response );
   responses.push_back( response );
+  addStageTime( STAGE_FEATURE_EXTRACTION, stageStart );
 
   //predict new location
+  stageStart = getTickCount();
   ConfidenceMap cmap;
   model.staticCast<TrackerBoostingModel>()->setMode( TrackerBoostingModel::MODE_CLASSIFY, detectSamples );
   model.staticCast<TrackerBoostingModel>()->responseToConfidenceMap( responses, cmap );
   model->getTrackerStateEstimator().staticCast<TrackerStateEstimatorAdaBoosting>()->setCurrentConfidenceMap( cmap );
   model->getTrackerStateEstimator().staticCast<TrackerStateEstimatorAdaBoosting>()->setSampleROI( ROI );
 
-  if( !model->runStateEstimator() )
+  bool located = model->runStateEstimator();
+  addStageTime( STAGE_DETECTION, stageStart );
+  if( !located )
   {
     return false;
   }
@@ -267,6 +272,7 @@ bool TrackerBoostingImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
    //waitKey( 0 );*/
 
   //sampling new frame based on new location
+  stageStart = getTickCount();
   //Positive sampling
   ( sampler->getSamplers().at( 0 ).second ).staticCast<TrackerSamplerCS>()->setMode( TrackerSamplerCS::MODE_POSITIVE );
   sampler->sampling( intImage, boundingBox );
@@ -286,8 +292,10 @@ bool TrackerBoostingImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
 
   featureSet->extraction( negSamples );
   const std::vector<Mat> negResponse = featureSet->getResponses();
+  addStageTime( STAGE_FEATURE_EXTRACTION, stageStart );
 
   //compute temp features
+  stageStart = getTickCount();
   TrackerFeatureHAAR::Params HAARparameters2;
   HAARparameters2.numFeatures = static_cast<int>( posSamples.size() + negSamples.size() );
   HAARparameters2.isIntegral = true;
@@ -315,6 +323,7 @@ bool TrackerBoostingImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
                                                                                                     trackerFeature2->getFeatureAt( (int)j ) );
     }
   }
+  addStageTime( STAGE_MODEL_UPDATE, stageStart );
 
   return true;
 }
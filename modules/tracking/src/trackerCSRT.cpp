@@ -116,11 +116,15 @@ bool TrackerCSRTImpl::check_mask_area(const Mat &mat, const double obj_area)
 
 Mat TrackerCSRTImpl::calculate_response(const Mat &image, const std::vector<Mat> filter)
 {
+    int64 stageStart = getTickCount();
     Mat patch = get_subwindow(image, object_center, cvFloor(current_scale_factor * template_size.width),
         cvFloor(current_scale_factor * template_size.height));
     resize(patch, patch, rescaled_template_size, 0, 0, INTER_CUBIC);
 
     std::vector<Mat> ftrs = get_features(patch, yf.size());
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+
+    stageStart = getTickCount();
     std::vector<Mat> Ffeatures = fourier_transform_features(ftrs);
     Mat resp, res;
     if(params.use_channel_weights){
@@ -141,16 +145,21 @@ Mat TrackerCSRTImpl::calculate_response(const Mat &image, const std::vector<Mat>
         }
         idft(res, res, DFT_SCALE | DFT_REAL_OUTPUT);
     }
+    addStageTime(STAGE_DETECTION, stageStart);
     return res;
 }
 
 void TrackerCSRTImpl::update_csr_filter(const Mat &image, const Mat &mask)
 {
+    int64 stageStart = getTickCount();
     Mat patch = get_subwindow(image, object_center, cvFloor(current_scale_factor * template_size.width),
         cvFloor(current_scale_factor * template_size.height));
     resize(patch, patch, rescaled_template_size, 0, 0, INTER_CUBIC);
 
     std::vector<Mat> ftrs = get_features(patch, yf.size());
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+
+    stageStart = getTickCount();
     std::vector<Mat> Fftrs = fourier_transform_features(ftrs);
     std::vector<Mat> new_csr_filter = create_csr_filter(Fftrs, yf, mask);
     //calculate per channel weights
@@ -183,6 +192,7 @@ void TrackerCSRTImpl::update_csr_filter(const Mat &image, const Mat &mask)
     }
     std::vector<Mat>().swap(ftrs);
     std::vector<Mat>().swap(Fftrs);
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
 }
 
 
@@ -190,7 +200,7 @@ std::vector<Mat> TrackerCSRTImpl::get_features(const Mat &patch, const Size2i &f
 {
     std::vector<Mat> features;
     if (params.use_hog) {
-        std::vector<Mat> hog = get_features_hog(patch, cell_size);
+        std::vector<Mat> hog = get_features_hog(patch, cell_size, params.use_float_precision);
         features.insert(features.end(), hog.begin(),
                 hog.begin()+params.num_hog_channels_used);
     }
@@ -328,6 +338,8 @@ Mat TrackerCSRTImpl::get_location_prior(
     Mat fg_prior = kernel_weight / max_val;
     fg_prior.setTo(0.5, fg_prior < 0.5);
     fg_prior.setTo(0.9, fg_prior > 0.9);
+    if(params.use_float_precision)
+        fg_prior.convertTo(fg_prior, CV_32F);
     return fg_prior;
 }
 
@@ -429,11 +441,14 @@ Point2f TrackerCSRTImpl::estimate_new_position(const Mat &image)
 
     Mat resp = calculate_response(image, csr_filter);
 
+    int64 stageStart = getTickCount();
     double max_val;
     Point max_loc;
     minMaxLoc(resp, NULL, &max_val, NULL, &max_loc);
-    if (max_val < params.psr_threshold)
+    if (max_val < params.psr_threshold) {
+        addStageTime(STAGE_DETECTION, stageStart);
         return Point2f(-1,-1); // target "lost"
+    }
 
     // take into account also subpixel accuracy
     float col = ((float) max_loc.x) + subpixel_peak(resp, "horizontal", max_loc);
@@ -456,6 +471,7 @@ Point2f TrackerCSRTImpl::estimate_new_position(const Mat &image)
         new_center.y = 0;
     if(new_center.y >= image_size.height)
         new_center.y = static_cast<float>(image_size.height - 1);
+    addStageTime(STAGE_DETECTION, stageStart);
 
     return new_center;
 }
@@ -465,24 +481,30 @@ Point2f TrackerCSRTImpl::estimate_new_position(const Mat &image)
 // *********************************************************************
 bool TrackerCSRTImpl::updateImpl(const Mat& image_, Rect2d& boundingBox)
 {
+    int64 stageStart = getTickCount();
     Mat image;
     if(image_.channels() == 1)    //treat gray image as color image
         cvtColor(image_, image, COLOR_GRAY2BGR);
     else
         image = image_;
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
 
     object_center = estimate_new_position(image);
     if (object_center.x < 0 && object_center.y < 0)
         return false;
 
+    // the scale search extracts and correlates its own features
+    stageStart = getTickCount();
     current_scale_factor = dsst.getScale(image, object_center);
     //update bouding_box according to new scale and location
     bounding_box.x = object_center.x - current_scale_factor * original_target_size.width / 2.0f;
     bounding_box.y = object_center.y - current_scale_factor * original_target_size.height / 2.0f;
     bounding_box.width = current_scale_factor * original_target_size.width;
     bounding_box.height = current_scale_factor * original_target_size.height;
+    addStageTime(STAGE_DETECTION, stageStart);
 
     //update tracker
+    stageStart = getTickCount();
     if(params.use_segmentation) {
         Mat hsv_img = bgr2hsv(image);
         update_histograms(hsv_img, bounding_box);
@@ -497,8 +519,11 @@ bool TrackerCSRTImpl::updateImpl(const Mat& image_, Rect2d& boundingBox)
     } else {
         filter_mask = default_mask;
     }
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
     update_csr_filter(image, filter_mask);
+    stageStart = getTickCount();
     dsst.update(image, object_center);
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
     boundingBox = bounding_box;
     return true;
 }
@@ -614,7 +639,8 @@ bool TrackerCSRTImpl::initImpl(const Mat& image_, const Rect2d& boundingBox)
 
     //initialize scale search
     dsst = DSST(image, bounding_box, template_size, params.number_of_scales, params.scale_step,
-            params.scale_model_max_area, params.scale_sigma_factor, params.scale_lr);
+            params.scale_model_max_area, params.scale_sigma_factor, params.scale_lr,
+            params.use_float_precision);
 
     model=Ptr<TrackerCSRTModel>(new TrackerCSRTModel(params));
     isInit = true;
@@ -629,6 +655,7 @@ TrackerCSRT::Params::Params()
     use_color_names = true;
     use_gray = true;
     use_rgb = false;
+    use_float_precision = false;
     window_function = "hann";
     kaiser_alpha = 3.75f;
     cheb_attenuation = 45;
@@ -709,6 +736,8 @@ void TrackerCSRT::Params::read(const FileNode& fn)
         fn["histogram_lr"] >> histogram_lr;
     if(!fn["psr_threshold"].empty())
         fn["psr_threshold"] >> psr_threshold;
+    if(!fn["use_float_precision"].empty())
+        fn["use_float_precision"] >> use_float_precision;
     CV_Assert(number_of_scales % 2 == 1);
     CV_Assert(use_gray || use_color_names || use_hog || use_rgb);
 }
@@ -741,5 +770,6 @@ void TrackerCSRT::Params::write(FileStorage& fs) const
     fs << "background_ratio" << background_ratio;
     fs << "histogram_lr" << histogram_lr;
     fs << "psr_threshold" << psr_threshold;
+    fs << "use_float_precision" << use_float_precision;
 }
 } /* namespace cv */
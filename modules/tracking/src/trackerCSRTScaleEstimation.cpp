@@ -23,7 +23,8 @@ public:
         Mat scale_window,
         Size scale_model_sz,
         int col_len,
-        Mat &result)
+        Mat &result,
+        bool use_float_precision)
     {
         this->img = img;
         this->pos = pos;
@@ -34,6 +35,7 @@ public:
         this->scale_model_sz = scale_model_sz;
         this->col_len = col_len;
         this->result = result;
+        this->use_float_precision = use_float_precision;
     }
     virtual void operator ()(const Range& range) const CV_OVERRIDE
     {
@@ -44,7 +46,7 @@ public:
             img_patch.convertTo(img_patch, CV_32FC3);
             resize(img_patch, img_patch, Size(scale_model_sz.width, scale_model_sz.height),0,0,INTER_LINEAR);
             std::vector<Mat> hog;
-            hog = get_features_hog(img_patch, 4);
+            hog = get_features_hog(img_patch, 4, use_float_precision);
             for (int i = 0; i < static_cast<int>(hog.size()); ++i) {
                 hog[i] = hog[i].t();
                 hog[i] = scale_window.at<float>(0,s) * hog[i].reshape(0, col_len);
@@ -67,6 +69,7 @@ private:
     Size scale_model_sz;
     int col_len;
     Mat result;
+    bool use_float_precision;
 };
 
 
@@ -77,9 +80,10 @@ DSST::DSST(const Mat &image,
         float scaleStep,
         float maxModelArea,
         float sigmaFactor,
-        float scaleLearnRate):
+        float scaleLearnRate,
+        bool useFloatPrecision):
     scales_count(numberOfScales), scale_step(scaleStep), max_model_area(maxModelArea),
-    sigma_factor(sigmaFactor), learn_rate(scaleLearnRate)
+    sigma_factor(sigmaFactor), learn_rate(scaleLearnRate), use_float_precision(useFloatPrecision)
 {
     original_targ_sz = bounding_box.size();
     Point2f object_center = Point2f(bounding_box.x + original_targ_sz.width / 2,
@@ -151,7 +155,7 @@ Mat DSST::get_scale_features(
     img_patch.convertTo(img_patch, CV_32FC3);
     resize(img_patch, img_patch, Size(scale_model_sz.width, scale_model_sz.height),0,0,INTER_LINEAR);
     std::vector<Mat> hog;
-    hog = get_features_hog(img_patch, 4);
+    hog = get_features_hog(img_patch, 4, use_float_precision);
     result = Mat(Size((int)scale_factors.size(), hog[0].cols * hog[0].rows * (int)hog.size()), CV_32F);
     col_len = hog[0].cols * hog[0].rows;
     for (int i = 0; i < static_cast<int>(hog.size()); ++i) {
@@ -161,7 +165,8 @@ Mat DSST::get_scale_features(
     }
 
     ParallelGetScaleFeatures parallelGetScaleFeatures(img, pos, base_target_sz,
-            current_scale, scale_factors, scale_window, scale_model_sz, col_len, result);
+            current_scale, scale_factors, scale_window, scale_model_sz, col_len, result,
+            use_float_precision);
     parallel_for_(Range(1, static_cast<int>(scale_factors.size())), parallelGetScaleFeatures);
     return result;
 }
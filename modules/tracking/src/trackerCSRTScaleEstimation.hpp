@@ -10,9 +10,10 @@ namespace cv
 
 class DSST {
 public:
-    DSST() {};
+    DSST() : use_float_precision(false) {};
     DSST(const Mat &image, Rect2f bounding_box, Size2f template_size, int numberOfScales,
-            float scaleStep, float maxModelArea, float sigmaFactor, float scaleLearnRate);
+            float scaleStep, float maxModelArea, float sigmaFactor, float scaleLearnRate,
+            bool useFloatPrecision = false);
     ~DSST();
     void update(const Mat &image, const Point2f objectCenter);
     float getScale(const Mat &image, const Point2f objecCenter);
@@ -36,6 +37,7 @@ private:
     float max_model_area;
     float sigma_factor;
     float learn_rate;
+    bool use_float_precision;
 
     Size original_targ_sz;
 };
@@ -106,28 +106,41 @@ void Histogram::extractBackGroundHistogram(
         p_bins[i] *= sum;
 }
 
-cv::Mat Histogram::backProject(std::vector<cv::Mat> & imgChannels)
+template<typename T>
+static void backProjectHistogram(const std::vector<cv::Mat> & imgChannels, const std::vector<int> & dimIdCoef,
+        const std::vector<double> & bins, int numBinsPerDim, cv::Mat & backProject)
 {
-    //just for code clarity
-    cv::Mat & img = imgChannels[0];
-
-    cv::Mat backProject(img.rows, img.cols, CV_64FC1);
-    double rangePerBinInverse = static_cast<double>(m_numBinsPerDim)/256.0;  // 1 / (imgRange/numBinsPerDim)
+    CV_Assert(backProject.depth() == DataType<T>::depth);
+    const int numDim = static_cast<int>(dimIdCoef.size());
+    double rangePerBinInverse = static_cast<double>(numBinsPerDim)/256.0;  // 1 / (imgRange/numBinsPerDim)
 
-    for (int y = 0; y < img.rows; ++y){
-        double * backProjectPtr = backProject.ptr<double>(y);
-        std::vector<const uchar *> dataPtr(m_numDim);
-        for (int dim = 0; dim < m_numDim; ++dim)
+    std::vector<const uchar *> dataPtr(numDim);
+    for (int y = 0; y < backProject.rows; ++y){
+        for (int dim = 0; dim < numDim; ++dim)
             dataPtr[dim] = imgChannels[dim].ptr<uchar>(y);
+        T * backProjectPtr = backProject.ptr<T>(y);
 
-        for (int x = 0; x < img.cols; ++x){
+        for (int x = 0; x < backProject.cols; ++x){
             int id = 0;
-            for (int dim = 0; dim < m_numDim; ++dim){
-                id += p_dimIdCoef[dim]*cvFloor(rangePerBinInverse*dataPtr[dim][x]);
+            for (int dim = 0; dim < numDim; ++dim){
+                id += dimIdCoef[dim]*cvFloor(rangePerBinInverse*dataPtr[dim][x]);
             }
-            backProjectPtr[x] = p_bins[id];
+            backProjectPtr[x] = static_cast<T>(bins[id]);
         }
     }
+}
+
+cv::Mat Histogram::backProject(std::vector<cv::Mat> & imgChannels, int depth)
+{
+    //just for code clarity
+    cv::Mat & img = imgChannels[0];
+
+    CV_Assert(depth == CV_64F || depth == CV_32F);
+    cv::Mat backProject(img.rows, img.cols, CV_MAKETYPE(depth, 1));
+    if (depth == CV_64F)
+        backProjectHistogram<double>(imgChannels, p_dimIdCoef, p_bins, m_numBinsPerDim, backProject);
+    else
+        backProjectHistogram<float>(imgChannels, p_dimIdCoef, p_bins, m_numBinsPerDim, backProject);
     return backProject;
 }
 
@@ -203,8 +216,10 @@ std::pair<cv::Mat, cv::Mat> Segment::computePosteriors(
         cv::resize(bgPrior(roiRect_inner), bgPriorScaled, newSize);
 
     //backproject pixels likelihood
-    cv::Mat foregroundLikelihood = hist_target.backProject(imgChannelsROI_inner).mul(fgPriorScaled);
-    cv::Mat backgroundLikelihood = hist_background.backProject(imgChannelsROI_inner).mul(bgPriorScaled);
+    cv::Mat foregroundLikelihood =
+        hist_target.backProject(imgChannelsROI_inner, fgPriorScaled.depth()).mul(fgPriorScaled);
+    cv::Mat backgroundLikelihood =
+        hist_background.backProject(imgChannelsROI_inner, bgPriorScaled.depth()).mul(bgPriorScaled);
 
     double p_b = std::sqrt((std::pow(outer_x2-outer_x1, 2) + std::pow(outer_y2-outer_y1, 2)) /
             (std::pow(x2-x1, 2) + std::pow(y2-y1, 2))) ;
@@ -272,8 +287,10 @@ std::pair<cv::Mat, cv::Mat> Segment::computePosteriors2(
         cv::resize(bgPrior(roiRect_inner), bgPriorScaled, newSize);
 
     //backproject pixels likelihood
-    cv::Mat foregroundLikelihood = hist_target.backProject(imgChannelsROI_inner).mul(fgPriorScaled);
-    cv::Mat backgroundLikelihood = hist_background.backProject(imgChannelsROI_inner).mul(bgPriorScaled);
+    cv::Mat foregroundLikelihood =
+        hist_target.backProject(imgChannelsROI_inner, fgPriorScaled.depth()).mul(fgPriorScaled);
+    cv::Mat backgroundLikelihood =
+        hist_background.backProject(imgChannelsROI_inner, bgPriorScaled.depth()).mul(bgPriorScaled);
 
     //convert likelihoods to posterior prob. (Bayes rule)
     cv::Mat prob_o(newSize, foregroundLikelihood.type());
@@ -331,8 +348,10 @@ std::pair<cv::Mat, cv::Mat> Segment::computePosteriors2(std::vector<cv::Mat> &im
         cv::resize(bgPrior(roiRect_inner), bgPriorScaled, newSize);
 
     //backproject pixels likelihood
-    cv::Mat foregroundLikelihood = hist_target.backProject(imgChannelsROI_inner).mul(fgPriorScaled);
-    cv::Mat backgroundLikelihood = hist_background.backProject(imgChannelsROI_inner).mul(bgPriorScaled);
+    cv::Mat foregroundLikelihood =
+        hist_target.backProject(imgChannelsROI_inner, fgPriorScaled.depth()).mul(fgPriorScaled);
+    cv::Mat backgroundLikelihood =
+        hist_background.backProject(imgChannelsROI_inner, bgPriorScaled.depth()).mul(bgPriorScaled);
 
     //prior for posterior, relative to the number of pixels in bg and fg
     double p_b = 5./3.;
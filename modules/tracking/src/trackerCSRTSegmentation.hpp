@@ -20,7 +20,7 @@ public:
     void extractBackGroundHistogram(std::vector<cv::Mat> & imgChannels,
             int x1, int y1, int x2, int y2, int outer_x1, int outer_y1,
             int outer_x2, int outer_y2);
-    cv::Mat backProject(std::vector<cv::Mat> & imgChannels);
+    cv::Mat backProject(std::vector<cv::Mat> & imgChannels, int depth = CV_64F);
     std::vector<double> getHistogramVector();
     void setHistogramVector(double *vector);
 
@@ -5,6 +5,7 @@
 #include "precomp.hpp"
 
 #include "trackerCSRTUtils.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 namespace cv {
 
@@ -264,21 +265,244 @@ Mat get_chebyshev_win(Size sz, float attenuation)
     return cheb_rows * cheb_cols;
 }
 
+// unit vectors to compute gradient orientation
+static const double hogUU[9] = {1.000, 0.9397, 0.7660, 0.5000, 0.1736, -0.1736, -0.5000, -0.7660, -0.9397};
+static const double hogVV[9] = {0.000, 0.3420, 0.6428, 0.8660, 0.9848,  0.9848,  0.8660,  0.6428,  0.3420};
+
+// gradient magnitude and orientation (one of 18) of the interleaved BGR pixels [start, end) of a
+// row, taken from the color channel with the strongest gradient
+template<typename T>
+static void computeHOGGradientRow(const T* above, const T* row, const T* below, int start, int end,
+                                  T* magnitude, int* orientation)
+{
+    const int numOrient = 18;
+    for (int x = start; x < end; x++)
+    {
+        // OpenCV uses an interleaved format: BGR-BGR-BGR
+        const int s = 3*x;
+
+        // blue image channel
+        T dyb = below[s] - above[s];
+        T dxb = row[s+3] - row[s-3];
+        T vb = dxb*dxb + dyb*dyb;
+
+        // green image channel
+        T dyg = below[s+1] - above[s+1];
+        T dxg = row[s+4] - row[s-2];
+        T vg = dxg*dxg + dyg*dyg;
+
+        // red image channel
+        T dy = below[s+2] - above[s+2];
+        T dx = row[s+5] - row[s-1];
+        T v = dx*dx + dy*dy;
+
+        // pick the channel with the strongest gradient
+        if (vg > v) { v = vg; dx = dxg; dy = dyg; }
+        if (vb > v) { v = vb; dx = dxb; dy = dyb; }
+
+        // snap to one of the 18 orientations
+        T best_dot = 0;
+        int best_o = 0;
+        for (int o = 0; o < numOrient/2; o++)
+        {
+            T dot = (T)hogUU[o]*dx + (T)hogVV[o]*dy;
+            if (dot > best_dot)
+            {
+                best_dot = dot;
+                best_o = o;
+            }
+            else if (-dot > best_dot)
+            {
+                best_dot = -dot;
+                best_o = o + numOrient/2;
+            }
+        }
+
+        magnitude[x] = std::sqrt(v);
+        orientation[x] = best_o;
+    }
+}
+
+// vectorized computeHOGGradientRow, returns the first pixel left for the scalar loop
+static int computeHOGGradientRowFast(const double*, const double*, const double*, int start, int,
+                                     double*, int*)
+{
+    return start;
+}
+
+static int computeHOGGradientRowFast(const float* above, const float* row, const float* below,
+                                     int start, int end, float* magnitude, int* orientation)
+{
+    int x = start;
+#if CV_SIMD
+    const int numLanes = v_float32::nlanes;
+    const v_float32 zero = vx_setzero_f32();
+    for (; x + numLanes <= end; x += numLanes)
+    {
+        v_float32 lb, lg, lr, rb, rg, rr, ab, ag, ar, bb, bg, br;
+        v_load_deinterleave(row + 3*(x-1), lb, lg, lr);
+        v_load_deinterleave(row + 3*(x+1), rb, rg, rr);
+        v_load_deinterleave(above + 3*x, ab, ag, ar);
+        v_load_deinterleave(below + 3*x, bb, bg, br);
+
+        v_float32 dxb = rb - lb, dyb = bb - ab;
+        v_float32 vb = dxb*dxb + dyb*dyb;
+        v_float32 dxg = rg - lg, dyg = bg - ag;
+        v_float32 vg = dxg*dxg + dyg*dyg;
+        v_float32 dx = rr - lr, dy = br - ar;
+        v_float32 v = dx*dx + dy*dy;
+
+        // pick the channel with the strongest gradient
+        v_float32 mask = vg > v;
+        v = v_select(mask, vg, v);
+        dx = v_select(mask, dxg, dx);
+        dy = v_select(mask, dyg, dy);
+        mask = vb > v;
+        v = v_select(mask, vb, v);
+        dx = v_select(mask, dxb, dx);
+        dy = v_select(mask, dyb, dy);
+
+        // snap to one of the 18 orientations, the negated dot can only win where the dot didn't
+        v_float32 best_dot = zero, best_o = zero;
+        for (int o = 0; o < 9; o++)
+        {
+            v_float32 dot = vx_setall_f32((float)hogUU[o])*dx + vx_setall_f32((float)hogVV[o])*dy;
+            mask = dot > best_dot;
+            best_dot = v_select(mask, dot, best_dot);
+            best_o = v_select(mask, vx_setall_f32((float)o), best_o);
+            dot = zero - dot;
+            mask = dot > best_dot;
+            best_dot = v_select(mask, dot, best_dot);
+            best_o = v_select(mask, vx_setall_f32((float)(o + 9)), best_o);
+        }
+
+        v_store(magnitude + x, v_sqrt(v));
+        v_store(orientation + x, v_round(best_o));
+    }
+#else
+    CV_UNUSED(above); CV_UNUSED(row); CV_UNUSED(below); CV_UNUSED(end);
+    CV_UNUSED(magnitude); CV_UNUSED(orientation);
+#endif
+    return x;
+}
+
+// 32 features of a cell from its 18 orientation histogram bins and the 4 normalization factors
+// of the blocks around it
+template<typename T>
+static void computeHOGCellFeatures(const T* src, T n1, T n2, T n3, T n4, T* dst)
+{
+    const int numOrient = 18;
+    const T clip = (T)0.2;
+    T t1 = 0, t2 = 0, t3 = 0, t4 = 0;
+
+    // contrast-sesitive features
+    for (int o = 0; o < numOrient; o++)
+    {
+        T val = src[o];
+        T h1 = min(val*n1, clip);
+        T h2 = min(val*n2, clip);
+        T h3 = min(val*n3, clip);
+        T h4 = min(val*n4, clip);
+        *(dst++) = (T)0.5 * (h1 + h2 + h3 + h4);
+        t1 += h1;
+        t2 += h2;
+        t3 += h3;
+        t4 += h4;
+    }
+
+    // contrast-insensitive features
+    for (int o = 0; o < numOrient/2; o++)
+    {
+        T sum = src[o] + src[o + numOrient/2];
+        T h1 = min(sum * n1, clip);
+        T h2 = min(sum * n2, clip);
+        T h3 = min(sum * n3, clip);
+        T h4 = min(sum * n4, clip);
+        *(dst++) = (T)0.5 * (h1 + h2 + h3 + h4);
+    }
+
+    // texture features
+    *(dst++) = (T)0.2357 * t1;
+    *(dst++) = (T)0.2357 * t2;
+    *(dst++) = (T)0.2357 * t3;
+    *(dst++) = (T)0.2357 * t4;
+    // truncation feature
+    *dst = 0;
+}
+
+#if CV_SIMD128
+static void computeHOGCellFeatures(const float* src, float n1, float n2, float n3, float n4, float* dst)
+{
+    const v_float32x4 vn1 = v_setall_f32(n1), vn2 = v_setall_f32(n2);
+    const v_float32x4 vn3 = v_setall_f32(n3), vn4 = v_setall_f32(n4);
+    const v_float32x4 clip = v_setall_f32(0.2f), half = v_setall_f32(0.5f);
+    v_float32x4 t1 = v_setzero_f32(), t2 = v_setzero_f32(), t3 = v_setzero_f32(), t4 = v_setzero_f32();
+
+    // contrast-sesitive features, the first 16 of the 18 orientations 4 at a time
+    for (int o = 0; o < 16; o += 4)
+    {
+        v_float32x4 val = v_load(src + o);
+        v_float32x4 h1 = v_min(val*vn1, clip);
+        v_float32x4 h2 = v_min(val*vn2, clip);
+        v_float32x4 h3 = v_min(val*vn3, clip);
+        v_float32x4 h4 = v_min(val*vn4, clip);
+        v_store(dst + o, (h1 + h2 + h3 + h4)*half);
+        t1 += h1;
+        t2 += h2;
+        t3 += h3;
+        t4 += h4;
+    }
+    float s1 = v_reduce_sum(t1), s2 = v_reduce_sum(t2), s3 = v_reduce_sum(t3), s4 = v_reduce_sum(t4);
+    for (int o = 16; o < 18; o++)
+    {
+        float h1 = min(src[o]*n1, 0.2f);
+        float h2 = min(src[o]*n2, 0.2f);
+        float h3 = min(src[o]*n3, 0.2f);
+        float h4 = min(src[o]*n4, 0.2f);
+        dst[o] = 0.5f * (h1 + h2 + h3 + h4);
+        s1 += h1;
+        s2 += h2;
+        s3 += h3;
+        s4 += h4;
+    }
+
+    // contrast-insensitive features, the first 8 of the 9 orientations 4 at a time
+    for (int o = 0; o < 8; o += 4)
+    {
+        v_float32x4 sum = v_load(src + o) + v_load(src + o + 9);
+        v_float32x4 h1 = v_min(sum*vn1, clip);
+        v_float32x4 h2 = v_min(sum*vn2, clip);
+        v_float32x4 h3 = v_min(sum*vn3, clip);
+        v_float32x4 h4 = v_min(sum*vn4, clip);
+        v_store(dst + 18 + o, (h1 + h2 + h3 + h4)*half);
+    }
+    float sum = src[8] + src[17];
+    dst[26] = 0.5f * (min(sum*n1, 0.2f) + min(sum*n2, 0.2f) + min(sum*n3, 0.2f) + min(sum*n4, 0.2f));
+
+    // texture features
+    dst[27] = 0.2357f * s1;
+    dst[28] = 0.2357f * s2;
+    dst[29] = 0.2357f * s3;
+    dst[30] = 0.2357f * s4;
+    // truncation feature
+    dst[31] = 0;
+}
+#endif
+
+template<typename T>
 static void computeHOG32D(const Mat &imageM, Mat &featM, const int sbin, const int pad_x, const int pad_y)
 {
     const int dimHOG = 32;
+    const int type = DataType<T>::depth;
     CV_Assert(pad_x >= 0);
     CV_Assert(pad_y >= 0);
     CV_Assert(imageM.channels() == 3);
-    CV_Assert(imageM.depth() == CV_64F);
+    CV_Assert(imageM.depth() == type);
 
     // epsilon to avoid division by zero
-    const double eps = 0.0001;
+    const T eps = (T)0.0001;
     // number of orientations
     const int numOrient = 18;
-    // unit vectors to compute gradient orientation
-    const double uu[9] = {1.000, 0.9397, 0.7660, 0.5000, 0.1736, -0.1736, -0.5000, -0.7660, -0.9397};
-    const double vv[9] = {0.000, 0.3420, 0.6428, 0.8660, 0.9848,  0.9848,  0.8660,  0.6428,  0.3420};
 
     // image size
     const Size imageSize = imageM.size();
@@ -296,78 +520,59 @@ static void computeHOG32D(const Mat &imageM, Mat &featM, const int sbin, const i
     const Size visible = blockSize*sbin;
 
     // initialize historgram, norm, output feature matrices
-    Mat histM = Mat::zeros(Size(blockSize.width*numOrient, blockSize.height), CV_64F);
-    Mat normM = Mat::zeros(Size(blockSize.width, blockSize.height), CV_64F);
-    featM = Mat::zeros(Size(outSize.width*dimHOG, outSize.height), CV_64F);
+    Mat histM = Mat::zeros(Size(blockSize.width*numOrient, blockSize.height), type);
+    Mat normM = Mat::zeros(Size(blockSize.width, blockSize.height), type);
+    featM = Mat::zeros(Size(outSize.width*dimHOG, outSize.height), type);
 
     // get the stride of each matrix
-    const size_t imStride = imageM.step1();
     const size_t histStride = histM.step1();
     const size_t normStride = normM.step1();
     const size_t featStride = featM.step1();
 
     // calculate the zero offset
-    const double* im = imageM.ptr<double>(0);
-    double* const hist = histM.ptr<double>(0);
-    double* const norm = normM.ptr<double>(0);
-    double* const feat = featM.ptr<double>(0);
+    T* const hist = histM.ptr<T>(0);
+    T* const norm = normM.ptr<T>(0);
+    T* const feat = featM.ptr<T>(0);
+
+    // the horizontal bilinear weights are the same for every row
+    std::vector<int> ixps(max(visible.width, 0));
+    std::vector<T> vx0s(ixps.size());
+    for (int x = 1; x < visible.width - 1; x++)
+    {
+        T xp = ((T)x+(T)0.5)/(T)sbin - (T)0.5;
+        ixps[x] = (int)cvFloor(xp);
+        vx0s[x] = xp - (T)ixps[x];
+    }
+
+    // gradient magnitudes and orientations of the current row
+    std::vector<T> magnitudes(ixps.size());
+    std::vector<int> orientations(ixps.size());
 
     for (int y = 1; y < visible.height - 1; y++)
     {
-        for (int x = 1; x < visible.width - 1; x++)
+        // the visible area keeps one pixel away from the image border
+        const T* row = imageM.ptr<T>(y);
+        const T* above = imageM.ptr<T>(y-1);
+        const T* below = imageM.ptr<T>(y+1);
+
+        int x = computeHOGGradientRowFast(above, row, below, 1, visible.width - 1,
+                                          magnitudes.data(), orientations.data());
+        computeHOGGradientRow(above, row, below, x, visible.width - 1,
+                              magnitudes.data(), orientations.data());
+
+        // add to 4 historgrams around pixel using bilinear interpolation
+        T yp =  ((T)y+(T)0.5)/(T)sbin - (T)0.5;
+        int iyp = (int)cvFloor(yp);
+        T vy0 = yp - iyp;
+        T vy1 = (T)1 - vy0;
+
+        for (x = 1; x < visible.width - 1; x++)
         {
-            // OpenCV uses an interleaved format: BGR-BGR-BGR
-            const double* s = im + 3*min(x, imageM.cols-2) + min(y, imageM.rows-2)*imStride;
-
-            // blue image channel
-            double dyb = *(s+imStride) - *(s-imStride);
-            double dxb = *(s+3) - *(s-3);
-            double vb = dxb*dxb + dyb*dyb;
-
-            // green image channel
-            s += 1;
-            double dyg = *(s+imStride) - *(s-imStride);
-            double dxg = *(s+3) - *(s-3);
-            double vg = dxg*dxg + dyg*dyg;
-
-            // red image channel
-            s += 1;
-            double dy = *(s+imStride) - *(s-imStride);
-            double dx = *(s+3) - *(s-3);
-            double v = dx*dx + dy*dy;
-
-            // pick the channel with the strongest gradient
-            if (vg > v) { v = vg; dx = dxg; dy = dyg; }
-            if (vb > v) { v = vb; dx = dxb; dy = dyb; }
-
-            // snap to one of the 18 orientations
-            double best_dot = 0;
-            int best_o = 0;
-            for (int o = 0; o < (int)numOrient/2; o++)
-            {
-                double dot =  uu[o]*dx + vv[o]*dy;
-                if (dot > best_dot)
-                {
-                    best_dot = dot;
-                    best_o = o;
-                }
-                else if (-dot > best_dot)
-                {
-                    best_dot = -dot;
-                    best_o = o + (int)(numOrient/2);
-                }
-            }
-
-            // add to 4 historgrams around pixel using bilinear interpolation
-            double yp =  ((double)y+0.5)/(double)sbin - 0.5;
-            double xp =  ((double)x+0.5)/(double)sbin - 0.5;
-            int iyp = (int)cvFloor(yp);
-            int ixp = (int)cvFloor(xp);
-            double vy0 = yp - iyp;
-            double vx0 = xp - ixp;
-            double vy1 = 1.0 - vy0;
-            double vx1 = 1.0 - vx0;
-            v = sqrt(v);
+            const int ixp = ixps[x];
+            const T vx0 = vx0s[x];
+            const T vx1 = (T)1 - vx0;
+            const T v = magnitudes[x];
+            const int best_o = orientations[x];
 
             // fill the value into the 4 neighborhood cells
             if (iyp >= 0 && ixp >= 0)
@@ -381,16 +586,15 @@ static void computeHOG32D(const Mat &imageM, Mat &featM, const int sbin, const i
 
             if (iyp+1 < blockSize.height && ixp+1 < blockSize.width)
                 *(hist + (iyp+1)*histStride + (ixp+1)*numOrient + best_o) += vy0*vx0*v;
-
-        } // for y
-    } // for x
+        } // for x
+    } // for y
 
     // compute the energy in each block by summing over orientation
     for (int y = 0; y < blockSize.height; y++)
     {
-        const double* src = hist + y*histStride;
-        double* dst = norm + y*normStride;
-        double const* const dst_end = dst + blockSize.width;
+        const T* src = hist + y*histStride;
+        T* dst = norm + y*normStride;
+        T const* const dst_end = dst + blockSize.width;
         // for each cell
         while (dst < dst_end)
         {
@@ -411,59 +615,20 @@ static void computeHOG32D(const Mat &imageM, Mat &featM, const int sbin, const i
     {
         for (int x = pad_x; x < outSize.width - pad_x; x++)
         {
-            double* dst = feat + y*featStride + x*dimHOG;
-            double* p, n1, n2, n3, n4;
-            const double* src;
+            T* dst = feat + y*featStride + x*dimHOG;
+            T* p, n1, n2, n3, n4;
 
             p = norm + (y - pad_y + 1)*normStride + (x - pad_x + 1);
-            n1 = 1.0f / sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
+            n1 = (T)1 / std::sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
             p = norm + (y - pad_y)*normStride + (x - pad_x + 1);
-            n2 = 1.0f / sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
+            n2 = (T)1 / std::sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
             p = norm + (y- pad_y + 1)*normStride + x - pad_x;
-            n3 = 1.0f / sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
+            n3 = (T)1 / std::sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
             p = norm + (y - pad_y)*normStride + x - pad_x;
-            n4 = 1.0f / sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
-
-            double t1 = 0.0, t2 = 0.0, t3 = 0.0, t4 = 0.0;
+            n4 = (T)1 / std::sqrt(*p + *(p + 1) + *(p + normStride) + *(p + normStride + 1) + eps);
 
-            // contrast-sesitive features
-            src = hist + (y - pad_y + 1)*histStride + (x - pad_x + 1)*numOrient;
-            for (int o = 0; o < numOrient; o++)
-            {
-                double val = *src;
-                double h1 = min(val*n1, 0.2);
-                double h2 = min(val*n2, 0.2);
-                double h3 = min(val*n3, 0.2);
-                double h4 = min(val*n4, 0.2);
-                *(dst++) = 0.5 * (h1 + h2 + h3 + h4);
-
-                src++;
-                t1 += h1;
-                t2 += h2;
-                t3 += h3;
-                t4 += h4;
-            }
-
-            // contrast-insensitive features
-            src =  hist + (y - pad_y + 1)*histStride + (x - pad_x + 1)*numOrient;
-            for (int o = 0; o < numOrient/2; o++)
-            {
-                double sum = *src + *(src + numOrient/2);
-                double h1 = min(sum * n1, 0.2);
-                double h2 = min(sum * n2, 0.2);
-                double h3 = min(sum * n3, 0.2);
-                double h4 = min(sum * n4, 0.2);
-                *(dst++) = 0.5 * (h1 + h2 + h3 + h4);
-                src++;
-            }
-
-            // texture features
-            *(dst++) = 0.2357 * t1;
-            *(dst++) = 0.2357 * t2;
-            *(dst++) = 0.2357 * t3;
-            *(dst++) = 0.2357 * t4;
-            // truncation feature
-            *dst = 0;
+            computeHOGCellFeatures(hist + (y - pad_y + 1)*histStride + (x - pad_x + 1)*numOrient,
+                                   n1, n2, n3, n4, dst);
         }// for x
     }// for y
     // Truncation features
@@ -474,18 +639,23 @@ static void computeHOG32D(const Mat &imageM, Mat &featM, const int sbin, const i
             if (m > pad_y - 1 && m < featM.rows - pad_y && n > pad_x*dimHOG - 1 && n < featM.cols - pad_x*dimHOG)
                 continue;
 
-            featM.at<double>(m, n + dimHOG - 1) = 1;
+            featM.at<T>(m, n + dimHOG - 1) = 1;
         } // for x
     }// for y
 }
 
-std::vector<Mat> get_features_hog(const Mat &im, const int bin_size)
+std::vector<Mat> get_features_hog(const Mat &im, const int bin_size, bool use_float_precision)
 {
     Mat hogmatrix;
     Mat im_;
-    im.convertTo(im_, CV_64FC3, 1.0/255.0);
-    computeHOG32D(im_,hogmatrix,bin_size,1,1);
-    hogmatrix.convertTo(hogmatrix, CV_32F);
+    if (use_float_precision) {
+        im.convertTo(im_, CV_32FC3, 1.0/255.0);
+        computeHOG32D<float>(im_,hogmatrix,bin_size,1,1);
+    } else {
+        im.convertTo(im_, CV_64FC3, 1.0/255.0);
+        computeHOG32D<double>(im_,hogmatrix,bin_size,1,1);
+        hogmatrix.convertTo(hogmatrix, CV_32F);
+    }
     Size hog_size = im.size();
     hog_size.width /= bin_size;
     hog_size.height /= bin_size;
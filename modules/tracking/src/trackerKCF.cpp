@@ -40,6 +40,8 @@
  //M*/
 
 #include "precomp.hpp"
+#include "tracking_utils.hpp"
+#include "trackerBatch.hpp"
 #include "opencl_kernels_tracking.hpp"
 #include <complex>
 #include <cmath>
@@ -83,6 +85,9 @@ namespace cv{
     */
     bool initImpl( const Mat& /*image*/, const Rect2d& boundingBox ) CV_OVERRIDE;
     bool updateImpl( const Mat& image, Rect2d& boundingBox ) CV_OVERRIDE;
+    bool trackFrame( const Mat& img, Rect2d& boundingBox ); // update on a frame already at the tracking resolution
+    bool updateOnFrame( const Mat& img, Rect2d& boundingBox ); // trackFrame() with the checks and timing of update()
+    bool isHalfResolution() const { return resizeImage; }
 
     TrackerKCF::Params params;
 
@@ -98,9 +103,8 @@ namespace cv{
     void inline updateProjectionMatrix(const Mat src, Mat & old_cov,Mat &  proj_matrix,float pca_rate, int compressed_sz,
                                        std::vector<Mat> & layers_pca,std::vector<Scalar> & average, Mat pca_data, Mat new_cov, Mat w, Mat u, Mat v);
     void inline compress(const Mat proj_matrix, const Mat src, Mat & dest, Mat & data, Mat & compressed) const;
-    bool getSubWindow(const Mat img, const Rect roi, Mat& feat, Mat& patch, TrackerKCF::MODE desc = GRAY) const;
-    bool getSubWindow(const Mat img, const Rect roi, Mat& feat, void (*f)(const Mat, const Rect, Mat& )) const;
-    void extractCN(Mat patch_data, Mat & cnFeatures) const;
+    bool getSubWindow(const Mat img, const Rect roi, Mat& feat, Mat& patch, TrackerKCF::MODE desc = GRAY);
+    bool getSubWindow(const Mat img, const Rect roi, Mat& feat, void (*f)(const Mat, const Rect, Mat& ));
     void denseGaussKernel(const float sigma, const Mat , const Mat y_data, Mat & k_data,
                           std::vector<Mat> & layers_data,std::vector<Mat> & xf_data,std::vector<Mat> & yf_data, std::vector<Mat> xyf_v, Mat xy, Mat xyf ) const;
     void calcResponse(const Mat alphaf_data, const Mat kf_data, Mat & response_data, Mat & spec_data) const;
@@ -116,9 +120,11 @@ namespace cv{
   private:
     float output_sigma;
     Rect2d roi;
+    Size2d target_size; // bounding box size in roi coordinates, roi is padded around it
     Mat hann; 	//hann window filter
-    Mat hann_cn; //10 dimensional hann-window filter for CN features,
+    Mat hann_custom; //hann window filter with one channel per custom feature channel
 
+    // all spectrums are single channel in the packed CCS format of dft() on real input
     Mat y,yf; 	// training response and its FFT
     Mat x; 	// observation and its FFT
     Mat k,kf;	// dense gaussian kernel and its FFT
@@ -138,6 +144,9 @@ namespace cv{
     std::vector<Mat> layers_pca_data;
     std::vector<Scalar> average_data;
     Mat img_Patch;
+    Mat gray_Patch; // grayscale patch of a color image
+    Mat cn_index; // ColorNames table row of every pixel in a patch row (CV_16U)
+    Mat resized_img; // the frame at half resolution when resizeImage is set
 
     // storage for the extracted features, KRLS model, KRLS compressed model
     Mat X[2],Z[2],Zc[2];
@@ -231,17 +240,22 @@ namespace cv{
     }
 
     // add padding to the roi
+    target_size = roi.size();
     roi.x-=roi.width/2;
     roi.y-=roi.height/2;
     roi.width*=2;
     roi.height*=2;
 
-    // initialize the hann window filter
-    createHanningWindow(hann, roi.size(), CV_32F);
+    // grow the padded roi around its center to the nearest size the DFT handles fastest
+    int dft_width = getOptimalDFTSize(cvCeil(roi.width));
+    int dft_height = getOptimalDFTSize(cvCeil(roi.height));
+    roi.x-=(dft_width-roi.width)/2;
+    roi.y-=(dft_height-roi.height)/2;
+    roi.width=dft_width;
+    roi.height=dft_height;
 
-    // hann window filter for CN feature
-    Mat _layer[] = {hann, hann, hann, hann, hann, hann, hann, hann, hann, hann};
-    merge(_layer, 10, hann_cn);
+    // initialize the hann window filter, the CN features apply it while they are extracted
+    createHanningWindow(hann, roi.size(), CV_32F);
 
     // create gaussian response
     y=Mat::zeros((int)roi.height,(int)roi.width,CV_32F);
@@ -298,16 +312,38 @@ namespace cv{
    * Main part of the KCF algorithm
    */
   bool TrackerKCFImpl::updateImpl( const Mat& image, Rect2d& boundingBox ){
+    // the frame is only read, so it is used as is unless it has to be resized
+    // resize the image whenever needed, into a buffer reused by every frame
+    if(resizeImage){
+      int64 stageStart = getTickCount();
+      resize(image,resized_img,Size(image.cols/2,image.rows/2),0,0,INTER_LINEAR_EXACT);
+      addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+      return trackFrame(resized_img, boundingBox);
+    }
+    return trackFrame(image, boundingBox);
+  }
+
+  /*
+   * Update on a frame shared by the batch tracker, with the same checks and timing as Tracker::update()
+   */
+  bool TrackerKCFImpl::updateOnFrame( const Mat& img, Rect2d& boundingBox ){
+    if(!isInit || img.empty())
+      return false;
+
+    int64 startTicks = startUpdate();
+    bool found = trackFrame(img, boundingBox);
+    finishUpdate(startTicks);
+    return found;
+  }
+
+  bool TrackerKCFImpl::trackFrame( const Mat& img, Rect2d& boundingBox ){
     double minVal, maxVal;	// min-max response
     Point minLoc,maxLoc;	// min-max location
+    int64 stageStart = getTickCount();
 
-    Mat img=image.clone();
     // check the channels of the input image, grayscale is preferred
     CV_Assert(img.channels() == 1 || img.channels() == 3);
 
-    // resize the image whenever needed
-    if(resizeImage)resize(img,img,Size(img.cols/2,img.rows/2),0,0,INTER_LINEAR_EXACT);
-
     // detection part
     if(frame>0){
 
@@ -352,13 +388,14 @@ namespace cv{
         merge(X,2,x);
         merge(Zc,2,z);
       }
+      addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+      stageStart = getTickCount();
 
       //compute the gaussian kernel
       denseGaussKernel(params.sigma,x,z,k,layers,vxf,vyf,vxyf,xy_data,xyf_data);
 
       // compute the fourier transform of the kernel
       fft2(k,kf);
-      if(frame==1)spec2=Mat_<Vec2f >(kf.rows, kf.cols);
 
       // calculate filter response
       if(params.split_coeff)
@@ -368,19 +405,22 @@ namespace cv{
 
       // extract the maximum response
       minMaxLoc( response, &minVal, &maxVal, &minLoc, &maxLoc );
+      addStageTime(STAGE_DETECTION, stageStart);
       if (maxVal < params.detect_thresh)
       {
           return false;
       }
       roi.x+=(maxLoc.x-roi.width/2+1);
       roi.y+=(maxLoc.y-roi.height/2+1);
+      stageStart = getTickCount();
     }
 
     // update the bounding box
-    boundingBox.x=(resizeImage?roi.x*2:roi.x)+(resizeImage?roi.width*2:roi.width)/4;
-    boundingBox.y=(resizeImage?roi.y*2:roi.y)+(resizeImage?roi.height*2:roi.height)/4;
-    boundingBox.width = (resizeImage?roi.width*2:roi.width)/2;
-    boundingBox.height = (resizeImage?roi.height*2:roi.height)/2;
+    double scale = resizeImage ? 2.0 : 1.0;
+    boundingBox.x = (roi.x+(roi.width-target_size.width)/2)*scale;
+    boundingBox.y = (roi.y+(roi.height-target_size.height)/2)*scale;
+    boundingBox.width = target_size.width*scale;
+    boundingBox.height = target_size.height*scale;
 
     // extract the patch for learning purpose
     // get non compressed descriptors
@@ -402,6 +442,8 @@ namespace cv{
       if(!getSubWindow(img,roi, features_pca[j], extractor_pca[i]))return false;
     }
     if(features_pca.size()>0)merge(features_pca,X[0]);
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+    stageStart = getTickCount();
 
     //update the training data
     if(frame==0){
@@ -438,7 +480,6 @@ namespace cv{
       vxf.resize(x.channels());
       vyf.resize(x.channels());
       vxyf.resize(vyf.size());
-      new_alphaf=Mat_<Vec2f >(yf.rows, yf.cols);
     }
 
     // Kernel Regularized Least-Squares, calculate alphas
@@ -446,23 +487,13 @@ namespace cv{
 
     // compute the fourier transform of the kernel and add a small value
     fft2(k,kf);
-    kf_lambda=kf+params.lambda;
+    tracking_internal::addRealCCS(kf,(float)params.lambda,kf_lambda);
 
-    float den;
     if(params.split_coeff){
       mulSpectrums(yf,kf,new_alphaf,0);
       mulSpectrums(kf,kf_lambda,new_alphaf_den,0);
     }else{
-      for(int i=0;i<yf.rows;i++){
-        for(int j=0;j<yf.cols;j++){
-          den = 1.0f/(kf_lambda.at<Vec2f>(i,j)[0]*kf_lambda.at<Vec2f>(i,j)[0]+kf_lambda.at<Vec2f>(i,j)[1]*kf_lambda.at<Vec2f>(i,j)[1]);
-
-          new_alphaf.at<Vec2f>(i,j)[0]=
-          (yf.at<Vec2f>(i,j)[0]*kf_lambda.at<Vec2f>(i,j)[0]+yf.at<Vec2f>(i,j)[1]*kf_lambda.at<Vec2f>(i,j)[1])*den;
-          new_alphaf.at<Vec2f>(i,j)[1]=
-          (yf.at<Vec2f>(i,j)[1]*kf_lambda.at<Vec2f>(i,j)[0]-yf.at<Vec2f>(i,j)[0]*kf_lambda.at<Vec2f>(i,j)[1])*den;
-        }
-      }
+      tracking_internal::divSpectrumsCCS(yf,kf_lambda,new_alphaf);
     }
 
     // update the RLS model
@@ -474,6 +505,8 @@ namespace cv{
       if(params.split_coeff)alphaf_den=(1.0-params.interp_factor)*alphaf_den+params.interp_factor*new_alphaf_den;
     }
 
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
+
     frame++;
     return true;
   }
@@ -524,16 +557,18 @@ namespace cv{
 
   /*
    * simplification of fourier transform function in opencv
+   * the input is real, so the spectrum is kept in the packed CCS format (half the work and memory
+   * of a full complex output), which mulSpectrums and idft accept directly
    */
   void inline TrackerKCFImpl::fft2(const Mat src, Mat & dest) const {
-    dft(src,dest,DFT_COMPLEX_OUTPUT);
+    dft(src,dest);
   }
 
   void inline TrackerKCFImpl::fft2(const Mat src, std::vector<Mat> & dest, std::vector<Mat> & layers_data) const {
     split(src, layers_data);
 
     for(int i=0;i<src.channels();i++){
-      dft(layers_data[i],dest[i],DFT_COMPLEX_OUTPUT);
+      dft(layers_data[i],dest[i]);
     }
   }
 
@@ -659,7 +694,7 @@ namespace cv{
   /*
    * obtain the patch and apply hann window filter to it
    */
-  bool TrackerKCFImpl::getSubWindow(const Mat img, const Rect _roi, Mat& feat, Mat& patch, TrackerKCF::MODE desc) const {
+  bool TrackerKCFImpl::getSubWindow(const Mat img, const Rect _roi, Mat& feat, Mat& patch, TrackerKCF::MODE desc) {
 
     Rect region=_roi;
 
@@ -679,8 +714,6 @@ namespace cv{
     if (region.empty())
         return false;
 
-    patch=img(region).clone();
-
     // add some padding to compensate when the patch is outside image border
     int addTop,addBottom, addLeft, addRight;
     addTop=region.y-_roi.y;
@@ -688,25 +721,23 @@ namespace cv{
     addLeft=region.x-_roi.x;
     addRight=(_roi.width+_roi.x>img.cols?_roi.width+_roi.x-img.cols:0);
 
-    copyMakeBorder(patch,patch,addTop,addBottom,addLeft,addRight,BORDER_REPLICATE);
+    // copy the region and its padding straight into the patch buffer of the previous frame
+    copyMakeBorder(img(region),patch,addTop,addBottom,addLeft,addRight,BORDER_REPLICATE);
     if(patch.rows==0 || patch.cols==0)return false;
 
-    // extract the desired descriptors
+    // extract the desired descriptors, both apply the hann window filter while writing feat
     switch(desc){
       case CN:
         CV_Assert(img.channels() == 3);
-        extractCN(patch,feat);
-        feat=feat.mul(hann_cn); // hann window filter
+        tracking_internal::extractColorNames(patch,hann,feat,cn_index);
         break;
       default: // GRAY
-        if(img.channels()>1)
-          cvtColor(patch,feat, COLOR_BGR2GRAY);
-        else
-          feat=patch;
-        //feat.convertTo(feat,CV_32F);
-        feat.convertTo(feat,CV_32F, 1.0/255.0, -0.5);
-        //feat=feat/255.0-0.5; // normalize to range -0.5 .. 0.5
-        feat=feat.mul(hann); // hann window filter
+        if(img.channels()>1){
+          cvtColor(patch,gray_Patch, COLOR_BGR2GRAY);
+          tracking_internal::extractGrayFeatures(gray_Patch,hann,feat);
+        }else{
+          tracking_internal::extractGrayFeatures(patch,hann,feat);
+        }
         break;
     }
 
@@ -717,7 +748,7 @@ namespace cv{
   /*
    * get feature using external function
    */
-  bool TrackerKCFImpl::getSubWindow(const Mat img, const Rect _roi, Mat& feat, void (*f)(const Mat, const Rect, Mat& )) const{
+  bool TrackerKCFImpl::getSubWindow(const Mat img, const Rect _roi, Mat& feat, void (*f)(const Mat, const Rect, Mat& )){
 
     // return false if roi is outside the image
     if((_roi.x+_roi.width<0)
@@ -733,42 +764,17 @@ namespace cv{
       printf("Rules: roi.width==feat.cols && roi.height = feat.rows \n");
     }
 
-    Mat hann_win;
-    std::vector<Mat> _layers;
-
-    for(int i=0;i<feat.channels();i++)
-      _layers.push_back(hann);
-
-    merge(_layers, hann_win);
+    // the multi-channel hann window is only rebuilt when the number of channels changes
+    if(hann_custom.size() != hann.size() || hann_custom.channels() != feat.channels()){
+      std::vector<Mat> _layers(feat.channels(), hann);
+      merge(_layers, hann_custom);
+    }
 
-    feat=feat.mul(hann_win); // hann window filter
+    feat=feat.mul(hann_custom); // hann window filter
 
     return true;
   }
 
-  /* Convert BGR to ColorNames
-   */
-  void TrackerKCFImpl::extractCN(Mat patch_data, Mat & cnFeatures) const {
-    Vec3b & pixel = patch_data.at<Vec3b>(0,0);
-    unsigned index;
-
-    if(cnFeatures.type() != CV_32FC(10))
-      cnFeatures = Mat::zeros(patch_data.rows,patch_data.cols,CV_32FC(10));
-
-    for(int i=0;i<patch_data.rows;i++){
-      for(int j=0;j<patch_data.cols;j++){
-        pixel=patch_data.at<Vec3b>(i,j);
-        index=(unsigned)(floor((float)pixel[2]/8)+32*floor((float)pixel[1]/8)+32*32*floor((float)pixel[0]/8));
-
-        //copy the values
-        for(int _k=0;_k<10;_k++){
-          cnFeatures.at<Vec<float,10> >(i,j)[_k]=ColorNames[index][_k];
-        }
-      }
-    }
-
-  }
-
   /*
    *  dense gauss kernel function
    */
@@ -865,7 +871,6 @@ namespace cv{
    * calculate the detection response
    */
   void TrackerKCFImpl::calcResponse(const Mat alphaf_data, const Mat kf_data, Mat & response_data, Mat & spec_data) const {
-    //alpha f--> 2channels ; k --> 1 channel;
     mulSpectrums(alphaf_data,kf_data,spec_data,0,false);
     ifft2(spec_data,response_data);
   }
@@ -876,19 +881,7 @@ namespace cv{
   void TrackerKCFImpl::calcResponse(const Mat alphaf_data, const Mat _alphaf_den, const Mat kf_data, Mat & response_data, Mat & spec_data, Mat & spec2_data) const {
 
     mulSpectrums(alphaf_data,kf_data,spec_data,0,false);
-
-    //z=(a+bi)/(c+di)=[(ac+bd)+i(bc-ad)]/(c^2+d^2)
-    float den;
-    for(int i=0;i<kf_data.rows;i++){
-      for(int j=0;j<kf_data.cols;j++){
-        den=1.0f/(_alphaf_den.at<Vec2f>(i,j)[0]*_alphaf_den.at<Vec2f>(i,j)[0]+_alphaf_den.at<Vec2f>(i,j)[1]*_alphaf_den.at<Vec2f>(i,j)[1]);
-        spec2_data.at<Vec2f>(i,j)[0]=
-          (spec_data.at<Vec2f>(i,j)[0]*_alphaf_den.at<Vec2f>(i,j)[0]+spec_data.at<Vec2f>(i,j)[1]*_alphaf_den.at<Vec2f>(i,j)[1])*den;
-        spec2_data.at<Vec2f>(i,j)[1]=
-          (spec_data.at<Vec2f>(i,j)[1]*_alphaf_den.at<Vec2f>(i,j)[0]-spec_data.at<Vec2f>(i,j)[0]*_alphaf_den.at<Vec2f>(i,j)[1])*den;
-      }
-    }
-
+    tracking_internal::divSpectrumsCCS(spec_data,_alphaf_den,spec2_data);
     ifft2(spec2_data,response_data);
   }
 
@@ -988,4 +981,49 @@ namespace cv{
     fs << "compressed_size" << compressed_size;
     fs << "pca_learning_rate" << pca_learning_rate;
   }
+
+  /*
+   * Batch of KCF trackers sharing the half resolution frame
+   */
+  class TrackerBatchKCFImpl CV_FINAL : public TrackerBatchImpl {
+  public:
+    TrackerBatchKCFImpl( const TrackerKCF::Params &parameters = TrackerKCF::Params() ) : params( parameters ) {}
+
+  protected:
+    bool updateTarget( size_t idx ) CV_OVERRIDE {
+      Rect2d boundingBox;
+      if(!trackers[idx]->updateOnFrame(trackers[idx]->isHalfResolution() ? half_frame : frame, boundingBox))
+        return false;
+      objects[idx]=boundingBox;
+      return true;
+    }
+
+    void prepareFrame( const Mat& image ) CV_OVERRIDE {
+      frame=image;
+
+      // resize once for all the targets tracked at half resolution
+      bool need_half_frame=false;
+      for(size_t i=0;i<trackers.size();i++){
+        need_half_frame = need_half_frame || (initialized[i] && trackers[i]->isHalfResolution());
+      }
+      if(need_half_frame)
+        resize(frame,half_frame,Size(frame.cols/2,frame.rows/2),0,0,INTER_LINEAR_EXACT);
+    }
+
+    bool initTarget( size_t idx ) CV_OVERRIDE {
+      trackers.push_back(makePtr<TrackerKCFImpl>(params));
+      return trackers[idx]->init(frame, objects[idx]);
+    }
+
+    TrackerKCF::Params params;
+    std::vector< Ptr<TrackerKCFImpl> > trackers;
+    Mat frame, half_frame;
+  };
+
+  Ptr<TrackerBatch> TrackerBatch::createKCF(const TrackerKCF::Params &parameters){
+      return makePtr<TrackerBatchKCFImpl>(parameters);
+  }
+  Ptr<TrackerBatch> TrackerBatch::createKCF(){
+      return makePtr<TrackerBatchKCFImpl>();
+  }
 } /* namespace cv */
@@ -200,6 +200,7 @@ bool TrackerMILImpl::initImpl( const Mat& image, const Rect2d& boundingBox )
 
 bool TrackerMILImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
 {
+  int64 stageStart = getTickCount();
   Mat intImage;
   compute_integral( image, intImage );
 
@@ -230,14 +231,18 @@ bool TrackerMILImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
   //extract features from new samples
   featureSet->extraction( detectSamples );
   std::vector<Mat> response = featureSet->getResponses();
+  addStageTime( STAGE_FEATURE_EXTRACTION, stageStart );
 
   //predict new location
+  stageStart = getTickCount();
   ConfidenceMap cmap;
   model.staticCast<TrackerMILModel>()->setMode( TrackerMILModel::MODE_ESTIMATON, detectSamples );
   model.staticCast<TrackerMILModel>()->responseToConfidenceMap( response, cmap );
   model->getTrackerStateEstimator().staticCast<TrackerStateEstimatorMILBoosting>()->setCurrentConfidenceMap( cmap );
 
-  if( !model->runStateEstimator() )
+  bool located = model->runStateEstimator();
+  addStageTime( STAGE_DETECTION, stageStart );
+  if( !located )
   {
     return false;
   }
@@ -253,6 +258,7 @@ bool TrackerMILImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
    //waitKey( 0 );*/
 
   //sampling new frame based on new location
+  stageStart = getTickCount();
   //Positive sampling
   ( sampler->getSamplers().at( 0 ).second ).staticCast<TrackerSamplerCSC>()->setMode( TrackerSamplerCSC::MODE_INIT_POS );
   sampler->sampling( intImage, boundingBox );
@@ -272,8 +278,10 @@ bool TrackerMILImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
 
   featureSet->extraction( negSamples );
   std::vector<Mat> negResponse = featureSet->getResponses();
+  addStageTime( STAGE_FEATURE_EXTRACTION, stageStart );
 
   //model estimate
+  stageStart = getTickCount();
   model.staticCast<TrackerMILModel>()->setMode( TrackerMILModel::MODE_POSITIVE, posSamples );
   model->modelEstimation( posResponse );
   model.staticCast<TrackerMILModel>()->setMode( TrackerMILModel::MODE_NEGATIVE, negSamples );
@@ -281,6 +289,7 @@ bool TrackerMILImpl::updateImpl( const Mat& image, Rect2d& boundingBox )
 
   //model update
   model->modelUpdate();
+  addStageTime( STAGE_MODEL_UPDATE, stageStart );
 
   return true;
 }
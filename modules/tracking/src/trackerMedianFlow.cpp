@@ -43,6 +43,7 @@
 #include "opencv2/video/tracking.hpp"
 #include "opencv2/imgproc.hpp"
 #include "tracking_utils.hpp"
+#include "trackerBatch.hpp"
 #include <algorithm>
 #include <limits.h>
 
@@ -77,6 +78,7 @@ public:
     TrackerMedianFlowImpl(TrackerMedianFlow::Params paramsIn = TrackerMedianFlow::Params()) {params=paramsIn;isInit=false;}
     void read( const FileNode& fn ) CV_OVERRIDE;
     void write( FileStorage& fs ) const CV_OVERRIDE;
+    void medianFlowImpl(Mat oldImage,Mat newImage,std::vector<Rect2d>& boxes,std::vector<uchar>& success);
 private:
     bool initImpl( const Mat& image, const Rect2d& boundingBox ) CV_OVERRIDE;
     bool updateImpl( const Mat& image, Rect2d& boundingBox ) CV_OVERRIDE;
@@ -87,12 +89,12 @@ private:
 #if 0
     void computeStatistics(std::vector<float>& data,int size=-1);
 #endif
-    void check_FB(const std::vector<Mat>& oldImagePyr,const std::vector<Mat>& newImagePyr,
-                  const std::vector<Point2f>& oldPoints,const std::vector<Point2f>& newPoints,std::vector<bool>& status);
+    void check_FB(const std::vector<Point2f>& oldPoints,const std::vector<Point2f>& reprojectedPoints,std::vector<bool>& status);
     void check_NCC(const Mat& oldImage,const Mat& newImage,
                    const std::vector<Point2f>& oldPoints,const std::vector<Point2f>& newPoints,std::vector<bool>& status);
 
     TrackerMedianFlow::Params params;
+    std::vector<double> buf_for_scale; // pairwise distance ratios for the scale median
 };
 
 Mat getPatch(Mat image, Size patch_size, Point2f patch_center)
@@ -156,8 +158,10 @@ bool TrackerMedianFlowImpl::updateImpl( const Mat& image, Rect2d& boundingBox ){
         return false;
     }
     boundingBox=oldBox;
+    int64 stageStart = getTickCount();
     ((TrackerMedianFlowModel*)static_cast<TrackerModel*>(model))->setImage(image);
     ((TrackerMedianFlowModel*)static_cast<TrackerModel*>(model))->setBoudingBox(oldBox);
+    addStageTime(STAGE_MODEL_UPDATE, stageStart);
     return true;
 }
 
@@ -195,27 +199,48 @@ size_t filterPointsInVectors(std::vector<T>& status, std::vector<Point2f>& vec1,
 }
 
 bool TrackerMedianFlowImpl::medianFlowImpl(Mat oldImage,Mat newImage,Rect2d& oldBox){
-    std::vector<Point2f> pointsToTrackOld,pointsToTrackNew;
+    std::vector<Rect2d> boxes(1, oldBox);
+    std::vector<uchar> success;
+    medianFlowImpl(oldImage, newImage, boxes, success);
+    if(!success[0]){
+        return false;
+    }
+    oldBox=boxes[0];
+    return true;
+}
+
+void TrackerMedianFlowImpl::medianFlowImpl(Mat oldImage,Mat newImage,std::vector<Rect2d>& boxes,std::vector<uchar>& success){
+    const size_t numTargets = boxes.size();
+    success.assign(numTargets, 0);
 
+    int64 stageStart = getTickCount();
     Mat oldImage_gray,newImage_gray;
     if (oldImage.channels() != 1)
         cvtColor( oldImage, oldImage_gray, COLOR_BGR2GRAY );
     else
-        oldImage.copyTo(oldImage_gray);
+        oldImage_gray = oldImage;
 
     if (newImage.channels() != 1)
         cvtColor( newImage, newImage_gray, COLOR_BGR2GRAY );
     else
-        newImage.copyTo(newImage_gray);
-
-    //"open ended" grid
-    for(int i=0;i<params.pointsInGrid;i++){
-        for(int j=0;j<params.pointsInGrid;j++){
-            pointsToTrackOld.push_back(
-                        Point2f((float)(oldBox.x+((1.0*oldBox.width)/params.pointsInGrid)*j+.5*oldBox.width/params.pointsInGrid),
-                                (float)(oldBox.y+((1.0*oldBox.height)/params.pointsInGrid)*i+.5*oldBox.height/params.pointsInGrid)));
+        newImage_gray = newImage;
+
+    //"open ended" grid for every target, the points of target t are [targetStart[t], targetStart[t+1])
+    std::vector<Point2f> pointsToTrackOld,pointsToTrackNew;
+    std::vector<size_t> targetStart(numTargets + 1, 0);
+    pointsToTrackOld.reserve(numTargets*params.pointsInGrid*params.pointsInGrid);
+    for(size_t t=0;t<numTargets;t++){
+        const Rect2d& oldBox=boxes[t];
+        targetStart[t]=pointsToTrackOld.size();
+        for(int i=0;i<params.pointsInGrid;i++){
+            for(int j=0;j<params.pointsInGrid;j++){
+                pointsToTrackOld.push_back(
+                            Point2f((float)(oldBox.x+((1.0*oldBox.width)/params.pointsInGrid)*j+.5*oldBox.width/params.pointsInGrid),
+                                    (float)(oldBox.y+((1.0*oldBox.height)/params.pointsInGrid)*i+.5*oldBox.height/params.pointsInGrid)));
+            }
         }
     }
+    targetStart[numTargets]=pointsToTrackOld.size();
 
     std::vector<uchar> status(pointsToTrackOld.size());
     std::vector<float> errors(pointsToTrackOld.size());
@@ -225,7 +250,12 @@ bool TrackerMedianFlowImpl::medianFlowImpl(Mat oldImage,Mat newImage,Rect2d& old
 
     std::vector<Mat> newImagePyr;
     buildOpticalFlowPyramid(newImage_gray, newImagePyr, params.winSize, params.maxLevel, false);
+    addStageTime(STAGE_FEATURE_EXTRACTION, stageStart);
+
+    // the optical flow and the point filtering locate the targets
+    stageStart = getTickCount();
 
+    // LK treats every point independently, so all targets share one forward call
     calcOpticalFlowPyrLK(oldImagePyr,newImagePyr,pointsToTrackOld,pointsToTrackNew,status,errors,
                          params.winSize, params.maxLevel, params.termCriteria, 0);
 
@@ -233,58 +263,87 @@ bool TrackerMedianFlowImpl::medianFlowImpl(Mat oldImage,Mat newImage,Rect2d& old
     CV_Assert(status.size() == pointsToTrackOld.size());
     dprintf(("\t%d after LK forward\n",(int)pointsToTrackOld.size()));
 
-    size_t num_good_points_after_optical_flow = filterPointsInVectors(status, pointsToTrackOld, pointsToTrackNew, (uchar)1);
-
-    dprintf(("\t num_good_points_after_optical_flow = %d\n",num_good_points_after_optical_flow));
+    // keep the points of every target with a good forward status, packed target after target
+    std::vector<Point2f> goodPointsOld,goodPointsNew;
+    std::vector<size_t> goodStart(numTargets + 1, 0);
+    goodPointsOld.reserve(pointsToTrackOld.size());
+    goodPointsNew.reserve(pointsToTrackOld.size());
+    for(size_t t=0;t<numTargets;t++){
+        goodStart[t]=goodPointsOld.size();
+        for(size_t i=targetStart[t];i<targetStart[t+1];i++){
+            if(status[i]==1){
+                goodPointsOld.push_back(pointsToTrackOld[i]);
+                goodPointsNew.push_back(pointsToTrackNew[i]);
+            }
+        }
+        dprintf(("\t num_good_points_after_optical_flow = %d\n",(int)(goodPointsOld.size()-goodStart[t])));
+    }
+    goodStart[numTargets]=goodPointsOld.size();
 
-    if (num_good_points_after_optical_flow == 0) {
-        return false;
+    if(goodPointsOld.empty()){
+        addStageTime(STAGE_DETECTION, stageStart);
+        return;
     }
 
-    CV_Assert(pointsToTrackOld.size() == num_good_points_after_optical_flow);
-    CV_Assert(pointsToTrackNew.size() == num_good_points_after_optical_flow);
+    // one backward call for the forward-backward error of all targets
+    std::vector<Point2f> pointsToTrackReprojection;
+    status.resize(goodPointsNew.size());
+    errors.resize(goodPointsNew.size());
+    calcOpticalFlowPyrLK(newImagePyr, oldImagePyr,goodPointsNew,pointsToTrackReprojection,status,errors,
+                         params.winSize, params.maxLevel, params.termCriteria, 0);
 
-    dprintf(("\t%d after LK forward after removing points with bad status\n",(int)pointsToTrackOld.size()));
+    for(size_t t=0;t<numTargets;t++){
+        if(goodStart[t]==goodStart[t+1]){
+            continue;
+        }
 
-    std::vector<bool> filter_status(pointsToTrackOld.size(), true);
-    check_FB(oldImagePyr, newImagePyr, pointsToTrackOld, pointsToTrackNew, filter_status);
-    check_NCC(oldImage_gray, newImage_gray, pointsToTrackOld, pointsToTrackNew, filter_status);
+        std::vector<Point2f> targetPointsOld(goodPointsOld.begin()+goodStart[t],goodPointsOld.begin()+goodStart[t+1]);
+        std::vector<Point2f> targetPointsNew(goodPointsNew.begin()+goodStart[t],goodPointsNew.begin()+goodStart[t+1]);
+        std::vector<Point2f> targetReprojection(pointsToTrackReprojection.begin()+goodStart[t],
+                                                pointsToTrackReprojection.begin()+goodStart[t+1]);
 
-    // filter
-    size_t num_good_points_after_filtering = filterPointsInVectors(filter_status, pointsToTrackOld, pointsToTrackNew, true);
+        std::vector<bool> filter_status(targetPointsOld.size(), true);
+        check_FB(targetPointsOld, targetReprojection, filter_status);
+        check_NCC(oldImage_gray, newImage_gray, targetPointsOld, targetPointsNew, filter_status);
 
-    dprintf(("\t num_good_points_after_filtering = %d\n",num_good_points_after_filtering));
+        // filter
+        size_t num_good_points_after_filtering = filterPointsInVectors(filter_status, targetPointsOld, targetPointsNew, true);
 
-    if(num_good_points_after_filtering == 0){
-        return false;
-    }
+        dprintf(("\t num_good_points_after_filtering = %d\n",num_good_points_after_filtering));
 
-    CV_Assert(pointsToTrackOld.size() == num_good_points_after_filtering);
-    CV_Assert(pointsToTrackNew.size() == num_good_points_after_filtering);
+        if(num_good_points_after_filtering == 0){
+            continue;
+        }
 
-    dprintf(("\t%d after LK backward\n",(int)pointsToTrackOld.size()));
+        CV_Assert(targetPointsOld.size() == num_good_points_after_filtering);
+        CV_Assert(targetPointsNew.size() == num_good_points_after_filtering);
 
-    std::vector<Point2f> di(pointsToTrackOld.size());
-    for(size_t i=0; i<pointsToTrackOld.size(); i++){
-        di[i] = pointsToTrackNew[i]-pointsToTrackOld[i];
-    }
+        dprintf(("\t%d after LK backward\n",(int)targetPointsOld.size()));
 
-    Point2f mDisplacement;
-    oldBox=vote(pointsToTrackOld,pointsToTrackNew,oldBox,mDisplacement);
+        std::vector<Point2f> di(targetPointsOld.size());
+        for(size_t i=0; i<targetPointsOld.size(); i++){
+            di[i] = targetPointsNew[i]-targetPointsOld[i];
+        }
 
-    std::vector<float> displacements;
-    for(size_t i=0;i<di.size();i++){
-        di[i]-=mDisplacement;
-        displacements.push_back((float)sqrt(di[i].ddot(di[i])));
-    }
-    float median_displacements = tracking_internal::getMedianAndDoPartition(displacements);
-    dprintf(("\tmedian of length of difference of displacements = %f\n", median_displacements));
-    if(median_displacements > params.maxMedianLengthOfDisplacementDifference){
-        dprintf(("\tmedian flow tracker returns false due to big median length of difference between displacements\n"));
-        return false;
-    }
+        Point2f mDisplacement;
+        Rect2d newBox=vote(targetPointsOld,targetPointsNew,boxes[t],mDisplacement);
 
-    return true;
+        std::vector<float> displacements;
+        for(size_t i=0;i<di.size();i++){
+            di[i]-=mDisplacement;
+            displacements.push_back((float)sqrt(di[i].ddot(di[i])));
+        }
+        float median_displacements = tracking_internal::getMedianAndDoPartition(displacements);
+        dprintf(("\tmedian of length of difference of displacements = %f\n", median_displacements));
+        if(median_displacements > params.maxMedianLengthOfDisplacementDifference){
+            dprintf(("\tmedian flow tracker returns false due to big median length of difference between displacements\n"));
+            continue;
+        }
+
+        boxes[t]=newBox;
+        success[t]=1;
+    }
+    addStageTime(STAGE_DETECTION, stageStart);
 }
 
 Rect2d TrackerMedianFlowImpl::vote(const std::vector<Point2f>& oldPoints,const std::vector<Point2f>& newPoints,const Rect2d& oldRect,Point2f& mD){
@@ -312,13 +371,29 @@ Rect2d TrackerMedianFlowImpl::vote(const std::vector<Point2f>& oldPoints,const s
     newCenter.y+=yshift;
     mD=Point2f((float)xshift,(float)yshift);
 
-    std::vector<double> buf_for_scale(n*(n-1)/2, 0.0);
-    for(size_t i=0,ctr=0;i<n;i++){
-        for(size_t j=0;j<i;j++){
+    const size_t numPairs=n*(n-1)/2;
+    if(params.maxScalePairs<=0 || numPairs<=(size_t)params.maxScalePairs){
+        buf_for_scale.resize(numPairs);
+        for(size_t i=0,ctr=0;i<n;i++){
+            for(size_t j=0;j<i;j++){
+                double nd=norm(newPoints[i] - newPoints[j]);
+                double od=norm(oldPoints[i] - oldPoints[j]);
+                buf_for_scale[ctr]=(od==0.0)?0.0:(nd/od);
+                ctr++;
+            }
+        }
+    }else{
+        // the median of uniformly sampled pairs estimates the median of all of them with bounded
+        // memory and time, a fixed seed keeps the tracker deterministic
+        RNG rng(0x4d46);
+        buf_for_scale.resize(params.maxScalePairs);
+        for(size_t ctr=0;ctr<buf_for_scale.size();ctr++){
+            int i=rng.uniform(0,(int)n);
+            int j=rng.uniform(0,(int)n-1);
+            if(j>=i)j++;
             double nd=norm(newPoints[i] - newPoints[j]);
             double od=norm(oldPoints[i] - oldPoints[j]);
             buf_for_scale[ctr]=(od==0.0)?0.0:(nd/od);
-            ctr++;
         }
     }
 
@@ -349,22 +424,16 @@ void TrackerMedianFlowImpl::computeStatistics(std::vector<float>& data,int size)
     }
 }
 #endif
-void TrackerMedianFlowImpl::check_FB(const std::vector<Mat>& oldImagePyr, const std::vector<Mat>& newImagePyr,
-                                     const std::vector<Point2f>& oldPoints, const std::vector<Point2f>& newPoints, std::vector<bool>& status){
+void TrackerMedianFlowImpl::check_FB(const std::vector<Point2f>& oldPoints, const std::vector<Point2f>& reprojectedPoints,
+                                     std::vector<bool>& status){
 
     if(status.empty()) {
         status=std::vector<bool>(oldPoints.size(),true);
     }
 
-    std::vector<uchar> LKstatus(oldPoints.size());
-    std::vector<float> errors(oldPoints.size());
     std::vector<float> FBerror(oldPoints.size());
-    std::vector<Point2f> pointsToTrackReprojection;
-    calcOpticalFlowPyrLK(newImagePyr, oldImagePyr,newPoints,pointsToTrackReprojection,LKstatus,errors,
-                         params.winSize, params.maxLevel, params.termCriteria, 0);
-
     for(size_t i=0;i<oldPoints.size();i++){
-        FBerror[i]=(float)norm(oldPoints[i]-pointsToTrackReprojection[i]);
+        FBerror[i]=(float)norm(oldPoints[i]-reprojectedPoints[i]);
     }
     float FBerrorMedian=tracking_internal::getMedian(FBerror);
     dprintf(("point median=%f\n",FBerrorMedian));
@@ -391,6 +460,56 @@ void TrackerMedianFlowImpl::check_NCC(const Mat& oldImage,const Mat& newImage,
     }
 }
 
+/*
+ * Batch of MedianFlow targets sharing the gray frames and the optical flow calls
+ */
+class TrackerBatchMedianFlowImpl CV_FINAL : public TrackerBatchImpl{
+public:
+    TrackerBatchMedianFlowImpl(TrackerMedianFlow::Params paramsIn = TrackerMedianFlow::Params()) : engine(paramsIn) {}
+
+protected:
+    void prepareFrame( const Mat& image ) CV_OVERRIDE {
+        // a new buffer every frame, image_prev keeps the previous one
+        Mat next;
+        if (image.channels() != 1)
+            cvtColor( image, next, COLOR_BGR2GRAY );
+        else
+            next = image.clone();
+        image_gray = next;
+    }
+
+    bool initTarget( size_t idx ) CV_OVERRIDE {
+        image_prev = image_gray;
+        return objects[idx].area() > 0;
+    }
+
+    void updateTargets() CV_OVERRIDE {
+        std::vector<Rect2d> boxes;
+        std::vector<size_t> targets;
+        for(size_t i=0;i<objects.size();i++){
+            if(initialized[i]){
+                boxes.push_back(objects[i]);
+                targets.push_back(i);
+            }
+        }
+        objectStatus.assign(objects.size(), 0);
+
+        std::vector<uchar> success;
+        if(!boxes.empty())
+            engine.medianFlowImpl(image_prev, image_gray, boxes, success);
+        for(size_t t=0;t<targets.size();t++){
+            if(success[t]){
+                objects[targets[t]]=boxes[t];
+                objectStatus[targets[t]]=1;
+            }
+        }
+        image_prev = image_gray;
+    }
+
+    TrackerMedianFlowImpl engine;
+    Mat image_prev, image_gray;
+};
+
 } /* anonymous namespace */
 
 namespace cv
@@ -405,6 +524,7 @@ TrackerMedianFlow::Params::Params() {
     termCriteria = TermCriteria(TermCriteria::COUNT|TermCriteria::EPS,20,0.3);
     winSizeNCC = Size(30,30);
     maxMedianLengthOfDisplacementDifference = 10;
+    maxScalePairs = 5000;
 }
 
 void TrackerMedianFlow::Params::read( const cv::FileNode& fn ){
@@ -430,6 +550,9 @@ void TrackerMedianFlow::Params::read( const cv::FileNode& fn ){
 
     if(!fn["termCriteria_epsilon"].empty())
         fn["termCriteria_epsilon"] >> termCriteria.epsilon;
+
+    if(!fn["maxScalePairs"].empty())
+        fn["maxScalePairs"] >> maxScalePairs;
 }
 
 void TrackerMedianFlow::Params::write( cv::FileStorage& fs ) const{
@@ -440,6 +563,7 @@ void TrackerMedianFlow::Params::write( cv::FileStorage& fs ) const{
     fs << "termCriteria_epsilon" << termCriteria.epsilon;
     fs << "winSizeNCC" << winSizeNCC;
     fs << "maxMedianLengthOfDisplacementDifference" << maxMedianLengthOfDisplacementDifference;
+    fs << "maxScalePairs" << maxScalePairs;
 }
 
 Ptr<TrackerMedianFlow> TrackerMedianFlow::create(const TrackerMedianFlow::Params &parameters){
@@ -449,4 +573,11 @@ Ptr<TrackerMedianFlow> TrackerMedianFlow::create(){
     return Ptr<TrackerMedianFlowImpl>(new TrackerMedianFlowImpl());
 }
 
+Ptr<TrackerBatch> TrackerBatch::createMedianFlow(const TrackerMedianFlow::Params &parameters){
+    return Ptr<TrackerBatchMedianFlowImpl>(new TrackerBatchMedianFlowImpl(parameters));
+}
+Ptr<TrackerBatch> TrackerBatch::createMedianFlow(){
+    return Ptr<TrackerBatchMedianFlowImpl>(new TrackerBatchMedianFlowImpl());
+}
+
 } /* namespace cv */
@@ -3,6 +3,7 @@
 // of this distribution and at http://opencv.org/license.html.
 
 #include "tracking_utils.hpp"
+#include "opencv2/core/hal/intrin.hpp"
 
 using namespace cv;
 
@@ -67,3 +68,172 @@ double tracking_internal::computeNCC(const Mat& patch1, const Mat& patch2)
         return (sq2 == 0) ? sq1 / abs(sq1) : (prod - s1 * s2 / N) / sq1 / sq2;
     }
 }
+
+namespace {
+
+// Columns of a CCS packed spectrum that hold their complex values vertically: the DC column and,
+// for an even number of columns, the Nyquist column. All other columns hold (Re, Im) pairs
+// side by side in every row.
+inline int numVerticalCCSCols(int cols)
+{
+    return (cols > 1 && cols % 2 == 0) ? 2 : 1;
+}
+
+inline void divComplex(float ar, float ai, float br, float bi, float& dr, float& di)
+{
+    // (a+bi)/(c+di)=[(ac+bd)+i(bc-ad)]/(c^2+d^2)
+    float den = 1.0f / (br*br + bi*bi);
+    dr = (ar*br + ai*bi)*den;
+    di = (ai*br - ar*bi)*den;
+}
+
+} // namespace
+
+void tracking_internal::divSpectrumsCCS(const Mat& a, const Mat& b, Mat& dst)
+{
+    CV_Assert(a.type() == CV_32FC1 && b.type() == CV_32FC1 && a.size() == b.size());
+    dst.create(a.size(), CV_32FC1);
+
+    const int rows = a.rows, cols = a.cols;
+
+    // DC and Nyquist columns: real first (and last, for even rows) element, pairs in between
+    for(int n = 0; n < numVerticalCCSCols(cols); n++)
+    {
+        const int c = n == 0 ? 0 : cols - 1;
+        dst.at<float>(0, c) = a.at<float>(0, c) / b.at<float>(0, c);
+        for(int i = 1; i + 1 < rows; i += 2)
+        {
+            divComplex(a.at<float>(i, c), a.at<float>(i + 1, c),
+                       b.at<float>(i, c), b.at<float>(i + 1, c),
+                       dst.at<float>(i, c), dst.at<float>(i + 1, c));
+        }
+        if(rows > 1 && rows % 2 == 0)
+            dst.at<float>(rows - 1, c) = a.at<float>(rows - 1, c) / b.at<float>(rows - 1, c);
+    }
+
+    // remaining columns: (Re, Im) pairs along every row
+    const int endCol = cols % 2 == 0 ? cols - 1 : cols;
+    for(int i = 0; i < rows; i++)
+    {
+        const float* aPtr = a.ptr<float>(i);
+        const float* bPtr = b.ptr<float>(i);
+        float* dstPtr = dst.ptr<float>(i);
+        for(int j = 1; j < endCol; j += 2)
+            divComplex(aPtr[j], aPtr[j + 1], bPtr[j], bPtr[j + 1], dstPtr[j], dstPtr[j + 1]);
+    }
+}
+
+void tracking_internal::addRealCCS(const Mat& src, float value, Mat& dst)
+{
+    CV_Assert(src.type() == CV_32FC1);
+    if(dst.data != src.data)
+        src.copyTo(dst);
+
+    const int rows = dst.rows, cols = dst.cols;
+
+    for(int n = 0; n < numVerticalCCSCols(cols); n++)
+    {
+        const int c = n == 0 ? 0 : cols - 1;
+        dst.at<float>(0, c) += value;
+        for(int i = 1; i + 1 < rows; i += 2)
+            dst.at<float>(i, c) += value;
+        if(rows > 1 && rows % 2 == 0)
+            dst.at<float>(rows - 1, c) += value;
+    }
+
+    const int endCol = cols % 2 == 0 ? cols - 1 : cols;
+    for(int i = 0; i < rows; i++)
+    {
+        float* dstPtr = dst.ptr<float>(i);
+        for(int j = 1; j < endCol; j += 2)
+            dstPtr[j] += value;
+    }
+}
+
+void tracking_internal::extractColorNames(const Mat& patch, const Mat& window, Mat& cnFeatures, Mat& indexBuffer)
+{
+    CV_Assert(patch.type() == CV_8UC3 && window.type() == CV_32FC1 && window.size() == patch.size());
+    cnFeatures.create(patch.rows, patch.cols, CV_32FC(10));
+    indexBuffer.create(1, patch.cols, CV_16U);
+    ushort* index = indexBuffer.ptr<ushort>();
+
+    for(int i = 0; i < patch.rows; i++)
+    {
+        const uchar* pixel = patch.ptr<uchar>(i);
+        const float* weights = window.ptr<float>(i);
+        float* features = cnFeatures.ptr<float>(i);
+
+        // table row of every pixel: red/8 + 32*green/8 + 32*32*blue/8
+        int j = 0;
+#if CV_SIMD
+        for(; j <= patch.cols - v_uint8::nlanes; j += v_uint8::nlanes)
+        {
+            v_uint8 b, g, r;
+            v_load_deinterleave(pixel + 3*j, b, g, r);
+
+            v_uint16 b0, b1, g0, g1, r0, r1;
+            v_expand(b, b0, b1);
+            v_expand(g, g0, g1);
+            v_expand(r, r0, r1);
+
+            v_store(index + j, (r0 >> 3) | ((g0 >> 3) << 5) | ((b0 >> 3) << 10));
+            v_store(index + j + v_uint16::nlanes, (r1 >> 3) | ((g1 >> 3) << 5) | ((b1 >> 3) << 10));
+        }
+#endif
+        for(; j < patch.cols; j++)
+            index[j] = (ushort)((pixel[3*j + 2] >> 3) | ((pixel[3*j + 1] >> 3) << 5) | ((pixel[3*j] >> 3) << 10));
+
+        // copy the 10 values of every pixel scaled by its window weight
+        for(j = 0; j < patch.cols; j++)
+        {
+            const float* names = ColorNames[index[j]];
+            float* dest = features + 10*j;
+#if CV_SIMD128
+            // the last store overlaps the second one, so 10 values take 3 vector stores
+            v_float32x4 weight = v_setall_f32(weights[j]);
+            v_store(dest, v_load(names) * weight);
+            v_store(dest + 4, v_load(names + 4) * weight);
+            v_store(dest + 6, v_load(names + 6) * weight);
+#else
+            for(int k = 0; k < 10; k++)
+                dest[k] = names[k] * weights[j];
+#endif
+        }
+    }
+}
+
+void tracking_internal::extractGrayFeatures(const Mat& gray, const Mat& window, Mat& grayFeatures)
+{
+    CV_Assert(gray.channels() == 1 && window.type() == CV_32FC1 && window.size() == gray.size());
+    const float scale = 1.0f / 255.0f;
+    const float shift = -0.5f;
+
+    // the fast path below reads 8 bit pixels, other depths keep the generic conversion
+    if(gray.depth() != CV_8U)
+    {
+        gray.convertTo(grayFeatures, CV_32F, scale, shift);
+        grayFeatures = grayFeatures.mul(window);
+        return;
+    }
+
+    grayFeatures.create(gray.rows, gray.cols, CV_32F);
+
+    for(int i = 0; i < gray.rows; i++)
+    {
+        const uchar* pixel = gray.ptr<uchar>(i);
+        const float* weights = window.ptr<float>(i);
+        float* features = grayFeatures.ptr<float>(i);
+
+        int j = 0;
+#if CV_SIMD
+        v_float32 v_scale = vx_setall_f32(scale), v_shift = vx_setall_f32(shift);
+        for(; j <= gray.cols - v_float32::nlanes; j += v_float32::nlanes)
+        {
+            v_float32 value = v_cvt_f32(v_reinterpret_as_s32(vx_load_expand_q(pixel + j)));
+            v_store(features + j, v_muladd(value, v_scale, v_shift) * vx_load(weights + j));
+        }
+#endif
+        for(; j < gray.cols; j++)
+            features[j] = (pixel[j] * scale + shift) * weights[j];
+    }
+}
@@ -11,7 +11,23 @@ namespace tracking_internal
 {
 /** Computes normalized corellation coefficient between the two patches (they should be
 * of the same size).*/
-    double computeNCC(const Mat& patch1, const Mat& patch2);
+    CV_EXPORTS double computeNCC(const Mat& patch1, const Mat& patch2);
+
+/** Element-wise complex division dst = a / b of two single channel spectrums in the packed CCS
+* format produced by dft() on real input (the counterpart of mulSpectrums for division).*/
+    CV_EXPORTS void divSpectrumsCCS(const Mat& a, const Mat& b, Mat& dst);
+
+/** Adds value to the real part of every element of a single channel CCS packed spectrum, like
+* adding a real scalar to a complex spectrum.*/
+    CV_EXPORTS void addRealCCS(const Mat& src, float value, Mat& dst);
+
+/** Looks up the ColorNames of every pixel of a BGR 8 bit patch and weights them with the single channel
+* CV_32F window of the same size into a CV_32FC(10) feature map. indexBuffer is reused for the table rows
+* of one patch row.*/
+    CV_EXPORTS void extractColorNames(const Mat& patch, const Mat& window, Mat& cnFeatures, Mat& indexBuffer);
+
+/** Normalizes a grayscale patch to -0.5 .. 0.5 and weights it with the CV_32F window of the same size.*/
+    CV_EXPORTS void extractGrayFeatures(const Mat& gray, const Mat& window, Mat& grayFeatures);
 
     template<typename T>
     T getMedianAndDoPartition(std::vector<T>& values)
@@ -0,0 +1,29 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#ifndef __OPENCV_TRACKING_TEST_SYNTHETIC_FRAMES_HPP__
+#define __OPENCV_TRACKING_TEST_SYNTHETIC_FRAMES_HPP__
+
+// Synthetic sequences shared by the accuracy tests and the perf tests, no dataset needed
+
+namespace opencv_test { namespace {
+
+// textured square moving diagonally over a textured background,
+// the same background and square texture in every frame
+static inline void makeMovingSquareFrame(int frameIdx, Mat& frame, Rect& square,
+                                         Size frameSize = Size(320, 240), Point origin = Point(60, 50), int side = 40)
+{
+  RNG rng(0x12345);
+  frame.create(frameSize, CV_8UC3);
+  rng.fill(frame, RNG::UNIFORM, Scalar::all(0), Scalar::all(64));
+
+  Mat patch(side, side, CV_8UC3);
+  rng.fill(patch, RNG::UNIFORM, Scalar::all(128), Scalar::all(256));
+  square = Rect(origin.x + 2 * frameIdx, origin.y + frameIdx, side, side);
+  patch.copyTo(frame(square));
+}
+
+}} // namespace
+
+#endif
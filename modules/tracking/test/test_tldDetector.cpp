@@ -0,0 +1,99 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "../src/tldDetector.hpp"
+#include "../src/tracking_utils.hpp"
+
+namespace opencv_test { namespace {
+
+using namespace cv::tld;
+
+TEST(TLDDetector, StoreSimilarityMatchesComputeNCC)
+{
+    const int patchArea = STANDARD_PATCH_SIZE * STANDARD_PATCH_SIZE;
+    const int storeSize = 20;
+
+    // one stored patch per row, the way the positive and negative examples are kept
+    Mat store(storeSize, patchArea, CV_8U);
+    randu(store, 0, 256);
+
+    for (int q = 0; q < 5; q++)
+    {
+        Mat_<uchar> patch(STANDARD_PATCH_SIZE, STANDARD_PATCH_SIZE);
+        randu(patch, 0, 256);
+        // one stored patch equal to the query
+        patch.reshape(1, 1).copyTo(store.row(q));
+
+        StoreSimilarity similarity(patch);
+        for (int i = 0; i < storeSize; i++)
+        {
+            Mat stored = store.row(i).reshape(1, STANDARD_PATCH_SIZE);
+            double expected = 0.5 * (tracking_internal::computeNCC(stored, patch) + 1.0);
+            EXPECT_NEAR(expected, similarity(store, i), 1e-9) << "query " << q << ", stored patch " << i;
+        }
+    }
+}
+
+TEST(TLDDetector, FernsPosteriorMatchesPerFernCodes)
+{
+    const Size patchSize(24, 20);
+    const int numFerns = 10;
+    const int numCodes = 1 << MEASURES_PER_CLASSIFIER;
+    RNG& rng = theRNG();
+
+    // pixel pairs inside the patch and counts of positive and negative examples for every fern code,
+    // stored the way TLDEnsembleClassifier keeps its measurements and posAndNeg
+    std::vector<Vec4b> measurements(numFerns * MEASURES_PER_CLASSIFIER);
+    for (size_t i = 0; i < measurements.size(); i++)
+        measurements[i] = Vec4b((uchar)rng.uniform(0, patchSize.width), (uchar)rng.uniform(0, patchSize.width),
+                                (uchar)rng.uniform(0, patchSize.height), (uchar)rng.uniform(0, patchSize.height));
+    std::vector<Point2i> posAndNeg(numFerns * numCodes);
+    for (size_t i = 0; i < posAndNeg.size(); i++)
+        posAndNeg[i] = rng.uniform(0, 4) == 0 ? Point2i(0, 0) : Point2i(rng.uniform(0, 10), rng.uniform(0, 10));
+
+    // windows of an image wider than the patches, both paths use the row step of the image
+    Mat img(120, 160, CV_8U);
+    randu(img, 0, 256);
+    const int rowstep = (int)img.step[0];
+
+    // the fern arrays as TLDDetector::prepareFerns() and prepareFernPosteriors() lay them out
+    std::vector<int> offsetsA(measurements.size()), offsetsB(measurements.size());
+    for (size_t i = 0; i < measurements.size(); i++)
+    {
+        offsetsA[i] = rowstep * measurements[i][2] + measurements[i][0];
+        offsetsB[i] = rowstep * measurements[i][3] + measurements[i][1];
+    }
+    std::vector<double> posteriors(posAndNeg.size());
+    for (size_t i = 0; i < posAndNeg.size(); i++)
+        posteriors[i] = (posAndNeg[i].x == 0 && posAndNeg[i].y == 0) ? 0.0 : (double)posAndNeg[i].x / (posAndNeg[i].x + posAndNeg[i].y);
+
+    for (int y = 0; y + patchSize.height <= img.rows; y += 7)
+        for (int x = 0; x + patchSize.width <= img.cols; x += 5)
+        {
+            const uchar* data = img.ptr<uchar>(y, x);
+
+            // per fern code and posterior, as TLDEnsembleClassifier::posteriorProbability() computes them
+            double expected = 0;
+            for (int k = 0; k < numFerns; k++)
+            {
+                int position = 0;
+                for (int i = 0; i < MEASURES_PER_CLASSIFIER; i++)
+                {
+                    const Vec4b& m = measurements[k * MEASURES_PER_CLASSIFIER + i];
+                    position = position << 1;
+                    if (data[rowstep * m[2] + m[0]] < data[rowstep * m[3] + m[1]])
+                        position++;
+                }
+                const Point2i& counts = posAndNeg[k * numCodes + position];
+                expected += (counts.x == 0 && counts.y == 0) ? 0.0 : (double)counts.x / (counts.x + counts.y);
+            }
+            expected /= numFerns;
+
+            EXPECT_EQ(expected, fernsPosterior(data, &offsetsA[0], &offsetsB[0], &posteriors[0], numFerns, MEASURES_PER_CLASSIFIER))
+                << "window at " << Point(x, y);
+        }
+}
+
+}} // namespace
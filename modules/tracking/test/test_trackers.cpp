@@ -40,6 +40,7 @@
  //M*/
 
 #include "test_precomp.hpp"
+#include "test_synthetic_frames.hpp"
 
 namespace opencv_test { namespace {
 
@@ -570,5 +571,415 @@ TEST_P(DistanceAndOverlap, Scaled_Data_CSRT)
 
 INSTANTIATE_TEST_CASE_P( Tracking, DistanceAndOverlap, TESTSET_NAMES);
 
+/***************************************************************************************/
+//MultiTracker
+
+// Every test below plays the moving square sequence to the trackers it checks
+
+const int MOVING_SQUARE_FRAMES = 10;
+
+typedef Ptr<Tracker> (*TrackerFactory)();
+
+static Ptr<Tracker> createKCF() { return TrackerKCF::create(); }
+static Ptr<Tracker> createMOSSE() { return TrackerMOSSE::create(); }
+static Ptr<Tracker> createMedianFlow() { return TrackerMedianFlow::create(); }
+static Ptr<Tracker> createBoosting() { return TrackerBoosting::create(); }
+
+static Rect2d initialSquare()
+{
+  Mat frame;
+  Rect square;
+  makeMovingSquareFrame(0, frame, square);
+  return Rect2d(square);
+}
+
+// One way of tracking several targets on the same frames, target i is followed by the i-th tracker
+class TargetsTracking
+{
+public:
+  virtual ~TargetsTracking() {}
+  virtual bool init(const Mat& frame, const std::vector<Rect2d>& targets) = 0;
+  // found[i] is nonzero when boxes[i] is a location of target i
+  virtual void update(const Mat& frame, std::vector<Rect2d>& boxes, std::vector<uchar>& found) = 0;
+};
+
+// one independent tracker per target
+class SingleTrackers : public TargetsTracking
+{
+public:
+  explicit SingleTrackers(const std::vector<TrackerFactory>& factories_) : factories(factories_) {}
+
+  bool init(const Mat& frame, const std::vector<Rect2d>& targets) CV_OVERRIDE
+  {
+    CV_Assert(targets.size() == factories.size());
+    trackers.clear();
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+      trackers.push_back(factories[i]());
+      if (!trackers[i]->init(frame, targets[i]))
+        return false;
+    }
+    return true;
+  }
+
+  void update(const Mat& frame, std::vector<Rect2d>& boxes, std::vector<uchar>& found) CV_OVERRIDE
+  {
+    boxes.resize(trackers.size());
+    found.resize(trackers.size());
+    for (size_t i = 0; i < trackers.size(); i++)
+      found[i] = trackers[i]->update(frame, boxes[i]) ? 1 : 0;
+  }
+
+  std::vector<TrackerFactory> factories;
+  std::vector< Ptr<Tracker> > trackers;
+};
+
+// the trackers of one MultiTracker, which only reports whether all of them found their target
+class MultiTrackerTargets : public TargetsTracking
+{
+public:
+  MultiTrackerTargets(const std::vector<TrackerFactory>& factories_, bool parallelUpdate_)
+    : factories(factories_), parallelUpdate(parallelUpdate_) {}
+
+  bool init(const Mat& frame, const std::vector<Rect2d>& targets) CV_OVERRIDE
+  {
+    CV_Assert(targets.size() == factories.size());
+    multiTracker = MultiTracker::create();
+    multiTracker->setParallelUpdate(parallelUpdate);
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+      if (!multiTracker->add(factories[i](), frame, targets[i]))
+        return false;
+    }
+    return true;
+  }
+
+  void update(const Mat& frame, std::vector<Rect2d>& boxes, std::vector<uchar>& found) CV_OVERRIDE
+  {
+    bool status = multiTracker->update(frame, boxes);
+    found.assign(boxes.size(), status ? 1 : 0);
+  }
+
+  std::vector<TrackerFactory> factories;
+  bool parallelUpdate;
+  Ptr<MultiTracker> multiTracker;
+};
+
+// boxes and found flags of every target, and the square itself, indexed by frame
+struct TrackedSequence
+{
+  std::vector<Rect> squares;
+  std::vector< std::vector<Rect2d> > boxes;
+  std::vector< std::vector<uchar> > found;
+};
+
+static void playMovingSquare(TargetsTracking& tracking, const std::vector<Rect2d>& targets, TrackedSequence& result)
+{
+  Mat frame;
+  result.squares.resize(MOVING_SQUARE_FRAMES);
+  result.boxes.resize(MOVING_SQUARE_FRAMES);
+  result.found.resize(MOVING_SQUARE_FRAMES);
+
+  makeMovingSquareFrame(0, frame, result.squares[0]);
+  ASSERT_TRUE(tracking.init(frame, targets));
+  result.boxes[0] = targets;
+  result.found[0].assign(targets.size(), 1);
+
+  for (int frameIdx = 1; frameIdx < MOVING_SQUARE_FRAMES; frameIdx++)
+  {
+    makeMovingSquareFrame(frameIdx, frame, result.squares[frameIdx]);
+    tracking.update(frame, result.boxes[frameIdx], result.found[frameIdx]);
+    ASSERT_EQ(targets.size(), result.boxes[frameIdx].size()) << "frame " << frameIdx;
+    ASSERT_EQ(targets.size(), result.found[frameIdx].size()) << "frame " << frameIdx;
+  }
+}
+
+// Plays the whole sequence to the reference, then to the tested trackers, so both start from the same
+// process wide rand() state, and checks the tested trackers find every target where the reference does.
+// tolerance 0 requires exactly the boxes of the reference
+static void checkFollowsReference(TargetsTracking& reference, TargetsTracking& tested,
+                                  const std::vector<Rect2d>& targets, double tolerance = 0)
+{
+  TrackedSequence expected, actual;
+  ASSERT_NO_FATAL_FAILURE(playMovingSquare(reference, targets, expected));
+  ASSERT_NO_FATAL_FAILURE(playMovingSquare(tested, targets, actual));
+
+  for (int frameIdx = 1; frameIdx < MOVING_SQUARE_FRAMES; frameIdx++)
+  {
+    for (size_t i = 0; i < targets.size(); i++)
+    {
+      bool found = expected.found[frameIdx][i] != 0;
+      EXPECT_EQ(found, actual.found[frameIdx][i] != 0) << "target " << i << ", frame " << frameIdx;
+      if (!found)
+        continue;
+
+      const Rect2d& box = expected.boxes[frameIdx][i];
+      const Rect2d& testedBox = actual.boxes[frameIdx][i];
+      if (tolerance == 0)
+      {
+        EXPECT_EQ(box, testedBox) << "target " << i << ", frame " << frameIdx;
+        continue;
+      }
+      EXPECT_NEAR(box.x, testedBox.x, tolerance) << "target " << i << ", frame " << frameIdx;
+      EXPECT_NEAR(box.y, testedBox.y, tolerance) << "target " << i << ", frame " << frameIdx;
+      EXPECT_NEAR(box.width, testedBox.width, tolerance) << "target " << i << ", frame " << frameIdx;
+      EXPECT_NEAR(box.height, testedBox.height, tolerance) << "target " << i << ", frame " << frameIdx;
+    }
+  }
+}
+
+TEST(MultiTracker, ParallelUpdateMatchesSerial)
+{
+  // Boosting draws from rand() while updating, the parallel update has to keep it in order
+  std::vector<TrackerFactory> factories;
+  factories.push_back(createKCF);
+  factories.push_back(createMOSSE);
+  factories.push_back(createMedianFlow);
+  factories.push_back(createBoosting);
+  factories.push_back(createKCF);
+  std::vector<Rect2d> targets(factories.size(), initialSquare());
+
+  MultiTrackerTargets serialTracker(factories, false);
+  MultiTrackerTargets parallelTracker(factories, true);
+  checkFollowsReference(serialTracker, parallelTracker, targets);
+
+  EXPECT_FALSE(serialTracker.multiTracker->getParallelUpdate());
+  EXPECT_TRUE(parallelTracker.multiTracker->getParallelUpdate());
+  // the parallel update still times every tracker of the last frame
+  ASSERT_EQ(factories.size(), parallelTracker.multiTracker->getUpdateTimes().size());
+  for (size_t i = 0; i < factories.size(); i++)
+  {
+    EXPECT_GE(parallelTracker.multiTracker->getUpdateTimes()[i], 0.0) << "target " << i;
+  }
+}
+
+/***************************************************************************************/
+//CSRT
+
+static Ptr<Tracker> createCSRT() { return TrackerCSRT::create(); }
+
+static Ptr<Tracker> createCSRTFloat()
+{
+  TrackerCSRT::Params params;
+  params.use_float_precision = true;
+  return TrackerCSRT::create(params);
+}
+
+TEST(CSRT, FloatPrecisionFollowsDoublePrecision)
+{
+  SingleTrackers doubleTracker(std::vector<TrackerFactory>(1, createCSRT));
+  SingleTrackers floatTracker(std::vector<TrackerFactory>(1, createCSRTFloat));
+
+  // float rounding may move the subpixel peak slightly, but never by a whole cell,
+  // TrackingUtils.HOGFloatMatchesDouble checks the features themselves
+  checkFollowsReference(doubleTracker, floatTracker, std::vector<Rect2d>(1, initialSquare()), 1.0);
+}
+
+/***************************************************************************************/
+//MedianFlow
+
+// a smooth textured square which grows by 4% per frame around a fixed center
+static void makeGrowingSquareFrame(int frameIdx, Mat& frame, Rect& square)
+{
+  RNG rng(0x12345);
+  frame.create(240, 320, CV_8UC3);
+  rng.fill(frame, RNG::UNIFORM, Scalar::all(0), Scalar::all(64));
+
+  Mat coarse(8, 8, CV_8UC3), patch;
+  rng.fill(coarse, RNG::UNIFORM, Scalar::all(128), Scalar::all(256));
+  int side = cvRound(40 * (1.0 + 0.04 * frameIdx));
+  resize(coarse, patch, Size(side, side), 0, 0, INTER_LINEAR_EXACT);
+  square = Rect(160 - side / 2, 120 - side / 2, side, side);
+  patch.copyTo(frame(square));
+}
+
+TEST(MedianFlow, SampledScaleFollowsExactScale)
+{
+  Mat frame;
+  Rect square;
+  makeGrowingSquareFrame(0, frame, square);
+
+  // a dense grid gives hundreds of thousands of point pairs
+  TrackerMedianFlow::Params exactParams;
+  exactParams.pointsInGrid = 30;
+  exactParams.maxScalePairs = 0;
+  TrackerMedianFlow::Params sampledParams = exactParams;
+  sampledParams.maxScalePairs = 2000;
+
+  Ptr<Tracker> exactTracker = TrackerMedianFlow::create(exactParams);
+  Ptr<Tracker> sampledTracker = TrackerMedianFlow::create(sampledParams);
+
+  Rect2d boundingBox(square);
+  ASSERT_TRUE(exactTracker->init(frame, boundingBox));
+  ASSERT_TRUE(sampledTracker->init(frame, boundingBox));
+
+  const int numFrames = 10;
+  Rect2d exactBox, sampledBox;
+  for (int frameIdx = 1; frameIdx < numFrames; frameIdx++)
+  {
+    makeGrowingSquareFrame(frameIdx, frame, square);
+
+    ASSERT_TRUE(exactTracker->update(frame, exactBox));
+    ASSERT_TRUE(sampledTracker->update(frame, sampledBox));
+
+    EXPECT_NEAR(exactBox.width, sampledBox.width, 0.05 * exactBox.width) << "frame " << frameIdx;
+    EXPECT_NEAR(exactBox.height, sampledBox.height, 0.05 * exactBox.height) << "frame " << frameIdx;
+    EXPECT_NEAR(exactBox.x + exactBox.width / 2, sampledBox.x + sampledBox.width / 2, 1.0);
+    EXPECT_NEAR(exactBox.y + exactBox.height / 2, sampledBox.y + sampledBox.height / 2, 1.0);
+  }
+
+  // the square grows by 36% over the sequence, both estimators have to follow it
+  EXPECT_GT(exactBox.width, 1.2 * boundingBox.width);
+  EXPECT_GT(sampledBox.width, 1.2 * boundingBox.width);
+  EXPECT_NEAR(square.width, sampledBox.width, 0.1 * square.width);
+}
+
+/***************************************************************************************/
+//TrackerBatch
+
+// all targets of one TrackerBatch
+class BatchTargets : public TargetsTracking
+{
+public:
+  explicit BatchTargets(const Ptr<TrackerBatch>& batch_) : batch(batch_) {}
+
+  bool init(const Mat& frame, const std::vector<Rect2d>& targets) CV_OVERRIDE
+  {
+    return batch->add(frame, targets) && batch->getNumTargets() == (int)targets.size();
+  }
+
+  void update(const Mat& frame, std::vector<Rect2d>& boxes, std::vector<uchar>& found) CV_OVERRIDE
+  {
+    batch->update(frame, boxes, found);
+  }
+
+  Ptr<TrackerBatch> batch;
+};
+
+// the batch has to find the square and a looser box around it where independent trackers do
+static void checkBatchFollowsTrackers(const Ptr<TrackerBatch>& batch, TrackerFactory createTracker,
+                                      double tolerance = 0)
+{
+  Rect2d square = initialSquare();
+  std::vector<Rect2d> targets;
+  targets.push_back(square);
+  targets.push_back(Rect2d(square.x - 10, square.y - 10, square.width + 20, square.height + 20));
+
+  SingleTrackers trackers(std::vector<TrackerFactory>(targets.size(), createTracker));
+  BatchTargets batchTargets(batch);
+  checkFollowsReference(trackers, batchTargets, targets, tolerance);
+  EXPECT_EQ((int)targets.size(), batch->getNumTargets());
+}
+
+TEST(TrackerBatch, KCFFollowsTrackers)
+{
+  checkBatchFollowsTrackers(TrackerBatch::createKCF(), createKCF);
+}
+
+TEST(TrackerBatch, MOSSEFollowsTrackers)
+{
+  // the shared gray conversion may move the subpixel peak slightly
+  checkBatchFollowsTrackers(TrackerBatch::createMOSSE(), createMOSSE, 1.0);
+}
+
+TEST(TrackerBatch, MedianFlowFollowsTrackers)
+{
+  checkBatchFollowsTrackers(TrackerBatch::createMedianFlow(), createMedianFlow);
+}
+
+/***************************************************************************************/
+//Stage times
+
+// one tracker whose stage and update times are kept after every update
+class TimedTracker : public SingleTrackers
+{
+public:
+  explicit TimedTracker(TrackerFactory create)
+    : SingleTrackers(std::vector<TrackerFactory>(1, create)), initUpdateTime(-1) {}
+
+  bool init(const Mat& frame, const std::vector<Rect2d>& targets) CV_OVERRIDE
+  {
+    if (!SingleTrackers::init(frame, targets))
+      return false;
+    initUpdateTime = trackers[0]->getUpdateTime();
+    return true;
+  }
+
+  void update(const Mat& frame, std::vector<Rect2d>& boxes, std::vector<uchar>& found) CV_OVERRIDE
+  {
+    SingleTrackers::update(frame, boxes, found);
+    std::vector<double> times(Tracker::NUM_STAGES);
+    for (int stage = 0; stage < Tracker::NUM_STAGES; stage++)
+      times[stage] = trackers[0]->getStageTime(stage);
+    stageTimes.push_back(times);
+    updateTimes.push_back(trackers[0]->getUpdateTime());
+  }
+
+  double initUpdateTime;
+  std::vector< std::vector<double> > stageTimes;
+  std::vector<double> updateTimes;
+};
+
+static void checkStageTimes(TrackerFactory create)
+{
+  TimedTracker tracker(create);
+  TrackedSequence sequence;
+  ASSERT_NO_FATAL_FAILURE(playMovingSquare(tracker, std::vector<Rect2d>(1, initialSquare()), sequence));
+  // init is not an update
+  EXPECT_EQ(0.0, tracker.initUpdateTime);
+  ASSERT_EQ((size_t)MOVING_SQUARE_FRAMES - 1, tracker.updateTimes.size());
+
+  for (int frameIdx = 1; frameIdx < MOVING_SQUARE_FRAMES; frameIdx++)
+  {
+    ASSERT_TRUE(sequence.found[frameIdx][0] != 0) << "frame " << frameIdx;
+    const std::vector<double>& stageTimes = tracker.stageTimes[frameIdx - 1];
+    const double updateTime = tracker.updateTimes[frameIdx - 1];
+
+    double stagesTime = 0;
+    for (int stage = 0; stage < Tracker::NUM_STAGES; stage++)
+    {
+      EXPECT_GE(stageTimes[stage], 0.0);
+      stagesTime += stageTimes[stage];
+    }
+    // KCF only learns the target on its first update
+    if (frameIdx > 1)
+      EXPECT_GT(stageTimes[Tracker::STAGE_DETECTION], 0.0) << "frame " << frameIdx;
+    EXPECT_GT(updateTime, 0.0) << "frame " << frameIdx;
+    // the stages are nested in the update, up to the tick resolution
+    EXPECT_LE(stagesTime, updateTime + 1e-3) << "frame " << frameIdx;
+  }
+}
+
+static Ptr<Tracker> createMIL() { return TrackerMIL::create(); }
+
+TEST(Tracker, StageTimesKCF) { checkStageTimes(createKCF); }
+TEST(Tracker, StageTimesMOSSE) { checkStageTimes(createMOSSE); }
+TEST(Tracker, StageTimesCSRT) { checkStageTimes(createCSRT); }
+TEST(Tracker, StageTimesMedianFlow) { checkStageTimes(createMedianFlow); }
+TEST(Tracker, StageTimesMIL) { checkStageTimes(createMIL); }
+
+/***************************************************************************************/
+//TLD
+
+static Ptr<Tracker> createTLD() { return TrackerTLD::create(); }
+
+// the packed ferns are compared with the per fern codes in TLDDetector.FernsPosteriorMatchesPerFernCodes,
+// here the detector they feed has to keep the tracker on the square
+TEST(TLD, FollowsMovingSquare)
+{
+  SingleTrackers tracker(std::vector<TrackerFactory>(1, createTLD));
+  TrackedSequence sequence;
+  ASSERT_NO_FATAL_FAILURE(playMovingSquare(tracker, std::vector<Rect2d>(1, initialSquare()), sequence));
+
+  for (int frameIdx = 1; frameIdx < MOVING_SQUARE_FRAMES; frameIdx++)
+  {
+    const Rect& square = sequence.squares[frameIdx];
+    const Rect2d& box = sequence.boxes[frameIdx][0];
+    ASSERT_TRUE(sequence.found[frameIdx][0] != 0) << "frame " << frameIdx;
+    EXPECT_NEAR(square.x + square.width / 2., box.x + box.width / 2, 5.0) << "frame " << frameIdx;
+    EXPECT_NEAR(square.y + square.height / 2., box.y + box.height / 2, 5.0) << "frame " << frameIdx;
+  }
+}
+
 }} // namespace
 /* End of file. */
@@ -0,0 +1,179 @@
+// This file is part of OpenCV project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at http://opencv.org/license.html.
+
+#include "test_precomp.hpp"
+#include "../src/tracking_utils.hpp"
+#include "../src/trackerCSRTUtils.hpp"
+
+namespace opencv_test { namespace {
+
+// Odd and even widths and heights place the DC and Nyquist terms differently in the CCS layout
+static const Size ccsSizes[] = { Size(6, 4), Size(7, 4), Size(6, 5), Size(7, 5), Size(32, 17), Size(17, 32) };
+
+// Full complex spectrum of a single channel CCS packed spectrum
+static Mat unpackCCS(const Mat& ccs)
+{
+    Mat spatial, spectrum;
+    idft(ccs, spatial, DFT_SCALE | DFT_REAL_OUTPUT);
+    dft(spatial, spectrum, DFT_COMPLEX_OUTPUT);
+    return spectrum;
+}
+
+static void randomSignal(Size size, Mat& signal, Mat& ccs, Mat& spectrum)
+{
+    signal.create(size, CV_32F);
+    randu(signal, -1, 1);
+    dft(signal, ccs);
+    dft(signal, spectrum, DFT_COMPLEX_OUTPUT);
+}
+
+static void expectSpectrumNear(const Mat& expected, const Mat& actual, const Size& size)
+{
+    EXPECT_LE(cvtest::norm(expected, actual, NORM_INF), 1e-4 * cvtest::norm(expected, NORM_INF))
+        << "size " << size;
+}
+
+TEST(TrackingUtils, DivSpectrumsCCS)
+{
+    for (size_t s = 0; s < sizeof(ccsSizes) / sizeof(ccsSizes[0]); s++)
+    {
+        const Size size = ccsSizes[s];
+        Mat a, aCCS, aSpectrum;
+        randomSignal(size, a, aCCS, aSpectrum);
+
+        // a strong DC component keeps every frequency of the divisor away from zero
+        Mat b, bCCS, bSpectrum;
+        b.create(size, CV_32F);
+        randu(b, -1, 1);
+        b.at<float>(0, 0) += 2.f * (float)size.area();
+        dft(b, bCCS);
+        dft(b, bSpectrum, DFT_COMPLEX_OUTPUT);
+
+        Mat expected(size, CV_32FC2);
+        for (int i = 0; i < size.height; i++)
+            for (int j = 0; j < size.width; j++)
+            {
+                const Vec2f& x = aSpectrum.at<Vec2f>(i, j);
+                const Vec2f& y = bSpectrum.at<Vec2f>(i, j);
+                float den = y[0] * y[0] + y[1] * y[1];
+                expected.at<Vec2f>(i, j) = Vec2f((x[0] * y[0] + x[1] * y[1]) / den, (x[1] * y[0] - x[0] * y[1]) / den);
+            }
+
+        Mat quotient;
+        tracking_internal::divSpectrumsCCS(aCCS, bCCS, quotient);
+        ASSERT_EQ(CV_32FC1, quotient.type());
+        ASSERT_EQ(size, quotient.size());
+        expectSpectrumNear(expected, unpackCCS(quotient), size);
+    }
+}
+
+TEST(TrackingUtils, AddRealCCS)
+{
+    const float value = 0.75f;
+    for (size_t s = 0; s < sizeof(ccsSizes) / sizeof(ccsSizes[0]); s++)
+    {
+        const Size size = ccsSizes[s];
+        Mat a, aCCS, aSpectrum;
+        randomSignal(size, a, aCCS, aSpectrum);
+
+        Mat expected = aSpectrum + Scalar(value, 0);
+
+        Mat sum;
+        tracking_internal::addRealCCS(aCCS, value, sum);
+        expectSpectrumNear(expected, unpackCCS(sum), size);
+
+        // in place
+        tracking_internal::addRealCCS(aCCS, value, aCCS);
+        expectSpectrumNear(expected, unpackCCS(aCCS), size);
+    }
+}
+
+// Patch sizes around the vector widths, so the vector loops and their scalar tails both run
+static const Size featureSizes[] = { Size(5, 3), Size(37, 23), Size(64, 48), Size(71, 9) };
+
+static Mat hannWindow(Size size)
+{
+    Mat window;
+    createHanningWindow(window, size, CV_32F);
+    return window;
+}
+
+TEST(TrackingUtils, ColorNamesMatchScalarLookup)
+{
+    Mat cnFeatures, indexBuffer;
+    for (size_t s = 0; s < sizeof(featureSizes) / sizeof(featureSizes[0]); s++)
+    {
+        const Size size = featureSizes[s];
+        Mat patch(size, CV_8UC3);
+        randu(patch, Scalar::all(0), Scalar::all(256));
+        Mat window = hannWindow(size);
+
+        // the scalar table lookup of the ColorNames features, windowed afterwards
+        std::vector<Mat> names = get_features_cn(patch, Size());
+        ASSERT_EQ(10u, names.size());
+        Mat expected, windows;
+        merge(names, expected);
+        merge(std::vector<Mat>(10, window), windows);
+        expected = expected.mul(windows);
+
+        tracking_internal::extractColorNames(patch, window, cnFeatures, indexBuffer);
+        ASSERT_EQ(CV_32FC(10), cnFeatures.type());
+        ASSERT_EQ(size, cnFeatures.size());
+        EXPECT_LE(cvtest::norm(expected, cnFeatures, NORM_INF), 1e-6) << "size " << size;
+    }
+}
+
+TEST(TrackingUtils, GrayFeaturesMatchConvertTo)
+{
+    const int depths[] = { CV_8U, CV_16U, CV_32F };
+    Mat grayFeatures;
+    for (size_t s = 0; s < sizeof(featureSizes) / sizeof(featureSizes[0]); s++)
+    {
+        const Size size = featureSizes[s];
+        Mat window = hannWindow(size);
+        for (size_t d = 0; d < sizeof(depths) / sizeof(depths[0]); d++)
+        {
+            // other depths than 8 bit take the generic conversion, with values in the same range
+            Mat gray(size, depths[d]);
+            randu(gray, 0, 256);
+
+            Mat expected;
+            gray.convertTo(expected, CV_32F, 1.0 / 255.0, -0.5);
+            expected = expected.mul(window);
+
+            tracking_internal::extractGrayFeatures(gray, window, grayFeatures);
+            ASSERT_EQ(CV_32FC1, grayFeatures.type());
+            ASSERT_EQ(size, grayFeatures.size());
+            EXPECT_LE(cvtest::norm(expected, grayFeatures, NORM_INF), 1e-6) << "size " << size << ", depth " << depths[d];
+        }
+    }
+}
+
+TEST(TrackingUtils, HOGFloatMatchesDouble)
+{
+    const int binSize = 4;
+    const Size sizes[] = { Size(37, 23), Size(64, 48), Size(71, 30) };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    {
+        const Size size = sizes[s];
+        // equal channels, so both precisions take the gradient of the same channel
+        Mat gray(size, CV_8U), patch;
+        randu(gray, 0, 256);
+        merge(std::vector<Mat>(3, gray), patch);
+
+        std::vector<Mat> doubleFeatures = get_features_hog(patch, binSize, false);
+        std::vector<Mat> floatFeatures = get_features_hog(patch, binSize, true);
+        ASSERT_EQ(32u, doubleFeatures.size());
+        ASSERT_EQ(32u, floatFeatures.size());
+        for (size_t c = 0; c < floatFeatures.size(); c++)
+        {
+            ASSERT_EQ(CV_32FC1, floatFeatures[c].type());
+            ASSERT_EQ(doubleFeatures[c].size(), floatFeatures[c].size());
+            EXPECT_LE(cvtest::norm(doubleFeatures[c], floatFeatures[c], NORM_INF), 1e-4)
+                << "size " << size << ", channel " << c;
+        }
+    }
+}
+
+}} // namespace